@@ -0,0 +1,134 @@
+// "Copyright 2024 <Oldnick85>"
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+namespace semantic_sdp {
+
+namespace memory {
+
+/**
+ * Public operations allocations are accounted to
+ */
+enum class Operation : uint8_t {
+    Other = 0,
+    Parse,
+    Serialize,
+    Clone,
+    Answer,
+};
+
+/**
+ * Allocation counters of one operation type
+ */
+struct SAllocationStats {
+    uint64_t    allocations{0};
+    uint64_t    bytes{0};
+};
+
+/**
+ * Allocation statistics are only collected when the library is built with SEMANTIC_SDP_ALLOCATION_STATS,
+ * otherwise all the hooks compile to nothing.
+ */
+#ifdef SEMANTIC_SDP_ALLOCATION_STATS
+inline constexpr bool kAllocationStats = true;
+#else
+inline constexpr bool kAllocationStats = false;
+#endif
+
+namespace detail {
+
+inline constexpr std::size_t kOperations = static_cast<std::size_t>(Operation::Answer) + 1;
+
+struct SAllocationCounters {
+    std::atomic<uint64_t>   allocations{0};
+    std::atomic<uint64_t>   bytes{0};
+};
+
+inline std::array<SAllocationCounters, kOperations>& Counters() {
+    static std::array<SAllocationCounters, kOperations> counters;
+    return counters;
+}
+
+inline Operation& CurrentOperation() {
+    static thread_local Operation operation = Operation::Other;
+    return operation;
+}
+
+/**
+ * Account an allocation to the operation running on this thread
+ * @param [in] bytes size of the allocation
+ */
+inline void RecordAllocation(const std::size_t bytes) {
+    if constexpr (kAllocationStats) {
+        auto& counters = Counters()[static_cast<std::size_t>(CurrentOperation())];
+        counters.allocations.fetch_add(1, std::memory_order_relaxed);
+        counters.bytes.fetch_add(bytes, std::memory_order_relaxed);
+    }
+}
+
+}    // namespace detail
+
+/**
+ * Mark the allocations of this thread as made by an operation while the object is alive.
+ * Nested operations are accounted to the outermost one, so a Clone() inside Answer() counts as Answer.
+ */
+class COperation {
+ private:
+    bool    m_outermost{false};
+
+ public:
+    /**
+     * constructor for COperation
+     * @param [in] operation operation type
+     */
+    explicit COperation(const Operation operation) {
+        if constexpr (kAllocationStats) {
+            auto& current = detail::CurrentOperation();
+            m_outermost = (current == Operation::Other);
+            if (m_outermost)
+                current = operation;
+        }
+    }
+
+    ~COperation() {
+        if constexpr (kAllocationStats) {
+            if (m_outermost)
+                detail::CurrentOperation() = Operation::Other;
+        }
+    }
+
+    COperation(const COperation&) = delete;
+    COperation& operator=(const COperation&) = delete;
+};
+
+/**
+ * Get allocation statistics of an operation type since start or the last reset
+ * @param [in] operation operation type
+ * @returns allocation counters
+ */
+inline SAllocationStats GetAllocationStats(const Operation operation) {
+    const auto& counters = detail::Counters()[static_cast<std::size_t>(operation)];
+    SAllocationStats stats;
+    stats.allocations = counters.allocations.load(std::memory_order_relaxed);
+    stats.bytes = counters.bytes.load(std::memory_order_relaxed);
+    return stats;
+}
+
+/**
+ * Reset allocation statistics of all operation types
+ */
+inline void ResetAllocationStats() {
+    for (auto& counters : detail::Counters()) {
+        counters.allocations.store(0, std::memory_order_relaxed);
+        counters.bytes.store(0, std::memory_order_relaxed);
+    }
+}
+
+}    // namespace memory
+
+}    // namespace semantic_sdp
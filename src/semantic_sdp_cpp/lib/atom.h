@@ -0,0 +1,417 @@
+// "Copyright 2024 <Oldnick85>"
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <memory_resource>
+#include <mutex>
+#include <string_view>
+#include <type_traits>
+
+#include "./memory.h"
+#include "./util.h"
+
+namespace semantic_sdp {
+
+namespace atom {
+
+namespace detail {
+
+/**
+ * Text of an atom, shared by all atoms of the same text when interned
+ */
+struct SEntry {
+    std::string_view    text;
+    std::size_t         hash{0};
+    // Interned lower case form, nullptr for entries that are not interned
+    const SEntry*       folded{nullptr};
+    bool                interned{false};
+};
+
+/**
+ * Entry owned by the atoms of a text that is not interned, shared by copies placed in the same memory resource.
+ * The text follows the entry in the same block.
+ */
+struct SOwnedEntry : SEntry, memory::CAllocated {
+    mutable std::atomic<uint32_t>   refs{1};
+
+    /**
+     * Create entry in the memory resource of the current thread
+     * @param [in] str text
+     * @param [in] str_hash hash of the text
+     * @returns entry
+     */
+    static const SOwnedEntry* Create(std::string_view str, const std::size_t str_hash) {
+        void* block = memory::CAllocated::operator new(sizeof(SOwnedEntry) + str.size());
+        auto* entry = ::new (block) SOwnedEntry();
+        auto* chars = reinterpret_cast<char*>(entry + 1);
+        std::memcpy(chars, str.data(), str.size());
+        entry->text = std::string_view(chars, str.size());
+        entry->hash = str_hash;
+        return entry;
+    }
+
+    /**
+     * Destroy entry made by Create
+     * @param [in] entry
+     */
+    static void Destroy(const SOwnedEntry* entry) {
+        const auto size = sizeof(SOwnedEntry) + entry->text.size();
+        entry->~SOwnedEntry();
+        memory::CAllocated::operator delete(const_cast<SOwnedEntry*>(entry), size);
+    }
+};
+
+/**
+ * Texts interned when the table is created: codec names, header extension URIs, RTCP feedback ids and
+ * parameters, group semantics and m-line protocols that are common in WebRTC offers
+ */
+inline constexpr std::string_view kVocabulary[] = {
+    // Codecs
+    "opus", "ISAC", "ILBC", "G722", "PCMU", "PCMA", "CN", "telephone-event", "VP8", "VP9", "H264", "H265", "AV1",
+    "rtx", "red", "ulpfec", "flexfec-03",
+    // Header extensions
+    "urn:ietf:params:rtp-hdrext:sdes:mid",
+    "urn:ietf:params:rtp-hdrext:sdes:rtp-stream-id",
+    "urn:ietf:params:rtp-hdrext:sdes:repaired-rtp-stream-id",
+    "urn:ietf:params:rtp-hdrext:ssrc-audio-level",
+    "urn:ietf:params:rtp-hdrext:csrc-audio-level",
+    "urn:ietf:params:rtp-hdrext:toffset",
+    "urn:3gpp:video-orientation",
+    "http://www.webrtc.org/experiments/rtp-hdrext/abs-send-time",
+    "http://www.webrtc.org/experiments/rtp-hdrext/abs-capture-time",
+    "http://www.webrtc.org/experiments/rtp-hdrext/playout-delay",
+    "http://www.webrtc.org/experiments/rtp-hdrext/video-content-type",
+    "http://www.webrtc.org/experiments/rtp-hdrext/video-timing",
+    "http://www.webrtc.org/experiments/rtp-hdrext/color-space",
+    "http://www.ietf.org/id/draft-holmer-rmcat-transport-wide-cc-extensions-01",
+    "http://www.ietf.org/id/draft-holmer-rmcat-transport-wide-cc-extensions-02",
+    "https://aomediacodec.github.io/av1-rtp-spec/#dependency-descriptor-rtp-header-extension",
+    // RTCP feedback
+    "nack", "pli", "sli", "rpsi", "ccm", "fir", "tmmbr", "tstr", "vbcm", "goog-remb", "transport-cc",
+    // Source group semantics
+    "FID", "FEC", "FEC-FR", "SIM",
+    // m-line protocols
+    "UDP/TLS/RTP/SAVPF", "UDP/TLS/RTP/SAVP", "RTP/SAVPF", "RTP/SAVP", "RTP/AVPF", "RTP/AVP",
+    "UDP/DTLS/SCTP", "TCP/DTLS/SCTP", "DTLS/SCTP",
+};
+
+/**
+ * Global intern table.
+ * Lookups probe an open addressing table of atomic pointers without locking, inserts are serialized
+ * by a mutex and publish the entry with a release store. Entries are never removed, so only the
+ * vocabulary and texts interned explicitly go there, and the table is bounded all the same.
+ */
+class CTable {
+ public:
+    static constexpr std::size_t kCapacity = 2048;
+    static constexpr std::size_t kMaxLength = 256;
+
+ private:
+    static constexpr std::size_t kSlots = kCapacity * 2;
+
+    std::array<std::atomic<const SEntry*>, kSlots>  m_slots{};
+    std::size_t                                     m_count{0};
+    std::mutex                                      m_mutex;
+    std::pmr::monotonic_buffer_resource             m_storage{16 * 1024};
+
+    const SEntry* Insert(std::string_view text, const std::size_t hash, const SEntry* folded) {
+        auto* chars = static_cast<char*>(m_storage.allocate(text.size(), 1));
+        std::memcpy(chars, text.data(), text.size());
+        auto* entry = static_cast<SEntry*>(m_storage.allocate(sizeof(SEntry), alignof(SEntry)));
+        new (entry) SEntry{std::string_view(chars, text.size()), hash, folded, true};
+        if (folded == nullptr)
+            entry->folded = entry;
+        for (std::size_t i = hash;; ++i) {
+            auto& slot = m_slots[i & (kSlots - 1)];
+            if (slot.load(std::memory_order_relaxed) == nullptr) {
+                slot.store(entry, std::memory_order_release);
+                break;
+            }
+        }
+        ++m_count;
+        return entry;
+    }
+
+ public:
+    CTable() {
+        for (const auto text : kVocabulary)
+            Intern(text, std::hash<std::string_view>{}(text));
+    }
+
+    /**
+     * Find interned text
+     * @param [in] text
+     * @param [in] hash hash of text
+     * @returns entry or nullptr if the text is not interned
+     */
+    const SEntry* Find(std::string_view text, const std::size_t hash) const {
+        for (std::size_t i = hash;; ++i) {
+            const auto* entry = m_slots[i & (kSlots - 1)].load(std::memory_order_acquire);
+            if (entry == nullptr)
+                return nullptr;
+            if ((entry->hash == hash) && (entry->text == text))
+                return entry;
+        }
+    }
+
+    /**
+     * Intern text together with its lower case form
+     * @param [in] text
+     * @param [in] hash hash of text
+     * @returns entry or nullptr if the text is too long or the table is full
+     */
+    const SEntry* Intern(std::string_view text, const std::size_t hash) {
+        if (const auto* entry = Find(text, hash))
+            return entry;
+        if (text.size() > kMaxLength)
+            return nullptr;
+        std::array<char, kMaxLength> lower;
+        std::transform(text.begin(), text.end(), lower.begin(), to_lower_ascii);
+        const std::string_view lower_text(lower.data(), text.size());
+        const auto lower_hash = std::hash<std::string_view>{}(lower_text);
+
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (const auto* entry = Find(text, hash))
+            return entry;
+        const auto* folded = Find(lower_text, lower_hash);
+        if (m_count + ((folded == nullptr) ? 2 : 1) > kCapacity)
+            return nullptr;
+        if (lower_text == text)
+            return Insert(text, hash, nullptr);
+        if (folded == nullptr)
+            folded = Insert(lower_text, lower_hash, nullptr);
+        return Insert(text, hash, folded);
+    }
+
+    /**
+     * Get number of interned texts
+     * @returns count
+     */
+    std::size_t size() {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return m_count;
+    }
+};
+
+/**
+ * Get the process wide table, it is never destroyed so atoms in static objects stay valid
+ * @returns table
+ */
+inline CTable& Table() {
+    static auto* table = new CTable();
+    return *table;
+}
+
+}    // namespace detail
+
+}    // namespace atom
+
+/**
+ * Handle of a possibly interned string.
+ * Atoms of an interned text share one table entry, so comparing them compares pointers and
+ * copying them copies a pointer. Constructing an atom only looks the text up: texts that are not
+ * interned (remote text outside of the vocabulary, too long, table full) are kept in an entry owned
+ * by the atom and its copies and compared by content.
+ */
+class Atom {
+ private:
+    // nullptr for the empty string
+    const atom::detail::SEntry*     m_entry{nullptr};
+
+    static const atom::detail::SEntry* Make(std::string_view text) {
+        if (text.empty())
+            return nullptr;
+        const auto hash = std::hash<std::string_view>{}(text);
+        if (const auto* entry = atom::detail::Table().Find(text, hash))
+            return entry;
+        return atom::detail::SOwnedEntry::Create(text, hash);
+    }
+
+    static const atom::detail::SEntry* Copy(const atom::detail::SEntry* entry) {
+        if ((entry == nullptr) || entry->interned)
+            return entry;
+        const auto* owned = static_cast<const atom::detail::SOwnedEntry*>(entry);
+        // Share the entry only within its memory resource, a copy must outlive the resource of the original
+        if (memory::CAllocated::ResourceOf(owned) == memory::detail::Current()) {
+            owned->refs.fetch_add(1, std::memory_order_relaxed);
+            return owned;
+        }
+        return atom::detail::SOwnedEntry::Create(owned->text, owned->hash);
+    }
+
+    void Release() {
+        if ((m_entry != nullptr) && !m_entry->interned) {
+            const auto* owned = static_cast<const atom::detail::SOwnedEntry*>(m_entry);
+            if (owned->refs.fetch_sub(1, std::memory_order_acq_rel) == 1)
+                atom::detail::SOwnedEntry::Destroy(owned);
+        }
+        m_entry = nullptr;
+    }
+
+    explicit Atom(const atom::detail::SEntry* entry)
+    : m_entry(entry)
+    {}
+
+ public:
+    Atom() = default;
+
+    /**
+     * constructor for Atom, uses the interned entry of the text if there is one
+     * @param [in] text anything convertible to std::string_view
+     */
+    template <typename Text>
+    Atom(const Text& text)    // NOLINT(runtime/explicit)
+    requires (std::is_convertible_v<const Text&, std::string_view> && !std::is_same_v<Text, Atom>)
+    : m_entry(Make(text))
+    {}
+
+    Atom(const Atom& other)
+    : m_entry(Copy(other.m_entry))
+    {}
+
+    Atom(Atom&& other) noexcept
+    : m_entry(other.m_entry) {
+        other.m_entry = nullptr;
+    }
+
+    Atom& operator=(const Atom& other) {
+        if (this != &other) {
+            Release();
+            m_entry = Copy(other.m_entry);
+        }
+        return *this;
+    }
+
+    Atom& operator=(Atom&& other) noexcept {
+        if (this != &other) {
+            Release();
+            m_entry = other.m_entry;
+            other.m_entry = nullptr;
+        }
+        return *this;
+    }
+
+    ~Atom() {
+        Release();
+    }
+
+    /**
+     * Intern text, for texts known to the application such as supported codecs and extensions
+     * @param [in] text
+     * @returns atom, owned if the table can not take the text
+     */
+    static Atom Intern(std::string_view text) {
+        if (text.empty())
+            return Atom();
+        const auto hash = std::hash<std::string_view>{}(text);
+        if (const auto* entry = atom::detail::Table().Intern(text, hash))
+            return Atom(entry);
+        return Atom(atom::detail::SOwnedEntry::Create(text, hash));
+    }
+
+    /**
+     * Find atom of an already interned text, without adding the text to the table
+     * @param [in] text
+     * @returns atom, empty if the text is not interned
+     */
+    static Atom Find(std::string_view text) {
+        if (text.empty())
+            return Atom();
+        return Atom(atom::detail::Table().Find(text, std::hash<std::string_view>{}(text)));
+    }
+
+    /**
+     * Get text
+     * @returns text
+     */
+    std::string_view view() const {
+        return (m_entry != nullptr) ? m_entry->text : std::string_view();
+    }
+
+    operator std::string_view() const {    // NOLINT(runtime/explicit)
+        return view();
+    }
+
+    bool empty() const {
+        return m_entry == nullptr;
+    }
+
+    std::size_t size() const {
+        return view().size();
+    }
+
+    /**
+     * Check if the text is held by the intern table
+     * @returns boolean
+     */
+    bool IsInterned() const {
+        return (m_entry == nullptr) || m_entry->interned;
+    }
+
+    /**
+     * Get atom of the lower case text
+     * @returns atom
+     */
+    Atom Folded() const {
+        if ((m_entry == nullptr) || m_entry->interned)
+            return Atom((m_entry != nullptr) ? m_entry->folded : nullptr);
+        const auto text = view();
+        if (std::none_of(text.begin(), text.end(), [](const char c) { return to_lower_ascii(c) != c; }))
+            return *this;
+        memory::String lower(text);
+        std::transform(lower.begin(), lower.end(), lower.begin(), to_lower_ascii);
+        return Atom(lower);
+    }
+
+    /**
+     * Compare ignoring ASCII case
+     * @param [in] other
+     * @returns boolean
+     */
+    bool IEquals(const Atom& other) const {
+        if (IsInterned() && other.IsInterned())
+            return ((m_entry != nullptr) ? m_entry->folded : nullptr) ==
+                   ((other.m_entry != nullptr) ? other.m_entry->folded : nullptr);
+        return iequals(view(), other.view());
+    }
+
+    /**
+     * Get hash of the text
+     * @returns hash
+     */
+    std::size_t Hash() const {
+        return (m_entry != nullptr) ? m_entry->hash : std::hash<std::string_view>{}(std::string_view());
+    }
+
+    bool operator==(const Atom& other) const {
+        if (m_entry == other.m_entry)
+            return true;
+        if ((m_entry == nullptr) || (other.m_entry == nullptr) || (m_entry->interned && other.m_entry->interned))
+            return false;
+        return (m_entry->hash == other.m_entry->hash) && (m_entry->text == other.m_entry->text);
+    }
+
+    bool operator==(std::string_view text) const {
+        return view() == text;
+    }
+
+    bool operator==(const char* text) const {
+        return view() == text;
+    }
+};
+
+}    // namespace semantic_sdp
+
+template <>
+struct std::hash<semantic_sdp::Atom> {
+    std::size_t operator()(const semantic_sdp::Atom& atom) const noexcept {
+        return atom.Hash();
+    }
+};
@@ -2,52 +2,239 @@
 
 #pragma once
 
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
 #include <string>
+#include <string_view>
 #include <optional>
 #include <memory>
 
+#include "./util.h"
+#include "./memory.h"
+#include "./ip_address.h"
+
 namespace semantic_sdp {
 
+/**
+ * Enum for ICE candidate transport values.
+ */
+enum class CandidateTransport : uint8_t {
+    Unknown,
+    UDP,
+    TCP,
+};
+
+namespace candidate_transport {
+
+/**
+ * Get candidate transport by name
+ * @param [in] transport name (case insensitive)
+ * @returns transport
+ */
+constexpr CandidateTransport ByValue(std::string_view transport) {
+    if (iequals(transport, "udp"))
+        return CandidateTransport::UDP;
+    if (iequals(transport, "tcp"))
+        return CandidateTransport::TCP;
+    return CandidateTransport::Unknown;
+}
+
+/**
+ * Get candidate transport name
+ * @param [in] transport
+ * @returns string
+ */
+constexpr std::string_view ToString(CandidateTransport transport) {
+    switch (transport) {
+        case CandidateTransport::UDP:
+            return "udp";
+        case CandidateTransport::TCP:
+            return "tcp";
+        default:
+            return "";
+    }
+    return "";
+}
+
+}    // namespace candidate_transport
+
+/**
+ * Enum for ICE candidate type values.
+ */
+enum class CandidateType : uint8_t {
+    Unknown,
+    Host,
+    Srflx,
+    Prflx,
+    Relay,
+};
+
+namespace candidate_type {
+
+/**
+ * Get candidate type by name
+ * @param [in] type name (case insensitive)
+ * @returns candidate type
+ */
+constexpr CandidateType ByValue(std::string_view type) {
+    if (iequals(type, "host"))
+        return CandidateType::Host;
+    if (iequals(type, "srflx"))
+        return CandidateType::Srflx;
+    if (iequals(type, "prflx"))
+        return CandidateType::Prflx;
+    if (iequals(type, "relay"))
+        return CandidateType::Relay;
+    return CandidateType::Unknown;
+}
+
+/**
+ * Get candidate type name
+ * @param [in] type
+ * @returns string
+ */
+constexpr std::string_view ToString(CandidateType type) {
+    switch (type) {
+        case CandidateType::Host:
+            return "host";
+        case CandidateType::Srflx:
+            return "srflx";
+        case CandidateType::Prflx:
+            return "prflx";
+        case CandidateType::Relay:
+            return "relay";
+        default:
+            return "";
+    }
+    return "";
+}
+
+}    // namespace candidate_type
+
+namespace candidate_priority {
+
+/**
+ * Get recommended type preference (RFC 8445 5.1.2.2)
+ * @param [in] type candidate type
+ * @returns type preference 0..126
+ */
+constexpr uint32_t TypePreference(CandidateType type) {
+    switch (type) {
+        case CandidateType::Host:
+            return 126;
+        case CandidateType::Prflx:
+            return 110;
+        case CandidateType::Srflx:
+            return 100;
+        default:
+            return 0;
+    }
+    return 0;
+}
+
+/**
+ * Compute candidate priority (RFC 8445 5.1.2.1)
+ * priority = 2^24 * type preference + 2^8 * local preference + (256 - component id)
+ * @param [in] type_preference 0..126
+ * @param [in] local_preference 0..65535, for a host with one interface and one address family 65535
+ * @param [in] component_id 1..256
+ * @returns priority
+ */
+constexpr uint32_t Compute(const uint32_t type_preference, const uint16_t local_preference,
+                           const uint16_t component_id) {
+    return ((type_preference & 0x7F) << 24) | (static_cast<uint32_t>(local_preference) << 8)
+           | ((256 - std::clamp<uint32_t>(component_id, 1, 256)) & 0xFF);
+}
+
+/**
+ * Compute candidate priority with the recommended type preference
+ * @param [in] type candidate type
+ * @param [in] local_preference 0..65535
+ * @param [in] component_id 1..256
+ * @returns priority
+ */
+constexpr uint32_t Compute(CandidateType type, const uint16_t local_preference = 65535,
+                           const uint16_t component_id = 1) {
+    return Compute(TypePreference(type), local_preference, component_id);
+}
+
+}    // namespace candidate_priority
+
 class CCandidateInfo;
 using CandidateInfo = std::unique_ptr<CCandidateInfo>;
 
-class CCandidateInfo {
+class CCandidateInfo : public memory::CAllocated {
  private:
-    std::string                 m_foundation;
-    int                         m_component_id;
-    std::string                 m_transport;
-    int                         m_priority;
-    std::string                 m_address;
-    int                         m_port;
-    std::string                 m_type;
-    std::optional<std::string>  m_rel_addr;
-    std::optional<int>          m_rel_port;
+    memory::String                  m_foundation;
+    uint32_t                        m_priority;
+    uint16_t                        m_component_id;
+    uint16_t                        m_port;
+    std::optional<uint16_t>         m_rel_port;
+    CandidateTransport              m_transport;
+    CandidateType                   m_type;
+    IPAddress                       m_address;
+    IPAddress                       m_rel_addr;     // family None when absent
+    std::size_t                     m_hash;
+
+    std::size_t KeyHash() const {
+        std::size_t seed = std::hash<std::string_view>{}(m_foundation);
+        // Pack the scalar fields in 64 bits, size_t may be only 32 bits wide
+        const uint64_t scalars = (static_cast<uint64_t>(m_component_id) << 32) | (static_cast<uint64_t>(m_port) << 16) |
+                                 (static_cast<uint64_t>(m_transport) << 8) | static_cast<uint64_t>(m_type);
+        seed = hash_combine(seed, std::hash<uint64_t>{}(scalars));
+        return hash_combine(seed, m_address.Hash());
+    }
 
  public:
     /**
      * CanditateInfo constructor
      * @param [in] foundation
-     * @param [in] componentId
+     * @param [in] component_id
      * @param [in] transport
      * @param [in] priority
      * @param [in] address
      * @param [in] port
      * @param [in] type
-     * @param [in] rel_addr
+     * @param [in] rel_addr related address, empty if none
      * @param [in] rel_port
      */
-    CCandidateInfo(const std::string& foundation, const int component_id, const std::string& transport,
-                    const int priority, const std::string& address, const int port, const std::string& type,
-                    const std::optional<std::string>& rel_addr, const std::optional<int> rel_port)
+    CCandidateInfo(std::string_view foundation, const uint16_t component_id, const CandidateTransport transport,
+                   const uint32_t priority, IPAddress address, const uint16_t port, const CandidateType type,
+                   IPAddress rel_addr, const std::optional<uint16_t> rel_port)
         : m_foundation(foundation)
-        , m_component_id(component_id)
-        , m_transport(transport)
         , m_priority(priority)
-        , m_address(address)
+        , m_component_id(component_id)
         , m_port(port)
-        , m_type(type)
-        , m_rel_addr(rel_addr)
         , m_rel_port(rel_port)
+        , m_transport(transport)
+        , m_type(type)
+        , m_address(std::move(address))
+        , m_rel_addr(std::move(rel_addr))
+        , m_hash(KeyHash())
+    {}
+
+    /**
+     * CanditateInfo constructor from text values
+     * @param [in] foundation
+     * @param [in] component_id
+     * @param [in] transport
+     * @param [in] priority
+     * @param [in] address
+     * @param [in] port
+     * @param [in] type
+     * @param [in] rel_addr
+     * @param [in] rel_port
+     */
+    CCandidateInfo(std::string_view foundation, const int component_id, std::string_view transport,
+                    const uint32_t priority, std::string_view address, const int port, std::string_view type,
+                    const std::optional<std::string_view>& rel_addr, const std::optional<int> rel_port)
+        : CCandidateInfo(foundation, static_cast<uint16_t>(component_id), candidate_transport::ByValue(transport),
+                         priority, IPAddress::Parse(address), static_cast<uint16_t>(port),
+                         candidate_type::ByValue(type),
+                         rel_addr ? IPAddress::Parse(*rel_addr) : IPAddress(),
+                         rel_port ? std::optional<uint16_t>(static_cast<uint16_t>(*rel_port)) : std::nullopt)
     {}
 
     /**
@@ -57,13 +244,8 @@ class CCandidateInfo {
      */
     bool Equals(const CCandidateInfo& candidate) const {
         return (
-            (candidate.m_foundation     == m_foundation)        &&
-            (candidate.m_component_id == m_component_id)        &&
-            (candidate.m_transport     == m_transport)          &&
+            SameKey(candidate)                                  &&
             (candidate.m_priority     == m_priority)            &&
-            (candidate.m_address     == m_address)              &&
-            (candidate.m_port         == m_port)                &&
-            (candidate.m_type         == m_type)                &&
             (candidate.m_rel_addr     == m_rel_addr)            &&
             (candidate.m_rel_port     == m_rel_port));
     }
@@ -74,16 +256,32 @@ class CCandidateInfo {
      * @returns boolean
      */
     bool Equals(const CandidateInfo& candidate) const {
+        return Equals(*candidate);
+    }
+
+    /**
+     * Check if the ice candidate is the same transport address as us: foundation, component, transport,
+     * address, port and type match. Priority and related address may differ between gatherings.
+     * @param [in] candidate ICE candidate to check against
+     * @returns boolean
+     */
+    bool SameKey(const CCandidateInfo& candidate) const {
         return (
-            (candidate->m_foundation == m_foundation)           &&
-            (candidate->m_component_id == m_component_id)       &&
-            (candidate->m_transport     == m_transport)         &&
-            (candidate->m_priority     == m_priority)           &&
-            (candidate->m_address     == m_address)             &&
-            (candidate->m_port         == m_port)               &&
-            (candidate->m_type         == m_type)               &&
-            (candidate->m_rel_addr     == m_rel_addr)           &&
-            (candidate->m_rel_port     == m_rel_port));
+            (candidate.m_hash           == m_hash)              &&
+            (candidate.m_port           == m_port)              &&
+            (candidate.m_component_id   == m_component_id)      &&
+            (candidate.m_transport      == m_transport)         &&
+            (candidate.m_type           == m_type)              &&
+            (candidate.m_address        == m_address)           &&
+            (candidate.m_foundation     == m_foundation));
+    }
+
+    /**
+     * Get hash of the candidate key, computed once on construction
+     * @returns hash
+     */
+    auto GetHash() const {
+        return m_hash;
     }
 
     /**
@@ -91,6 +289,7 @@ class CCandidateInfo {
      * @returns candidate info
      */
     CandidateInfo Clone() const {
+        memory::COperation operation(memory::Operation::Clone);
         auto c = std::make_unique<CCandidateInfo>(
             m_foundation,
             m_component_id,
@@ -124,10 +323,18 @@ class CCandidateInfo {
      * Get the candidate transport type
      * @returns transport type
      */
-    const auto& GetTransport() const {
+    auto GetTransportType() const {
         return m_transport;
     }
 
+    /**
+     * Get the candidate transport name
+     * @returns transport name
+     */
+    auto GetTransport() const {
+        return candidate_transport::ToString(m_transport);
+    }
+
     /**
      * Get the candidate priority
      * @returns priority
@@ -137,13 +344,21 @@ class CCandidateInfo {
     }
 
     /**
-     * Get the candidate IP address
-     * @returns IP address
+     * Get the candidate address
+     * @returns address
      */
-    const auto& GetAddress() const {
+    const auto& GetIPAddress() const {
         return m_address;
     }
 
+    /**
+     * Get the candidate address text
+     * @returns IP address or host name
+     */
+    std::string GetAddress() const {
+        return m_address.ToString();
+    }
+
     /**
      * Get the candidate IP port
      * @returns IP port
@@ -156,16 +371,34 @@ class CCandidateInfo {
      * Get the candidate type
      * @returns type
      */
-    const auto& GetType() const {
+    auto GetCandidateType() const {
         return m_type;
     }
 
     /**
-     * Get the candidate related IP address for relfexive candidates
-     * @returns related IP address
+     * Get the candidate type name
+     * @returns type name
      */
-    const auto& GetRelAddr() const {
-        return m_rel_addr;
+    auto GetType() const {
+        return candidate_type::ToString(m_type);
+    }
+
+    /**
+     * Get the candidate related address for relfexive candidates
+     * @returns related address or nullptr
+     */
+    const IPAddress* GetRelIPAddress() const {
+        return (m_rel_addr.GetFamily() != IPAddress::Family::None) ? &m_rel_addr : nullptr;
+    }
+
+    /**
+     * Get the candidate related address text for relfexive candidates
+     * @returns related IP address or host name
+     */
+    std::optional<std::string> GetRelAddr() const {
+        if (m_rel_addr.GetFamily() == IPAddress::Family::None)
+            return std::nullopt;
+        return m_rel_addr.ToString();
     }
 
     /**
@@ -177,4 +410,174 @@ class CCandidateInfo {
     }
 };
 
+using CandidatesList = memory::Vector<CandidateInfo>;
+
+/**
+ * Candidates in insertion order without duplicates.
+ * Candidates with the same key (see CCandidateInfo::SameKey) are duplicates. They are found by
+ * comparing the precomputed hashes of a few candidates, and once the set grows through a flat open
+ * addressing table over the same hashes, which allocates only when it doubles.
+ * A flat array of the candidates ordered by priority is kept alongside, so the best candidates
+ * are read without sorting.
+ */
+class CCandidatesSet {
+ public:
+    /**
+     * Entry of the priority order, the key fields are copied to keep scans within the array
+     */
+    struct SRanked {
+        uint32_t                priority;
+        uint16_t                component_id;
+        const CCandidateInfo*   candidate;
+    };
+
+ private:
+    // Up to this size a scan over the stored hashes beats the index and needs no allocations
+    static constexpr std::size_t kIndexThreshold = 8;
+
+    CandidatesList              m_candidates;
+    // Position + 1 in m_candidates by key hash, open addressing over a power of two table at most half full,
+    // empty while the set is small enough to scan
+    memory::Vector<uint32_t>    m_index;
+    memory::Vector<SRanked>     m_ranked;
+
+    void Rank(const CCandidateInfo& candidate) {
+        const auto priority = candidate.GetPriority();
+        const SRanked ranked{priority, candidate.GetComponentId(), &candidate};
+        // Candidates are usually gathered from the highest priority down
+        if (m_ranked.empty() || (m_ranked.back().priority >= priority)) {
+            m_ranked.push_back(ranked);
+            return;
+        }
+        const auto pos = std::upper_bound(m_ranked.begin(), m_ranked.end(), priority,
+                                          [](const uint32_t p, const SRanked& r) { return p > r.priority; });
+        m_ranked.insert(pos, ranked);
+    }
+
+    std::size_t FindSlot(const CCandidateInfo& candidate) const {
+        const auto mask = m_index.size() - 1;
+        // Ports and component ids sit in the middle bits of the key hash, mix them into the low ones
+        const auto mixed = static_cast<uint64_t>(candidate.GetHash()) * 0x9E3779B97F4A7C15ULL;
+        const auto hash = static_cast<std::size_t>(mixed >> 32);
+        for (auto i = hash & mask;; i = (i + 1) & mask) {
+            const auto position = m_index[i];
+            if ((position == 0) || m_candidates[position - 1]->SameKey(candidate))
+                return i;
+        }
+    }
+
+    void Reindex(const std::size_t capacity) {
+        m_index.assign(capacity, 0);
+        for (std::size_t i = 0; i < m_candidates.size(); ++i)
+            m_index[FindSlot(*m_candidates[i])] = static_cast<uint32_t>(i + 1);
+    }
+
+    bool Find(const CCandidateInfo& candidate) const {
+        if (m_index.empty()) {
+            for (const auto& known : m_candidates) {
+                if (known->SameKey(candidate))
+                    return true;
+            }
+            return false;
+        }
+        return m_index[FindSlot(candidate)] != 0;
+    }
+
+ public:
+    /**
+     * Add candidate unless a candidate with the same key is already present
+     * @param [in] candidate
+     * @returns false if the candidate is a duplicate and was dropped
+     */
+    bool Insert(CandidateInfo&& candidate) {
+        if ((candidate == nullptr) || Find(*candidate))
+            return false;
+        m_candidates.push_back(std::move(candidate));
+        // Grow the priority order along with the candidates
+        m_ranked.reserve(m_candidates.capacity());
+        Rank(*m_candidates.back());
+        if (m_candidates.size() <= kIndexThreshold)
+            return true;
+        if (m_candidates.size() * 2 > m_index.size())
+            Reindex(std::max(kIndexThreshold * 4, m_index.size() * 2));
+        else
+            m_index[FindSlot(*m_candidates.back())] = static_cast<uint32_t>(m_candidates.size());
+        return true;
+    }
+
+    /**
+     * Check if a candidate with the same key is present
+     * @param [in] candidate
+     * @returns boolean
+     */
+    bool Contains(const CCandidateInfo& candidate) const {
+        return Find(candidate);
+    }
+
+    /**
+     * Get candidates by priority, highest first, equal priorities in insertion order
+     * @returns ranked candidates
+     */
+    const auto& GetByPriority() const {
+        return m_ranked;
+    }
+
+    /**
+     * Get the highest priority candidate of a component
+     * @param [in] component_id component
+     * @returns candidate or nullptr
+     */
+    const CCandidateInfo* GetBest(const uint16_t component_id = 1) const {
+        for (const auto& ranked : m_ranked) {
+            if (ranked.component_id == component_id)
+                return ranked.candidate;
+        }
+        return nullptr;
+    }
+
+    /**
+     * Remove all candidates
+     */
+    void Clear() {
+        m_ranked.clear();
+        m_index.clear();
+        m_candidates.clear();
+    }
+
+    auto size() const {
+        return m_candidates.size();
+    }
+
+    auto empty() const {
+        return m_candidates.empty();
+    }
+
+    auto begin() const {
+        return m_candidates.begin();
+    }
+
+    auto end() const {
+        return m_candidates.end();
+    }
+
+    const auto& front() const {
+        return m_candidates.front();
+    }
+
+    const auto& back() const {
+        return m_candidates.back();
+    }
+
+    const auto& operator[](const std::size_t index) const {
+        return m_candidates[index];
+    }
+};
+
 }    // namespace semantic_sdp
+
+template <>
+struct std::hash<semantic_sdp::CCandidateInfo> {
+    std::size_t operator()(const semantic_sdp::CCandidateInfo& candidate) const noexcept {
+        return candidate.GetHash();
+    }
+};
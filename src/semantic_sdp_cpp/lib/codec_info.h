@@ -2,31 +2,38 @@
 
 #pragma once
 
+#include <array>
+#include <cstdint>
 #include <string>
-#include <unordered_map>
-#include <unordered_set>
+#include <string_view>
 #include <memory>
+#include <optional>
 #include <utility>
 #include <vector>
 
+#include "./atom.h"
 #include "./util.h"
+#include "./memory.h"
 #include "./rtcp_feedback_info.h"
+#include "./format_params.h"
 
 namespace semantic_sdp {
 
 class CCodecInfo;
 using CodecInfo = std::unique_ptr<CCodecInfo>;
 
-class CCodecInfo {
+class CCodecInfo : public memory::CAllocated {
  public:
-    using RTCPFBs = std::unordered_set<RTCPFeedbackInfo>;
+    using RTCPFBs = CRTCPFeedbackSet;
 
  private:
-    std::string         m_codec;
+    Atom                m_codec;
     int                 m_type;
+    std::optional<int>  m_rate;
     std::optional<int>  m_rtx;
     std::optional<int>  m_channels;
     ParamsMap           m_params;
+    FormatParams        m_format;
     RTCPFBs             m_rtcpfbs;
 
  public:
@@ -36,8 +43,8 @@ class CCodecInfo {
      * @param [in] type the payload type number
      * @param [in] params Format params for codec
      */
-    CCodecInfo(const std::string& codec, const int type, const ParamsMap& params = {})
-        : m_codec(codec)
+    CCodecInfo(Atom codec, const int type, const ParamsMap& params = {})
+        : m_codec(std::move(codec))
         , m_type(type) {
         AddParams(params);
     }
@@ -47,10 +54,12 @@ class CCodecInfo {
      * @returns codec info
      */
     CodecInfo Clone() const {
-        auto cloned = std::make_unique<CCodecInfo>(m_codec, m_type, m_params);
+        memory::COperation operation(memory::Operation::Clone);
+        auto cloned = std::make_unique<CCodecInfo>(m_codec, m_type);
+        cloned->AddParams(*this);
         cloned->SetRTX(GetRTX());
-        for (const auto& rtcfb : m_rtcpfbs)
-            cloned->AddRTCPFeedback(rtcfb->Clone());
+        cloned->SetRate(GetRate());
+        cloned->m_rtcpfbs = m_rtcpfbs;
         if (HasChannels())
             cloned->SetChannels(GetChannels());
         return cloned;
@@ -95,13 +104,36 @@ class CCodecInfo {
         return m_params;
     }
 
+    /**
+     * Get well known format parameters, parsed when they were added
+     * @returns typed parameters
+     */
+    const auto& GetFormatParams() const {
+        return m_format;
+    }
+
     /**
      * Add codec info params
      * @param params
      */
     void AddParams(const ParamsMap& params) {
         for (const auto& it : params)
-            m_params[it.first] = it.second;
+            AddParam(it.first, it.second);
+    }
+
+    /**
+     * Add format params of another codec, reusing its parsed well known params
+     * @param [in] codec
+     */
+    void AddParams(const CCodecInfo& codec) {
+        for (const auto& it : codec.m_params) {
+            const auto found = m_params.find(std::string_view(it.first));
+            if (found != m_params.end())
+                found->second = it.second;
+            else
+                m_params.emplace(it.first, it.second);
+        }
+        m_format.Merge(codec.m_format);
     }
 
     /**
@@ -109,8 +141,13 @@ class CCodecInfo {
      * @param [in] key
      * @param [in] value
      */
-    void AddParam(const std::string& key, const std::string& value) {
-        m_params[key] = value;
+    void AddParam(std::string_view key, std::string_view value) {
+        m_format.Set(key, value);
+        const auto it = m_params.find(key);
+        if (it != m_params.end())
+            it->second = value;
+        else
+            m_params.emplace(key, value);
     }
 
     /**
@@ -118,7 +155,7 @@ class CCodecInfo {
      * @param [in] key
      * @returns boolean
      */
-    bool HasParam(const std::string& key) const {
+    bool HasParam(std::string_view key) const {
         const auto it = m_params.find(key);
         return (it != m_params.end());
     }
@@ -129,7 +166,7 @@ class CCodecInfo {
      * @param [in] default_value default value if param is not found
      * @returns param
      */
-    const std::string& GetParam(const std::string& key, const std::string& default_value = {}) {
+    std::string_view GetParam(std::string_view key, std::string_view default_value = {}) const {
         const auto it = m_params.find(key);
         if (it != m_params.end())
             return it->second;
@@ -152,6 +189,30 @@ class CCodecInfo {
         return m_rtx;
     }
 
+    /**
+     * Check if this codec has a clock rate
+     * @returns boolean
+     */
+    bool HasRate() const {
+        return m_rate.has_value();
+    }
+
+    /**
+     * Get the codec clock rate
+     * @returns clock rate
+     */
+    std::optional<int> GetRate() const {
+        return m_rate;
+    }
+
+    /**
+     * Set the codec clock rate
+     * @param [in] rate
+     */
+    void SetRate(const std::optional<int>& rate) {
+        m_rate = rate;
+    }
+
     /**
      * Check if this codec has number of channels
      * @returns boolean
@@ -179,9 +240,19 @@ class CCodecInfo {
     /**
      * Add an RTCP feedback parameter to this codec type
      * @param [in] rtcpfb RTCP feedback info object
+     * @returns false if the codec already has this feedback
+     */
+    bool AddRTCPFeedback(const CRTCPFeedbackInfo& rtcpfb) {
+        return m_rtcpfbs.Insert(rtcpfb);
+    }
+
+    /**
+     * Add an RTCP feedback parameter to this codec type
+     * @param [in] rtcpfb RTCP feedback info object
+     * @returns false if the codec already has this feedback
      */
-    void AddRTCPFeedback(RTCPFeedbackInfo&& rtcpfb) {
-        m_rtcpfbs.insert(std::move(rtcpfb));
+    bool AddRTCPFeedback(const RTCPFeedbackInfo& rtcpfb) {
+        return (rtcpfb != nullptr) && AddRTCPFeedback(*rtcpfb);
     }
 
     /**
@@ -193,36 +264,170 @@ class CCodecInfo {
     }
 };
 
-using CodecsMap = std::unordered_map<int, CodecInfo>;
+/**
+ * Codecs keyed by RTP payload type (0..127).
+ * Codecs are kept contiguously in insertion order and found through a table indexed by payload type,
+ * so lookups do not hash and iteration order is the order the codecs were added in.
+ */
+class CCodecsMap {
+ public:
+    using value_type = std::pair<const int, CodecInfo>;
+    using iterator = memory::Vector<value_type>::iterator;
+    using const_iterator = memory::Vector<value_type>::const_iterator;
+
+    static constexpr int kMaxPayloadType = 127;
+
+ private:
+    // Position of the codec plus one per payload type, zero if absent
+    std::array<uint8_t, kMaxPayloadType + 1>    m_index{};
+    memory::Vector<value_type>                  m_codecs;
+
+    static bool IsValid(const int type) {
+        return (type >= 0) && (type <= kMaxPayloadType);
+    }
+
+ public:
+    CCodecsMap() = default;
+    CCodecsMap(CCodecsMap&&) noexcept = default;
+
+    /**
+     * Move assignment, keeps the resource of this map, codecs of a map in another resource are moved one by one
+     * @param [in] other
+     * @returns this
+     */
+    CCodecsMap& operator=(CCodecsMap&& other) noexcept {
+        if (this == &other)
+            return *this;
+        m_index = other.m_index;
+        m_codecs.clear();
+        if (m_codecs.get_allocator() == other.m_codecs.get_allocator()) {
+            m_codecs.swap(other.m_codecs);
+        } else {
+            m_codecs.reserve(other.m_codecs.size());
+            for (auto& codec_it : other.m_codecs)
+                m_codecs.emplace_back(codec_it.first, std::move(codec_it.second));
+        }
+        other.clear();
+        return *this;
+    }
+
+    /**
+     * Add codec unless the payload type is taken
+     * @param [in] type payload type
+     * @param [in] codec codec info
+     * @returns false if the payload type is taken or out of range
+     */
+    bool emplace(const int type, CodecInfo&& codec) {
+        if (!IsValid(type) || (m_index[type] != 0))
+            return false;
+        m_codecs.emplace_back(type, std::move(codec));
+        m_index[type] = static_cast<uint8_t>(m_codecs.size());
+        return true;
+    }
+
+    /**
+     * Add codec or replace the one with the same payload type, keeping its position
+     * @param [in] type payload type
+     * @param [in] codec codec info
+     * @returns false if the payload type is out of range
+     */
+    bool insert_or_assign(const int type, CodecInfo&& codec) {
+        if (!IsValid(type))
+            return false;
+        if (m_index[type] != 0) {
+            m_codecs[m_index[type] - 1].second = std::move(codec);
+            return true;
+        }
+        return emplace(type, std::move(codec));
+    }
+
+    /**
+     * Find codec by payload type
+     * @param [in] type payload type
+     * @returns iterator to the codec or end()
+     */
+    iterator find(const int type) {
+        return (IsValid(type) && (m_index[type] != 0)) ? m_codecs.begin() + (m_index[type] - 1) : m_codecs.end();
+    }
+
+    const_iterator find(const int type) const {
+        return (IsValid(type) && (m_index[type] != 0)) ? m_codecs.begin() + (m_index[type] - 1) : m_codecs.end();
+    }
+
+    /**
+     * Check if a codec has payload type
+     * @param [in] type payload type
+     * @returns boolean
+     */
+    bool contains(const int type) const {
+        return IsValid(type) && (m_index[type] != 0);
+    }
+
+    /**
+     * Create a deep copy of the codecs
+     * @returns codecs
+     */
+    CCodecsMap Clone() const {
+        CCodecsMap cloned;
+        cloned.m_index = m_index;
+        cloned.m_codecs.reserve(m_codecs.size());
+        for (const auto& codec_it : m_codecs)
+            cloned.m_codecs.emplace_back(codec_it.first, codec_it.second->Clone());
+        return cloned;
+    }
+
+    void clear() {
+        m_codecs.clear();
+        m_index.fill(0);
+    }
+
+    std::size_t size() const { return m_codecs.size(); }
+    bool empty() const { return m_codecs.empty(); }
+    iterator begin() { return m_codecs.begin(); }
+    iterator end() { return m_codecs.end(); }
+    const_iterator begin() const { return m_codecs.begin(); }
+    const_iterator end() const { return m_codecs.end(); }
+};
+
+using CodecsMap = CCodecsMap;
 
 /**
  * Create a map of CodecInfo from codec names.
- * Payload type is assigned dinamically
+ * Payload type is assigned dinamically, up to 127. Codecs whose payload type (and rtx payload type)
+ * do not fit in the dynamic range any more are left out of the map.
  * @param [in] names
  * @param [in] rtx Should we add rtx?
  * @param [in] rtcpfbs RTCP feedback params
  * @returns map of CodecInfo
  */
-CodecsMap MapFromNames(const std::vector<std::string>& names, bool rtx, const std::vector<RTCPFeedbackInfo>& rtcpfbs) {
+inline CodecsMap MapFromNames(const std::vector<std::string>& names, bool rtx,
+                              const std::vector<CRTCPFeedbackInfo>& rtcpfbs) {
     CodecsMap codecs;
     int dyn = 96;    // Base dyn payload
+    constexpr int kMaxDyn = 127;
     for (const auto& element : names) {
         int pt = 0;
         // We can add params to codec names
-        auto params = split(element, ';');
+        std::string_view params = element;
         // Get codec name from first param, and remove if from the param list
-        auto name = params.front();
-        params.pop_front();
+        std::string name(trim_view(next_token(&params, ';')));
         to_lower_case(&name);
-        trim(&name);
+        // Check if we have to add rtx
+        bool with_rtx = rtx && (name != "ulpfec") && (name != "flexfec-03") && (name != "red");
         // Check name
-        if (name == "pcmu")
+        if (name == "pcmu") {
             pt = 0;
-        else if (name == "pcma")
+        } else if (name == "pcma") {
             pt = 8;
-        else
+        } else if (dyn + (with_rtx ? 2 : 1) > kMaxDyn) {
+            // Dynamic range exhausted
+            continue;
+        } else {
             // Dynamic
             pt = ++dyn;
+        }
+        // Static codecs go without rtx when the dynamic range is exhausted
+        with_rtx = with_rtx && (dyn < kMaxDyn);
         // Create new codec
         auto codec = std::make_unique<CCodecInfo>(name, pt);
         // Set default number of channels
@@ -232,20 +437,16 @@ CodecsMap MapFromNames(const std::vector<std::string>& names, bool rtx, const st
         else if (name == "multiopus")
             // 5.1 by default
             codec->SetChannels(6);
-        // Check if we have to add rtx
-        if (rtx && (name != "ulpfec") && (name != "flexfec-03") && (name != "red"))
+        if (with_rtx)
             codec->SetRTX(++dyn);
 
         // Append all the  rtcp feedback info
         for (const auto& rtcpfb : rtcpfbs)
-            codec->AddRTCPFeedback(std::make_unique<CRTCPFeedbackInfo>(rtcpfb->GetId(), rtcpfb->GetParams()));
+            codec->AddRTCPFeedback(rtcpfb);
         // Add params if any more
-        for (const auto& param_element : params) {
-            auto param = split(param_element, '=');
-            const auto key = trim_copy(param.front());
-            param.pop_front();
-            const auto value = trim_copy(param.front());
-            codec->AddParam(key, value);
+        for (auto param : split_view(params, ';')) {
+            const auto key = trim_view(next_token(&param, '='));
+            codec->AddParam(key, trim_view(param));
         }
         codecs.emplace(pt, std::move(codec));
     }
@@ -254,16 +455,17 @@ CodecsMap MapFromNames(const std::vector<std::string>& names, bool rtx, const st
 
 /**
  * Create a map of CodecInfo from codec names.
- * Payload type is assigned dinamically
+ * Payload type is assigned dinamically, up to 127. Codecs whose payload type (and rtx payload type)
+ * do not fit in the dynamic range any more are left out of the map.
  * @param [in] codecs
  * @param [in] rtx Should we add rtx?
  * @param [in] rtcpfbs RTCP feedback params
  * @returns map of CodecInfo
  */
-CodecsMap MapFromNames(const CodecsMap& codecs, bool rtx, const std::vector<RTCPFeedbackInfo>& rtcpfbs) {
+inline CodecsMap MapFromNames(const CodecsMap& codecs, bool rtx, const std::vector<CRTCPFeedbackInfo>& rtcpfbs) {
     std::vector<std::string> names;
     for (const auto& codec_it : codecs) {
-        names.push_back(codec_it.second->GetCodec());
+        names.emplace_back(codec_it.second->GetCodec());
     }
     return MapFromNames(names, rtx, rtcpfbs);
 }
@@ -3,8 +3,11 @@
 #pragma once
 
 #include <string>
+#include <string_view>
 #include <memory>
 
+#include "./memory.h"
+
 namespace semantic_sdp {
 
 class CCryptoInfo;
@@ -13,12 +16,12 @@ using CryptoInfo = std::unique_ptr<CCryptoInfo>;
 /**
  * SDES peer info
  */
-class CCryptoInfo {
+class CCryptoInfo : public memory::CAllocated {
  private:
-    int                m_tag;
-    std::string        m_suite;
-    std::string        m_key_params;
-    std::string        m_session_params;
+    int                 m_tag;
+    memory::String      m_suite;
+    memory::String      m_key_params;
+    memory::String      m_session_params;
 
  public:
     /**
@@ -28,8 +31,8 @@ class CCryptoInfo {
      * @param [in] key_params
      * @param [in] session_params
      */
-    CCryptoInfo(const int tag, const std::string& suite,
-                const std::string& key_params, const std::string& session_params)
+    CCryptoInfo(const int tag, std::string_view suite,
+                std::string_view key_params, std::string_view session_params)
     : m_tag(tag)
     , m_suite(suite)
     , m_key_params(key_params)
@@ -40,7 +43,8 @@ class CCryptoInfo {
      * Create a clone of this SDES info object
      * @returns crypto info
      */
-    CryptoInfo Clone() {
+    CryptoInfo Clone() const {
+        memory::COperation operation(memory::Operation::Clone);
         return std::make_unique<CCryptoInfo>(m_tag, m_suite, m_key_params, m_session_params);
     }
 
@@ -5,6 +5,8 @@
 #include <string>
 #include <memory>
 
+#include "./memory.h"
+
 namespace semantic_sdp {
 
 class CDataChannelInfo;
@@ -13,7 +15,7 @@ using DataChannelInfo = std::unique_ptr<CDataChannelInfo>;
 /**
  * DataChannel info
  */
-class CDataChannelInfo {
+class CDataChannelInfo : public memory::CAllocated {
  private:
     int        m_port;
     int        m_max_message_size;
@@ -34,6 +36,7 @@ class CDataChannelInfo {
      * @returns data channel info
      */
     DataChannelInfo Clone() const {
+        memory::COperation operation(memory::Operation::Clone);
         return std::make_unique<CDataChannelInfo>(m_port, m_max_message_size);
     }
 
@@ -3,8 +3,10 @@
 #pragma once
 
 #include <string>
+#include <string_view>
 
 #include "./util.h"
+#include "./perfect_hash.h"
 
 namespace semantic_sdp {
 /**
@@ -19,23 +21,25 @@ enum class Direction {
 };
 
 namespace direction {
+
+namespace detail {
+
+inline constexpr CPerfectHash<Direction, 4> kNames({{
+    {"sendrecv", Direction::SendRecv},
+    {"sendonly", Direction::SendOnly},
+    {"recvonly", Direction::RecvOnly},
+    {"inactive", Direction::Inactive},
+}});
+
+}    // namespace detail
+
 /**
-{
  * Get Direction by name
  * @param [in] direction
  * @returns direction
  */
-Direction ByValue(const std::string& direction) {
-    const std::string str{to_lower_case_copy(direction)};
-    if (str == "sendrecv")
-        return Direction::SendRecv;
-    if (str == "sendonly")
-        return Direction::SendOnly;
-    if (str == "recvonly")
-        return Direction::RecvOnly;
-    if (str == "inactive")
-        return Direction::Inactive;
-    return Direction::Unknown;
+constexpr Direction ByValue(std::string_view direction) {
+    return detail::kNames.Find(direction).value_or(Direction::Unknown);
 }
 
 /**
@@ -43,7 +47,7 @@ Direction ByValue(const std::string& direction) {
  * @param [in] direction
  * @returns name
  */
-std::string ToString(const Direction& direction) {
+constexpr std::string_view ToString(const Direction& direction) {
     switch (direction) {
         case Direction::SendRecv:
             return "sendrecv";
@@ -64,7 +68,7 @@ std::string ToString(const Direction& direction) {
  * @param [in] direction
  * @returns Reversed direction
  */
-Direction Reverse(const Direction& direction) {
+constexpr Direction Reverse(const Direction& direction) {
     switch (direction) {
         case Direction::SendRecv:
             return Direction::SendRecv;
@@ -3,8 +3,10 @@
 #pragma once
 
 #include <string>
+#include <string_view>
 
 #include "./util.h"
+#include "./perfect_hash.h"
 
 namespace semantic_sdp {
 /**
@@ -17,18 +19,23 @@ enum class DirectionWay {
 };
 
 namespace direction_way {
+
+namespace detail {
+
+inline constexpr CPerfectHash<DirectionWay, 2> kNames({{
+    {"send", DirectionWay::Send},
+    {"recv", DirectionWay::Recv},
+}});
+
+}    // namespace detail
+
 /**
  * Get Direction Way by name
  * @param [in] direction
  * @returns direction way
  */
-DirectionWay ByValue(const std::string& direction) {
-    const std::string str{to_lower_case_copy(direction)};
-    if (str == "send")
-        return DirectionWay::Send;
-    if (str == "recv")
-        return DirectionWay::Recv;
-    return DirectionWay::Unknown;
+constexpr DirectionWay ByValue(std::string_view direction) {
+    return detail::kNames.Find(direction).value_or(DirectionWay::Unknown);
 }
 
 /**
@@ -36,7 +43,7 @@ DirectionWay ByValue(const std::string& direction) {
  * @param [in] direction
  * @returns string
  */
-std::string ToString(DirectionWay direction) {
+constexpr std::string_view ToString(DirectionWay direction) {
     switch (direction) {
         case DirectionWay::Send:
             return "send";
@@ -53,7 +60,7 @@ std::string ToString(DirectionWay direction) {
  * @param [in] direction
  * @returns Reversed direction
  */
-DirectionWay Reverse(DirectionWay direction) {
+constexpr DirectionWay Reverse(DirectionWay direction) {
     switch (direction) {
         case DirectionWay::Send:
             return DirectionWay::Recv;
@@ -2,25 +2,105 @@
 
 #pragma once
 
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
 #include <string>
+#include <string_view>
 #include <memory>
 
 #include "./util.h"
+#include "./memory.h"
 #include "./setup.h"
+#include "./hex.h"
 
 namespace semantic_sdp {
 
+/**
+ * DTLS certificate fingerprint as raw digest bytes
+ */
+class Fingerprint {
+ public:
+    static constexpr std::size_t kMaxSize = 64;    // sha-512
+
+ private:
+    std::array<uint8_t, kMaxSize>   m_bytes{};
+    std::size_t                     m_size{0};
+
+ public:
+    Fingerprint() = default;
+
+    /**
+     * Parse fingerprint text
+     * @param [in] text colon separated hex pairs of either case, e.g. "4A:AD:B9:..."
+     * @returns fingerprint, nothing if the text is malformed or longer than a sha-512 digest
+     */
+    static std::optional<Fingerprint> Parse(std::string_view text) {
+        Fingerprint fingerprint;
+        if (text.empty() || !hex::Decode(text, fingerprint.m_bytes.data(), kMaxSize, &fingerprint.m_size, ':'))
+            return std::nullopt;
+        return fingerprint;
+    }
+
+    /**
+     * Get digest bytes
+     * @returns bytes
+     */
+    const uint8_t* data() const {
+        return m_bytes.data();
+    }
+
+    /**
+     * Get digest size
+     * @returns number of bytes
+     */
+    auto size() const {
+        return m_size;
+    }
+
+    /**
+     * Compare with a digest in constant time
+     * @param [in] digest
+     * @param [in] size digest size
+     * @returns boolean
+     */
+    bool Equals(const uint8_t* digest, const std::size_t size) const {
+        return (size == m_size) && constant_time_equals(m_bytes.data(), digest, size);
+    }
+
+    /**
+     * Compare with another fingerprint in constant time
+     * @param [in] fingerprint
+     * @returns boolean
+     */
+    bool Equals(const Fingerprint& fingerprint) const {
+        return Equals(fingerprint.data(), fingerprint.size());
+    }
+
+    /**
+     * Get fingerprint text
+     * @param [in] letter_case
+     * @returns colon separated hex pairs
+     */
+    std::string ToString(const hex::Case letter_case = hex::Case::Upper) const {
+        std::string text(hex::EncodedSize(m_size, ':'), '\0');
+        hex::Encode(m_bytes.data(), m_size, text.data(), letter_case, ':');
+        return text;
+    }
+};
+
 class CDTLSInfo;
 using DTLSInfo = std::unique_ptr<CDTLSInfo>;
 
 /**
  * DTLS peer info
  */
-class CDTLSInfo {
+class CDTLSInfo : public memory::CAllocated {
  private:
-    Setup             m_setup;
-    std::string     m_hash;
-    std::string     m_fingerprint;
+    Setup               m_setup;
+    memory::String      m_hash;
+    memory::String      m_fingerprint;
 
  public:
     /**
@@ -29,7 +109,7 @@ class CDTLSInfo {
      * @param [in] hash Hash function
      * @param [in] fingerprint Peer fingerprint
      */
-    CDTLSInfo(const Setup& setup, const std::string& hash, const std::string& fingerprint)
+    CDTLSInfo(const Setup& setup, std::string_view hash, std::string_view fingerprint)
     : m_setup(setup)
     , m_hash(hash)
     , m_fingerprint(fingerprint)
@@ -40,6 +120,7 @@ class CDTLSInfo {
      * @returns DTLS info
      */
     DTLSInfo Clone() const {
+        memory::COperation operation(memory::Operation::Clone);
         return std::make_unique<CDTLSInfo>(m_setup, m_hash, m_fingerprint);
     }
 
@@ -51,6 +132,25 @@ class CDTLSInfo {
         return m_fingerprint;
     }
 
+    /**
+     * Get peer fingerprint as digest bytes
+     * @returns fingerprint, nothing if the text is malformed
+     */
+    std::optional<Fingerprint> ParseFingerprint() const {
+        return Fingerprint::Parse(m_fingerprint);
+    }
+
+    /**
+     * Check a certificate digest against the peer fingerprint in constant time
+     * @param [in] digest certificate digest computed with the hash function of GetHash()
+     * @param [in] size digest size
+     * @returns false if the digest differs or the fingerprint is malformed
+     */
+    bool MatchesFingerprint(const uint8_t* digest, const std::size_t size) const {
+        const auto fingerprint = ParseFingerprint();
+        return fingerprint && fingerprint->Equals(digest, size);
+    }
+
     /**
      * Get hash function name
      * @returns name
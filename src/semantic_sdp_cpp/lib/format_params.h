@@ -0,0 +1,231 @@
+// "Copyright 2024 <Oldnick85>"
+
+#pragma once
+
+#include <charconv>
+#include <cstdint>
+#include <optional>
+#include <string_view>
+
+#include "./util.h"
+#include "./perfect_hash.h"
+
+namespace semantic_sdp {
+
+/**
+ * Well known codec format parameters, parsed once from their fmtp text so that
+ * codec negotiation compares integers.
+ * Parameters are unset when absent or malformed, the text stays in the codec params map.
+ */
+struct FormatParams {
+    /**
+     * H.264 profile-level-id (RFC 6184 8.1), three bytes written as six hex digits
+     */
+    struct SProfileLevelId {
+        uint8_t     profile_idc{0};
+        uint8_t     profile_iop{0};
+        uint8_t     level_idc{0};
+
+        constexpr bool operator==(const SProfileLevelId&) const = default;
+    };
+
+    /**
+     * Well known parameter keys
+     */
+    enum class Key : uint8_t {
+        ProfileLevelId,
+        PacketizationMode,
+        LevelAsymmetryAllowed,
+        ProfileId,
+        Profile,
+        LevelIdx,
+        Tier,
+        MinPTime,
+        UseInbandFEC,
+        Stereo,
+        NumStreams,
+        Apt,
+    };
+
+    // H.264
+    std::optional<SProfileLevelId>  profile_level_id;
+    std::optional<uint8_t>          packetization_mode;
+    std::optional<bool>             level_asymmetry_allowed;
+    // VP9
+    std::optional<uint8_t>          profile_id;
+    // AV1
+    std::optional<uint8_t>          profile;
+    std::optional<uint8_t>          level_idx;
+    std::optional<uint8_t>          tier;
+    // Opus
+    std::optional<uint16_t>         minptime;
+    std::optional<bool>             useinbandfec;
+    std::optional<bool>             stereo;
+    // multiopus
+    std::optional<uint8_t>          num_streams;
+    // RTX
+    std::optional<int>              apt;
+    // Bit per Key that was set, also when its value was malformed
+    uint16_t                        keys{0};
+
+    /**
+     * Find well known parameter key
+     * @param [in] key parameter name (case insensitive)
+     * @returns key or nothing if the parameter is not a well known one
+     */
+    static constexpr std::optional<Key> FindKey(std::string_view key);
+
+    /**
+     * Parse H.264 profile-level-id
+     * @param [in] value six hex digits
+     * @returns profile-level-id or nothing if malformed
+     */
+    static constexpr std::optional<SProfileLevelId> ParseProfileLevelId(std::string_view value) {
+        if (value.size() != 6)
+            return std::nullopt;
+        uint8_t bytes[3] = {};
+        for (std::size_t i = 0; i < 6; ++i) {
+            const char c = to_lower_ascii(value[i]);
+            int nibble = -1;
+            if ((c >= '0') && (c <= '9'))
+                nibble = c - '0';
+            else if ((c >= 'a') && (c <= 'f'))
+                nibble = c - 'a' + 10;
+            if (nibble < 0)
+                return std::nullopt;
+            bytes[i / 2] = static_cast<uint8_t>((bytes[i / 2] << 4) | nibble);
+        }
+        return SProfileLevelId{bytes[0], bytes[1], bytes[2]};
+    }
+
+    /**
+     * Set parameter from its text if it is a well known one
+     * @param [in] key parameter name
+     * @param [in] value parameter value
+     * @returns false if the parameter is not a well known one
+     */
+    bool Set(std::string_view key, std::string_view value) {
+        const auto known = FindKey(key);
+        if (!known)
+            return false;
+        keys |= static_cast<uint16_t>(1U << static_cast<unsigned>(*known));
+        switch (*known) {
+            case Key::ProfileLevelId:
+                profile_level_id = ParseProfileLevelId(value);
+                break;
+            case Key::PacketizationMode:
+                packetization_mode = Number<uint8_t>(value);
+                break;
+            case Key::LevelAsymmetryAllowed:
+                level_asymmetry_allowed = Flag(value);
+                break;
+            case Key::ProfileId:
+                profile_id = Number<uint8_t>(value);
+                break;
+            case Key::Profile:
+                profile = Number<uint8_t>(value);
+                break;
+            case Key::LevelIdx:
+                level_idx = Number<uint8_t>(value);
+                break;
+            case Key::Tier:
+                tier = Number<uint8_t>(value);
+                break;
+            case Key::MinPTime:
+                minptime = Number<uint16_t>(value);
+                break;
+            case Key::UseInbandFEC:
+                useinbandfec = Flag(value);
+                break;
+            case Key::Stereo:
+                stereo = Flag(value);
+                break;
+            case Key::NumStreams:
+                num_streams = Number<uint8_t>(value);
+                break;
+            case Key::Apt:
+                apt = Number<int>(value);
+                break;
+        }
+        return true;
+    }
+
+    /**
+     * Take the parameters the other set has, as if their text was set again
+     * @param [in] other
+     */
+    void Merge(const FormatParams& other) {
+        if (other.keys == 0)
+            return;
+        const auto take = [&other](const Key key, auto* field, const auto& other_field) {
+            if ((other.keys & (1U << static_cast<unsigned>(key))) != 0)
+                *field = other_field;
+        };
+        take(Key::ProfileLevelId, &profile_level_id, other.profile_level_id);
+        take(Key::PacketizationMode, &packetization_mode, other.packetization_mode);
+        take(Key::LevelAsymmetryAllowed, &level_asymmetry_allowed, other.level_asymmetry_allowed);
+        take(Key::ProfileId, &profile_id, other.profile_id);
+        take(Key::Profile, &profile, other.profile);
+        take(Key::LevelIdx, &level_idx, other.level_idx);
+        take(Key::Tier, &tier, other.tier);
+        take(Key::MinPTime, &minptime, other.minptime);
+        take(Key::UseInbandFEC, &useinbandfec, other.useinbandfec);
+        take(Key::Stereo, &stereo, other.stereo);
+        take(Key::NumStreams, &num_streams, other.num_streams);
+        take(Key::Apt, &apt, other.apt);
+        keys |= other.keys;
+    }
+
+    bool operator==(const FormatParams&) const = default;
+
+ private:
+    template <typename T>
+    static std::optional<T> Number(std::string_view value) {
+        T number{};
+        const auto* end = value.data() + value.size();
+        const auto result = std::from_chars(value.data(), end, number);
+        if ((result.ec != std::errc()) || (result.ptr != end))
+            return std::nullopt;
+        return number;
+    }
+
+    static std::optional<bool> Flag(std::string_view value) {
+        if (value == "1")
+            return true;
+        if (value == "0")
+            return false;
+        return std::nullopt;
+    }
+};
+
+namespace format_params {
+
+namespace detail {
+
+inline constexpr CPerfectHash<FormatParams::Key, 12> kKeys({{
+    {"profile-level-id",        FormatParams::Key::ProfileLevelId},
+    {"packetization-mode",      FormatParams::Key::PacketizationMode},
+    {"level-asymmetry-allowed", FormatParams::Key::LevelAsymmetryAllowed},
+    {"profile-id",              FormatParams::Key::ProfileId},
+    {"profile",                 FormatParams::Key::Profile},
+    {"level-idx",               FormatParams::Key::LevelIdx},
+    {"tier",                    FormatParams::Key::Tier},
+    {"minptime",                FormatParams::Key::MinPTime},
+    {"useinbandfec",            FormatParams::Key::UseInbandFEC},
+    {"stereo",                  FormatParams::Key::Stereo},
+    {"num_streams",             FormatParams::Key::NumStreams},
+    {"apt",                     FormatParams::Key::Apt},
+}});
+
+}    // namespace detail
+
+}    // namespace format_params
+
+constexpr std::optional<FormatParams::Key> FormatParams::FindKey(std::string_view key) {
+    return format_params::detail::kKeys.Find(key);
+}
+
+static_assert(FormatParams::FindKey("Packetization-Mode") == FormatParams::Key::PacketizationMode);
+static_assert(FormatParams::ParseProfileLevelId("42e01F") == FormatParams::SProfileLevelId{0x42, 0xE0, 0x1F});
+
+}    // namespace semantic_sdp
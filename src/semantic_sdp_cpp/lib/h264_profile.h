@@ -0,0 +1,293 @@
+// "Copyright 2024 <Oldnick85>"
+
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string_view>
+
+#include "./format_params.h"
+#include "./hex.h"
+
+namespace semantic_sdp {
+
+namespace h264 {
+
+/**
+ * H.264 profiles used by WebRTC endpoints
+ */
+enum class Profile : uint8_t {
+    ConstrainedBaseline,
+    Baseline,
+    Main,
+    ConstrainedHigh,
+    High,
+    PredictiveHigh444,
+};
+
+/**
+ * H.264 levels, values are level_idc except for level 1b
+ */
+enum class Level : uint8_t {
+    L1b = 0,
+    L1 = 10,
+    L1_1 = 11,
+    L1_2 = 12,
+    L1_3 = 13,
+    L2 = 20,
+    L2_1 = 21,
+    L2_2 = 22,
+    L3 = 30,
+    L3_1 = 31,
+    L3_2 = 32,
+    L4 = 40,
+    L4_1 = 41,
+    L4_2 = 42,
+    L5 = 50,
+    L5_1 = 51,
+    L5_2 = 52,
+};
+
+/**
+ * Decoded profile-level-id
+ */
+struct ProfileLevelId {
+    Profile     profile;
+    Level       level;
+
+    constexpr bool operator==(const ProfileLevelId&) const = default;
+};
+
+namespace detail {
+
+inline constexpr uint8_t kConstraintSet3 = 0x10;
+
+/**
+ * profile_idc and a pattern of profile_iop bits, 'x' matches any value (RFC 6184 Table 5)
+ */
+struct SPattern {
+    uint8_t     profile_idc;
+    uint8_t     mask;
+    uint8_t     value;
+    Profile     profile;
+
+    constexpr SPattern(const uint8_t idc, std::string_view bits, const Profile p)
+    : profile_idc(idc), mask(0), value(0), profile(p) {
+        for (const char bit : bits) {
+            mask = static_cast<uint8_t>((mask << 1) | ((bit != 'x') ? 1 : 0));
+            value = static_cast<uint8_t>((value << 1) | ((bit == '1') ? 1 : 0));
+        }
+    }
+
+    constexpr bool Matches(const uint8_t idc, const uint8_t iop) const {
+        return (idc == profile_idc) && ((iop & mask) == value);
+    }
+};
+
+inline constexpr std::array<SPattern, 9> kPatterns{{
+    {0x42, "x1xx0000", Profile::ConstrainedBaseline},
+    {0x4D, "1xxx0000", Profile::ConstrainedBaseline},
+    {0x58, "11xx0000", Profile::ConstrainedBaseline},
+    {0x42, "x0xx0000", Profile::Baseline},
+    {0x58, "10xx0000", Profile::Baseline},
+    {0x4D, "0x0x0000", Profile::Main},
+    {0x64, "00000000", Profile::High},
+    {0x64, "00001100", Profile::ConstrainedHigh},
+    {0xF4, "00000000", Profile::PredictiveHigh444},
+}};
+
+/**
+ * Canonical profile_idc and profile_iop written for a profile
+ */
+inline constexpr std::array<std::array<uint8_t, 2>, 6> kProfileBytes{{
+    {0x42, 0xE0},    // ConstrainedBaseline
+    {0x42, 0x00},    // Baseline
+    {0x4D, 0x00},    // Main
+    {0x64, 0x0C},    // ConstrainedHigh
+    {0x64, 0x00},    // High
+    {0xF4, 0x00},    // PredictiveHigh444
+}};
+
+constexpr uint8_t Bit(const Profile profile) {
+    return static_cast<uint8_t>(1U << static_cast<unsigned>(profile));
+}
+
+/**
+ * Bit set of the profiles whose streams a decoder of the profile decodes.
+ * Constrained baseline streams conform to every profile, high decoders take main streams,
+ * baseline and high are not compatible (FMO and ASO).
+ */
+inline constexpr std::array<uint8_t, 6> kDecodable{{
+    Bit(Profile::ConstrainedBaseline),
+    static_cast<uint8_t>(Bit(Profile::Baseline) | Bit(Profile::ConstrainedBaseline)),
+    static_cast<uint8_t>(Bit(Profile::Main) | Bit(Profile::ConstrainedBaseline)),
+    static_cast<uint8_t>(Bit(Profile::ConstrainedHigh) | Bit(Profile::ConstrainedBaseline)),
+    static_cast<uint8_t>(Bit(Profile::High) | Bit(Profile::ConstrainedHigh) | Bit(Profile::Main) |
+                         Bit(Profile::ConstrainedBaseline)),
+    static_cast<uint8_t>(Bit(Profile::PredictiveHigh444) | Bit(Profile::High) | Bit(Profile::ConstrainedHigh) |
+                         Bit(Profile::Main) | Bit(Profile::ConstrainedBaseline)),
+}};
+
+constexpr bool IsValidLevelIdc(const uint8_t level_idc) {
+    switch (level_idc) {
+        case 10: case 11: case 12: case 13:
+        case 20: case 21: case 22:
+        case 30: case 31: case 32:
+        case 40: case 41: case 42:
+        case 50: case 51: case 52:
+            return true;
+        default:
+            return false;
+    }
+    return false;
+}
+
+}    // namespace detail
+
+/**
+ * Default profile-level-id when the parameter is absent (RFC 6184 8.1), constrained baseline level 3.1
+ */
+inline constexpr ProfileLevelId kDefaultProfileLevelId{Profile::ConstrainedBaseline, Level::L3_1};
+
+/**
+ * Decode profile-level-id bytes
+ * @param [in] id profile_idc, profile_iop and level_idc
+ * @returns profile and level, nothing if the profile or the level is not known
+ */
+constexpr std::optional<ProfileLevelId> Parse(const FormatParams::SProfileLevelId& id) {
+    std::optional<Level> level;
+    const bool constraint_set3 = (id.profile_iop & detail::kConstraintSet3) != 0;
+    if (id.level_idc == 9)
+        level = Level::L1b;
+    else if ((id.level_idc == 11) && constraint_set3 && (id.profile_idc != 0x64) && (id.profile_idc != 0xF4))
+        level = Level::L1b;
+    else if (detail::IsValidLevelIdc(id.level_idc))
+        level = static_cast<Level>(id.level_idc);
+    if (!level)
+        return std::nullopt;
+    for (const auto& pattern : detail::kPatterns) {
+        if (pattern.Matches(id.profile_idc, id.profile_iop))
+            return ProfileLevelId{pattern.profile, *level};
+    }
+    return std::nullopt;
+}
+
+/**
+ * Decode profile-level-id text
+ * @param [in] text six hex digits
+ * @returns profile and level, nothing if malformed or not known
+ */
+constexpr std::optional<ProfileLevelId> Parse(std::string_view text) {
+    const auto id = FormatParams::ParseProfileLevelId(text);
+    return id ? Parse(*id) : std::nullopt;
+}
+
+/**
+ * Get profile-level-id of format parameters
+ * @param [in] params
+ * @returns profile and level, the default one when the parameter is absent, nothing if malformed
+ */
+constexpr std::optional<ProfileLevelId> Parse(const FormatParams& params) {
+    if (!params.profile_level_id)
+        return kDefaultProfileLevelId;
+    return Parse(*params.profile_level_id);
+}
+
+/**
+ * Encode profile and level with the canonical profile_iop
+ * @param [in] id profile and level
+ * @returns profile-level-id bytes
+ */
+constexpr FormatParams::SProfileLevelId Encode(const ProfileLevelId& id) {
+    const auto& bytes = detail::kProfileBytes[static_cast<std::size_t>(id.profile)];
+    FormatParams::SProfileLevelId encoded{bytes[0], bytes[1], static_cast<uint8_t>(id.level)};
+    if (id.level == Level::L1b) {
+        const bool high = (id.profile == Profile::ConstrainedHigh) || (id.profile == Profile::High) ||
+                          (id.profile == Profile::PredictiveHigh444);
+        if (high) {
+            encoded.level_idc = 9;
+        } else {
+            encoded.level_idc = 11;
+            encoded.profile_iop |= detail::kConstraintSet3;
+        }
+    }
+    return encoded;
+}
+
+/**
+ * Write profile-level-id text
+ * @param [in] id profile and level
+ * @param [out] buffer
+ * @returns six lower case hex digits in buffer
+ */
+inline std::string_view ToString(const ProfileLevelId& id, std::array<char, 6>* buffer) {
+    const auto encoded = Encode(id);
+    const uint8_t bytes[3] = {encoded.profile_idc, encoded.profile_iop, encoded.level_idc};
+    hex::Encode(bytes, 3, buffer->data(), hex::Case::Lower);
+    return std::string_view(buffer->data(), buffer->size());
+}
+
+/**
+ * Compare levels, level 1b lies between 1 and 1.1
+ * @param [in] l1
+ * @param [in] l2
+ * @returns true if l1 is lower than l2
+ */
+constexpr bool IsLevelLess(const Level l1, const Level l2) {
+    if (l1 == Level::L1b)
+        return (l2 != Level::L1) && (l2 != Level::L1b);
+    if (l2 == Level::L1b)
+        return (l1 == Level::L1);
+    return static_cast<uint8_t>(l1) < static_cast<uint8_t>(l2);
+}
+
+/**
+ * Get lower level
+ * @param [in] l1
+ * @param [in] l2
+ * @returns level
+ */
+constexpr Level MinLevel(const Level l1, const Level l2) {
+    return IsLevelLess(l1, l2) ? l1 : l2;
+}
+
+/**
+ * Check if a decoder of the local profile decodes streams of the remote profile
+ * @param [in] local supported profile
+ * @param [in] remote offered profile
+ * @returns boolean
+ */
+constexpr bool IsCompatible(const Profile local, const Profile remote) {
+    return (detail::kDecodable[static_cast<std::size_t>(local)] & detail::Bit(remote)) != 0;
+}
+
+/**
+ * Get profile-level-id to answer an offer with (RFC 6184 8.2.2).
+ * The answer keeps the offered profile. The level is the local one if both sides allow level asymmetry,
+ * otherwise the lower of both.
+ * @param [in] local supported codec params
+ * @param [in] remote offered codec params
+ * @returns profile and level, nothing if the profiles are not compatible or malformed
+ */
+constexpr std::optional<ProfileLevelId> Answer(const FormatParams& local, const FormatParams& remote) {
+    const auto local_id = Parse(local);
+    const auto remote_id = Parse(remote);
+    if (!local_id || !remote_id || !IsCompatible(local_id->profile, remote_id->profile))
+        return std::nullopt;
+    const bool asymmetry = local.level_asymmetry_allowed.value_or(false) &&
+                           remote.level_asymmetry_allowed.value_or(false);
+    const auto level = asymmetry ? local_id->level : MinLevel(local_id->level, remote_id->level);
+    return ProfileLevelId{remote_id->profile, level};
+}
+
+static_assert(Parse("42e01f") == ProfileLevelId{Profile::ConstrainedBaseline, Level::L3_1});
+static_assert(Parse("42f00b") == ProfileLevelId{Profile::ConstrainedBaseline, Level::L1b});
+static_assert(Parse("640c34") == ProfileLevelId{Profile::ConstrainedHigh, Level::L5_2});
+static_assert(Encode(ProfileLevelId{Profile::Baseline, Level::L1b}) == FormatParams::SProfileLevelId{0x42, 0x10, 11});
+static_assert(IsLevelLess(Level::L1, Level::L1b) && IsLevelLess(Level::L1b, Level::L1_1));
+
+}    // namespace h264
+
+}    // namespace semantic_sdp
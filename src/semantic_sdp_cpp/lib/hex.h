@@ -0,0 +1,369 @@
+// "Copyright 2024 <Oldnick85>"
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string_view>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__)) && defined(__SSE2__)
+#define SEMANTIC_SDP_HEX_SSSE3
+#include <immintrin.h>
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+namespace semantic_sdp {
+
+namespace hex {
+
+/**
+ * Letter case of the encoded digits a..f
+ */
+enum class Case : uint8_t {
+    Upper,
+    Lower,
+};
+
+/**
+ * Get encoded text length
+ * @param [in] count number of bytes
+ * @param [in] separator separator between bytes, '\0' for none
+ * @returns number of characters
+ */
+constexpr std::size_t EncodedSize(const std::size_t count, const char separator = '\0') {
+    if (count == 0)
+        return 0;
+    return (separator != '\0') ? count * 3 - 1 : count * 2;
+}
+
+namespace detail {
+
+/**
+ * Get value of a hex digit of either case
+ * @param [in] c character
+ * @returns 0..15, or -1 if c is not a hex digit
+ */
+constexpr int Nibble(const char c) {
+    if ((c >= '0') && (c <= '9'))
+        return c - '0';
+    const char l = static_cast<char>(c | 0x20);
+    if ((l >= 'a') && (l <= 'f'))
+        return l - 'a' + 10;
+    return -1;
+}
+
+inline char* EncodeScalar(const uint8_t* bytes, const std::size_t count, char* out, const Case letter_case) {
+    const char* digits = (letter_case == Case::Upper) ? "0123456789ABCDEF" : "0123456789abcdef";
+    for (std::size_t i = 0; i < count; ++i) {
+        *out++ = digits[bytes[i] >> 4];
+        *out++ = digits[bytes[i] & 0x0F];
+    }
+    return out;
+}
+
+inline bool DecodeScalar(const char* text, const std::size_t count, uint8_t* out) {
+    for (std::size_t i = 0; i < count; ++i) {
+        const int hi = Nibble(text[i * 2]);
+        const int lo = Nibble(text[i * 2 + 1]);
+        if ((hi < 0) || (lo < 0))
+            return false;
+        out[i] = static_cast<uint8_t>((hi << 4) | lo);
+    }
+    return true;
+}
+
+#if defined(__SSE2__)
+
+inline __m128i NibblesToChars(const __m128i nibbles, const __m128i letter_offset) {
+    const __m128i letters = _mm_cmpgt_epi8(nibbles, _mm_set1_epi8(9));
+    return _mm_add_epi8(_mm_add_epi8(nibbles, _mm_set1_epi8('0')), _mm_and_si128(letters, letter_offset));
+}
+
+/**
+ * Encode 16 bytes into 32 characters, the digits of bytes 0..7 go to first and of bytes 8..15 to second
+ */
+inline void EncodeBlock(const uint8_t* bytes, const __m128i letter_offset, __m128i* first, __m128i* second) {
+    const __m128i mask = _mm_set1_epi8(0x0F);
+    const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(bytes));
+    const __m128i hi = NibblesToChars(_mm_and_si128(_mm_srli_epi16(v, 4), mask), letter_offset);
+    const __m128i lo = NibblesToChars(_mm_and_si128(v, mask), letter_offset);
+    *first = _mm_unpacklo_epi8(hi, lo);
+    *second = _mm_unpackhi_epi8(hi, lo);
+}
+
+inline void Encode16(const uint8_t* bytes, char* out, const __m128i letter_offset) {
+    __m128i first;
+    __m128i second;
+    EncodeBlock(bytes, letter_offset, &first, &second);
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(out), first);
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(out + 16), second);
+}
+
+/**
+ * Convert 16 hex digits into their values
+ * @returns false if a character is not a hex digit
+ */
+inline bool CharsToNibbles(const __m128i c, __m128i* nibbles) {
+    const __m128i digit = _mm_and_si128(_mm_cmpgt_epi8(c, _mm_set1_epi8('0' - 1)),
+                                        _mm_cmplt_epi8(c, _mm_set1_epi8('9' + 1)));
+    const __m128i l = _mm_or_si128(c, _mm_set1_epi8(0x20));
+    const __m128i letter = _mm_and_si128(_mm_cmpgt_epi8(l, _mm_set1_epi8('a' - 1)),
+                                         _mm_cmplt_epi8(l, _mm_set1_epi8('f' + 1)));
+    if (_mm_movemask_epi8(_mm_or_si128(digit, letter)) != 0xFFFF)
+        return false;
+    *nibbles = _mm_or_si128(_mm_and_si128(digit, _mm_sub_epi8(c, _mm_set1_epi8('0'))),
+                            _mm_and_si128(letter, _mm_sub_epi8(l, _mm_set1_epi8('a' - 10))));
+    return true;
+}
+
+/**
+ * Decode 32 characters into 16 bytes
+ * @returns false if a character is not a hex digit
+ */
+inline bool DecodeBlock(const __m128i first, const __m128i second, uint8_t* out) {
+    __m128i n1;
+    __m128i n2;
+    if (!CharsToNibbles(first, &n1) || !CharsToNibbles(second, &n2))
+        return false;
+    // Each 16 bit lane holds the high nibble in its low byte and the low nibble in its high byte
+    const __m128i low_byte = _mm_set1_epi16(0x00FF);
+    const __m128i b1 = _mm_or_si128(_mm_slli_epi16(_mm_and_si128(n1, low_byte), 4), _mm_srli_epi16(n1, 8));
+    const __m128i b2 = _mm_or_si128(_mm_slli_epi16(_mm_and_si128(n2, low_byte), 4), _mm_srli_epi16(n2, 8));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(out), _mm_packus_epi16(b1, b2));
+    return true;
+}
+
+inline bool Decode16(const char* text, uint8_t* out) {
+    return DecodeBlock(_mm_loadu_si128(reinterpret_cast<const __m128i*>(text)),
+                       _mm_loadu_si128(reinterpret_cast<const __m128i*>(text + 16)), out);
+}
+
+#endif
+
+#ifdef SEMANTIC_SDP_HEX_SSSE3
+
+using ShuffleMask = std::array<int8_t, 16>;
+
+/**
+ * Shuffle masks between 32 packed digits and 48 separated characters "XX:XX:...XX:".
+ * Spread[k][s] moves packed register s into separated register k, Gather[k][s] moves separated
+ * register s into packed register k, Separators[s] marks the separator positions of separated register s.
+ */
+struct SShuffleMasks {
+    std::array<std::array<ShuffleMask, 2>, 3>   spread{};
+    std::array<std::array<ShuffleMask, 3>, 2>   gather{};
+    std::array<ShuffleMask, 3>                  separators{};
+
+    constexpr SShuffleMasks() {
+        for (auto& reg : spread)
+            for (auto& mask : reg)
+                mask.fill(-128);
+        for (auto& reg : gather)
+            for (auto& mask : reg)
+                mask.fill(-128);
+        for (int pos = 0; pos < 48; ++pos) {
+            const int pair = pos / 3;
+            if (pos % 3 == 2) {
+                separators[pos / 16][pos % 16] = -1;
+                continue;
+            }
+            const int digit = pair * 2 + pos % 3;
+            spread[pos / 16][digit / 16][pos % 16] = static_cast<int8_t>(digit % 16);
+            gather[digit / 16][pos / 16][digit % 16] = static_cast<int8_t>(pos % 16);
+        }
+    }
+};
+
+inline constexpr SShuffleMasks kShuffleMasks;
+
+inline __m128i LoadMask(const ShuffleMask& mask) {
+    return _mm_loadu_si128(reinterpret_cast<const __m128i*>(mask.data()));
+}
+
+/**
+ * Encode bytes with separators 16 at a time while more bytes follow the block
+ * @returns number of bytes encoded
+ */
+__attribute__((target("ssse3")))
+inline std::size_t EncodeSeparatedSSSE3(const uint8_t* bytes, const std::size_t count, char* out,
+                                        const Case letter_case, const char separator) {
+    const __m128i letter_offset = _mm_set1_epi8((letter_case == Case::Upper) ? 'A' - '0' - 10 : 'a' - '0' - 10);
+    const __m128i separators = _mm_set1_epi8(separator);
+    std::size_t done = 0;
+    for (; done + 16 < count; done += 16, out += 48) {
+        __m128i packed[2];
+        EncodeBlock(bytes + done, letter_offset, &packed[0], &packed[1]);
+        for (std::size_t k = 0; k < 3; ++k) {
+            const __m128i chars = _mm_or_si128(_mm_shuffle_epi8(packed[0], LoadMask(kShuffleMasks.spread[k][0])),
+                                               _mm_shuffle_epi8(packed[1], LoadMask(kShuffleMasks.spread[k][1])));
+            const __m128i with_separators = _mm_or_si128(
+                chars, _mm_and_si128(separators, LoadMask(kShuffleMasks.separators[k])));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(out + k * 16), with_separators);
+        }
+    }
+    return done;
+}
+
+/**
+ * Decode bytes with separators 16 at a time while more bytes follow the block
+ * @param [out] done number of bytes decoded
+ * @returns false if the text is malformed
+ */
+__attribute__((target("ssse3")))
+inline bool DecodeSeparatedSSSE3(const char* text, const std::size_t count, uint8_t* out, const char separator,
+                                 std::size_t* done) {
+    const __m128i separators = _mm_set1_epi8(separator);
+    std::size_t pos = 0;
+    for (; pos + 16 < count; pos += 16, text += 48) {
+        __m128i chars[3];
+        for (std::size_t s = 0; s < 3; ++s) {
+            chars[s] = _mm_loadu_si128(reinterpret_cast<const __m128i*>(text + s * 16));
+            const __m128i mask = LoadMask(kShuffleMasks.separators[s]);
+            const __m128i found = _mm_and_si128(_mm_cmpeq_epi8(chars[s], separators), mask);
+            if (_mm_movemask_epi8(found) != _mm_movemask_epi8(mask))
+                return false;
+        }
+        __m128i packed[2];
+        for (std::size_t k = 0; k < 2; ++k) {
+            packed[k] = _mm_or_si128(
+                _mm_or_si128(_mm_shuffle_epi8(chars[0], LoadMask(kShuffleMasks.gather[k][0])),
+                             _mm_shuffle_epi8(chars[1], LoadMask(kShuffleMasks.gather[k][1]))),
+                _mm_shuffle_epi8(chars[2], LoadMask(kShuffleMasks.gather[k][2])));
+        }
+        if (!DecodeBlock(packed[0], packed[1], out + pos))
+            return false;
+    }
+    *done = pos;
+    return true;
+}
+
+/**
+ * Get whether the CPU supports SSSE3, detected once
+ * @returns boolean
+ */
+inline bool HasSSSE3() {
+    static const bool supported = __builtin_cpu_supports("ssse3");
+    return supported;
+}
+
+#endif
+
+inline char* EncodePacked(const uint8_t* bytes, std::size_t count, char* out, const Case letter_case) {
+#if defined(__SSE2__)
+    const __m128i letter_offset = _mm_set1_epi8((letter_case == Case::Upper) ? 'A' - '0' - 10 : 'a' - '0' - 10);
+    for (; count >= 16; count -= 16, bytes += 16, out += 32)
+        Encode16(bytes, out, letter_offset);
+#endif
+    return EncodeScalar(bytes, count, out, letter_case);
+}
+
+inline bool DecodePacked(const char* text, std::size_t count, uint8_t* out) {
+#if defined(__SSE2__)
+    for (; count >= 16; count -= 16, text += 32, out += 16) {
+        if (!Decode16(text, out))
+            return false;
+    }
+#endif
+    return DecodeScalar(text, count, out);
+}
+
+}    // namespace detail
+
+/**
+ * Encode bytes as hex text
+ * @param [in] bytes
+ * @param [in] count number of bytes
+ * @param [out] out buffer of EncodedSize(count, separator) characters
+ * @param [in] letter_case case of the digits a..f
+ * @param [in] separator separator between bytes, e.g. ':' for fingerprints, '\0' for none
+ * @returns end of the written text
+ */
+inline char* Encode(const uint8_t* bytes, std::size_t count, char* out, const Case letter_case = Case::Upper,
+                    const char separator = '\0') {
+    if (separator == '\0')
+        return detail::EncodePacked(bytes, count, out, letter_case);
+    bool first = true;
+#ifdef SEMANTIC_SDP_HEX_SSSE3
+    if (detail::HasSSSE3()) {
+        // Blocks end with the separator of the bytes that follow
+        const auto done = detail::EncodeSeparatedSSSE3(bytes, count, out, letter_case, separator);
+        bytes += done;
+        count -= done;
+        out += done * 3;
+    }
+#endif
+    // Encode packed in blocks, then spread the digit pairs
+    std::array<char, 64> packed;
+    while (count > 0) {
+        const std::size_t chunk = std::min<std::size_t>(count, packed.size() / 2);
+        detail::EncodePacked(bytes, chunk, packed.data(), letter_case);
+        for (std::size_t i = 0; i < chunk; ++i) {
+            if (!first)
+                *out++ = separator;
+            first = false;
+            std::memcpy(out, packed.data() + i * 2, 2);
+            out += 2;
+        }
+        bytes += chunk;
+        count -= chunk;
+    }
+    return out;
+}
+
+/**
+ * Decode hex text of either case
+ * @param [in] text hex digits, pairs delimited by separator if it is set
+ * @param [out] out buffer for the bytes
+ * @param [in] capacity size of the buffer
+ * @param [out] size number of decoded bytes
+ * @param [in] separator separator between bytes, '\0' for none
+ * @returns false if the text is malformed or does not fit
+ */
+inline bool Decode(std::string_view text, uint8_t* out, const std::size_t capacity, std::size_t* size,
+                   const char separator = '\0') {
+    if (size == nullptr)
+        return false;
+    *size = 0;
+    if (text.empty())
+        return true;
+    if (separator == '\0') {
+        if (((text.size() % 2) != 0) || (text.size() / 2 > capacity))
+            return false;
+        if (!detail::DecodePacked(text.data(), text.size() / 2, out))
+            return false;
+        *size = text.size() / 2;
+        return true;
+    }
+    if (((text.size() + 1) % 3 != 0) || ((text.size() + 1) / 3 > capacity))
+        return false;
+    const std::size_t count = (text.size() + 1) / 3;
+    std::size_t done = 0;
+#ifdef SEMANTIC_SDP_HEX_SSSE3
+    if (detail::HasSSSE3() && !detail::DecodeSeparatedSSSE3(text.data(), count, out, separator, &done))
+        return false;
+#endif
+    // Gather the digit pairs into blocks, then decode packed
+    std::array<char, 64> packed;
+    while (done < count) {
+        const std::size_t chunk = std::min<std::size_t>(count - done, packed.size() / 2);
+        for (std::size_t i = 0; i < chunk; ++i) {
+            const std::size_t pos = (done + i) * 3;
+            if ((pos + 2 < text.size()) && (text[pos + 2] != separator))
+                return false;
+            std::memcpy(packed.data() + i * 2, text.data() + pos, 2);
+        }
+        if (!detail::DecodePacked(packed.data(), chunk, out + done))
+            return false;
+        done += chunk;
+    }
+    *size = count;
+    return true;
+}
+
+}    // namespace hex
+
+}    // namespace semantic_sdp
@@ -2,10 +2,13 @@
 
 #pragma once
 
+#include <array>
 #include <string>
+#include <string_view>
 #include <memory>
 
 #include "./util.h"
+#include "./memory.h"
 
 namespace semantic_sdp {
 
@@ -15,11 +18,11 @@ using ICEInfo = std::unique_ptr<CICEInfo>;
 /**
  * ICE information for a peer
  */
-class CICEInfo {
+class CICEInfo : public memory::CAllocated {
 // TODO(Unknown): ice-options: trickle
  private:
-    std::string     m_ufrag;
-    std::string     m_pwd;
+    memory::String  m_ufrag;
+    memory::String  m_pwd;
     bool            m_lite = false;
     bool            m_end_of_candidates = false;
 
@@ -29,7 +32,7 @@ class CICEInfo {
      * @param [in] ufrag Peer ICE username framgent
      * @param [in] pwd Peer ICE password
      */
-    CICEInfo(const std::string& ufrag, const std::string& pwd)
+    CICEInfo(std::string_view ufrag, std::string_view pwd)
     : m_ufrag(ufrag)
     , m_pwd(pwd)
     {}
@@ -39,6 +42,7 @@ class CICEInfo {
      * @returns ICE info
      */
     ICEInfo Clone() const {
+        memory::COperation operation(memory::Operation::Clone);
         auto cloned = std::make_unique<CICEInfo>(m_ufrag, m_pwd);
         cloned->SetLite(m_lite);
         cloned->SetEndOfCandidates(m_end_of_candidates);
@@ -92,15 +96,19 @@ class CICEInfo {
 /**
  * Genereate a new peer ICE info with ramdom values
  * @param [in] lite Set ICE lite flag
- * @returns ICE info
+ * @returns ICE info, nullptr if the system random source failed
  */
-ICEInfo generate(const bool lite) {
-    // Create key and pwd bytes
-    const auto ufrag_b = random_bytes(8);
-    const auto pwd_b = random_bytes(24);
-    // Create ramdom pwd
-    const auto ufrag = bytes_to_hex(ufrag_b);
-    const auto pwd   = bytes_to_hex(pwd_b);
+inline ICEInfo generate(const bool lite) {
+    // Key and pwd bytes in one draw from the thread random pool
+    constexpr std::size_t kUfragBytes = 8;
+    constexpr std::size_t kPwdBytes = 24;
+    std::array<uint8_t, kUfragBytes + kPwdBytes> bytes;
+    if (!random::Fill(&bytes))
+        return nullptr;
+    std::array<char, bytes.size() * 2> text;
+    bytes_to_hex(bytes.data(), bytes.size(), text.data());
+    const std::string_view ufrag(text.data(), kUfragBytes * 2);
+    const std::string_view pwd(text.data() + kUfragBytes * 2, kPwdBytes * 2);
 
     auto info = std::make_unique<CICEInfo>(ufrag, pwd);
     info->SetLite(lite);
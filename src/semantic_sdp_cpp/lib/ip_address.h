@@ -0,0 +1,259 @@
+// "Copyright 2024 <Oldnick85>"
+
+#pragma once
+
+#include <array>
+#include <charconv>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <string_view>
+
+#include "./atom.h"
+#include "./util.h"
+#include "./memory.h"
+
+namespace semantic_sdp {
+
+/**
+ * Address of an ICE candidate: binary IPv4 or IPv6 address, or a host name (e.g. mDNS "<uuid>.local")
+ * kept as text when the value is not an IP literal. The host name is held out of line, so IP
+ * addresses pay a single pointer for it.
+ */
+class IPAddress {
+ public:
+    enum class Family : uint8_t {
+        None,
+        IPv4,
+        IPv6,
+        Hostname,
+    };
+
+    /**
+     * Buffer long enough for any IP address text, "ffff:ffff:ffff:ffff:ffff:ffff:255.255.255.255"
+     */
+    using TextBuffer = std::array<char, 46>;
+
+ private:
+    std::array<uint8_t, 16>     m_bytes{};    // IPv4 uses the first 4 bytes
+    Family                      m_family{Family::None};
+    Atom                        m_hostname;    // only set for Family::Hostname
+
+    static bool ParseIPv4(std::string_view text, uint8_t* bytes) {
+        for (int i = 0; i < 4; ++i) {
+            const auto part = next_token(&text, '.');
+            // One to three digits, no leading zeros
+            if (part.empty() || (part.size() > 3) || ((part.size() > 1) && (part[0] == '0')))
+                return false;
+            unsigned value = 0;
+            const auto res = std::from_chars(part.data(), part.data() + part.size(), value);
+            if ((res.ec != std::errc()) || (res.ptr != part.data() + part.size()) || (value > 255))
+                return false;
+            bytes[i] = static_cast<uint8_t>(value);
+            if ((i < 3) && text.empty())
+                return false;
+        }
+        return text.empty();
+    }
+
+    static bool ParseIPv6(std::string_view text, std::array<uint8_t, 16>* bytes) {
+        std::array<uint16_t, 8> groups{};
+        std::size_t count = 0;
+        int gap = -1;
+        if (text.starts_with("::")) {
+            gap = 0;
+            text.remove_prefix(2);
+        } else if (text.starts_with(":")) {
+            return false;
+        }
+        while (!text.empty()) {
+            const auto group = text.substr(0, text.find(':'));
+            if (group.find('.') != std::string_view::npos) {
+                // Dotted IPv4 tail takes the last two groups
+                uint8_t ipv4[4];
+                if ((group.size() != text.size()) || (count > 6) || !ParseIPv4(group, ipv4))
+                    return false;
+                groups[count++] = static_cast<uint16_t>((ipv4[0] << 8) | ipv4[1]);
+                groups[count++] = static_cast<uint16_t>((ipv4[2] << 8) | ipv4[3]);
+                break;
+            }
+            if ((count == 8) || group.empty() || (group.size() > 4))
+                return false;
+            const auto res = std::from_chars(group.data(), group.data() + group.size(), groups[count], 16);
+            if ((res.ec != std::errc()) || (res.ptr != group.data() + group.size()))
+                return false;
+            ++count;
+            text.remove_prefix(group.size());
+            if (text.empty())
+                break;
+            text.remove_prefix(1);
+            if (text.starts_with(":")) {
+                if (gap >= 0)
+                    return false;
+                gap = static_cast<int>(count);
+                text.remove_prefix(1);
+            } else if (text.empty()) {
+                return false;
+            }
+        }
+        if ((gap < 0) ? (count != 8) : (count > 7))
+            return false;
+        // Groups after the gap move to the end
+        std::array<uint16_t, 8> expanded{};
+        const std::size_t tail = (gap < 0) ? 0 : count - gap;
+        const std::size_t head = count - tail;
+        for (std::size_t i = 0; i < head; ++i)
+            expanded[i] = groups[i];
+        for (std::size_t i = 0; i < tail; ++i)
+            expanded[8 - tail + i] = groups[head + i];
+        for (std::size_t i = 0; i < 8; ++i) {
+            (*bytes)[i * 2] = static_cast<uint8_t>(expanded[i] >> 8);
+            (*bytes)[i * 2 + 1] = static_cast<uint8_t>(expanded[i]);
+        }
+        return true;
+    }
+
+    static char* FormatIPv4(const uint8_t* bytes, char* out) {
+        for (int i = 0; i < 4; ++i) {
+            if (i != 0)
+                *out++ = '.';
+            out = std::to_chars(out, out + 3, bytes[i]).ptr;
+        }
+        return out;
+    }
+
+    char* FormatIPv6(char* out) const {
+        // RFC 5952: lower case, no leading zeros, the longest run of two or more zero groups becomes "::"
+        std::array<uint16_t, 8> groups;
+        for (std::size_t i = 0; i < 8; ++i)
+            groups[i] = static_cast<uint16_t>((m_bytes[i * 2] << 8) | m_bytes[i * 2 + 1]);
+        std::size_t best_start = 8;
+        std::size_t best_length = 1;
+        for (std::size_t i = 0; i < 8;) {
+            std::size_t length = 0;
+            while ((i + length < 8) && (groups[i + length] == 0))
+                ++length;
+            if (length > best_length) {
+                best_start = i;
+                best_length = length;
+            }
+            i += (length != 0) ? length : 1;
+        }
+        // IPv4-mapped addresses keep the dotted notation
+        const bool mapped = (best_start == 0) && (best_length == 5) && (groups[5] == 0xFFFF);
+        const std::size_t hex_groups = mapped ? 6 : 8;
+        for (std::size_t i = 0; i < hex_groups; ++i) {
+            if (i == best_start) {
+                *out++ = ':';
+                *out++ = ':';
+                i += best_length - 1;
+                continue;
+            }
+            if ((i != 0) && (i != best_start + best_length))
+                *out++ = ':';
+            out = std::to_chars(out, out + 4, groups[i], 16).ptr;
+        }
+        if (mapped) {
+            *out++ = ':';
+            out = FormatIPv4(m_bytes.data() + 12, out);
+        }
+        return out;
+    }
+
+ public:
+    IPAddress() = default;
+
+    /**
+     * Parse candidate address
+     * @param [in] text IPv4 or IPv6 literal, or host name
+     * @returns address, host name if the text is not an IP literal, none if it is empty
+     */
+    static IPAddress Parse(std::string_view text) {
+        IPAddress address;
+        if (text.empty())
+            return address;
+        if (ParseIPv4(text, address.m_bytes.data())) {
+            address.m_family = Family::IPv4;
+        } else if ((text.find(':') != std::string_view::npos) && ParseIPv6(text, &address.m_bytes)) {
+            address.m_family = Family::IPv6;
+        } else {
+            address.m_bytes = {};
+            address.m_family = Family::Hostname;
+            address.m_hostname = text;
+        }
+        return address;
+    }
+
+    /**
+     * Get address family
+     * @returns family
+     */
+    Family GetFamily() const {
+        return m_family;
+    }
+
+    /**
+     * Check if the address is a host name ending with ".local", as used by mDNS candidates
+     * @returns boolean
+     */
+    bool IsMDNS() const {
+        const std::string_view suffix(".local");
+        return (m_family == Family::Hostname) && (m_hostname.size() > suffix.size())
+               && iequals(m_hostname.view().substr(m_hostname.size() - suffix.size()), suffix);
+    }
+
+    /**
+     * Get binary address in network byte order, IPv4 uses the first 4 bytes
+     * @returns bytes
+     */
+    const auto& GetBytes() const {
+        return m_bytes;
+    }
+
+    /**
+     * Get address text without allocating
+     * @param [out] buffer storage for IP address text
+     * @returns text in buffer, or the host name
+     */
+    std::string_view Format(TextBuffer* buffer) const {
+        switch (m_family) {
+            case Family::IPv4:
+                return std::string_view(buffer->data(), FormatIPv4(m_bytes.data(), buffer->data()) - buffer->data());
+            case Family::IPv6:
+                return std::string_view(buffer->data(), FormatIPv6(buffer->data()) - buffer->data());
+            case Family::Hostname:
+                return m_hostname.view();
+            default:
+                break;
+        }
+        return {};
+    }
+
+    /**
+     * Get address text
+     * @returns text
+     */
+    std::string ToString() const {
+        TextBuffer buffer;
+        return std::string(Format(&buffer));
+    }
+
+    /**
+     * Get hash of the address
+     * @returns hash
+     */
+    std::size_t Hash() const {
+        if (m_family == Family::Hostname)
+            return m_hostname.Hash();
+        const auto* bytes = reinterpret_cast<const char*>(m_bytes.data());
+        return hash_combine(static_cast<std::size_t>(m_family),
+                            hash_combine(detail::load_word(bytes), detail::load_word(bytes + 8)));
+    }
+
+    bool operator==(const IPAddress& other) const {
+        return (m_family == other.m_family) && (m_bytes == other.m_bytes) && (m_hostname == other.m_hostname);
+    }
+};
+
+}    // namespace semantic_sdp
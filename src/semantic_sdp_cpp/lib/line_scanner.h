@@ -0,0 +1,303 @@
+// "Copyright 2024 <Oldnick85>"
+
+#pragma once
+
+#include <algorithm>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <string_view>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__)) && defined(__SSE2__)
+#define SEMANTIC_SDP_SCAN_X86
+#include <immintrin.h>
+#endif
+
+#include "./memory.h"
+#include "./util.h"
+
+namespace semantic_sdp {
+
+namespace sdp {
+
+namespace detail {
+
+constexpr uint32_t MixAttributeHash(const uint64_t first, const uint64_t last, const std::size_t size) {
+    const uint64_t hash = (first * 0x9E3779B97F4A7C15ULL) ^ (last * 0xC2B2AE3D27D4EB4FULL) ^ size;
+    return static_cast<uint32_t>(hash >> 32) ^ static_cast<uint32_t>(hash);
+}
+
+}    // namespace detail
+
+/**
+ * Hash of an attribute name as stored in the line index, usable for case labels.
+ * Mixes the length with the first and the last 8 characters, so it costs two loads whatever the name.
+ * @param [in] name attribute name
+ * @returns hash
+ */
+constexpr uint32_t AttributeHash(std::string_view name) {
+    const auto head = std::min<std::size_t>(name.size(), 8);
+    const uint64_t first = semantic_sdp::detail::load_word(name.data(), head);
+    const uint64_t last = semantic_sdp::detail::load_word(name.data() + name.size() - head, head);
+    return detail::MixAttributeHash(first, last, name.size());
+}
+
+/**
+ * One non-empty line of SDP text, positions are relative to the start of the text
+ */
+struct SLine {
+    uint32_t    offset;         // value start, just after "<type>="
+    uint32_t    length;         // value length without the line terminator
+    uint32_t    name_hash;      // AttributeHash of the attribute name, 'a' lines only
+    uint16_t    name_length;    // length of the value up to the first ':'
+    char        type;           // line type character
+
+    /**
+     * Get line value
+     * @param [in] sdp SDP text the line was scanned from
+     * @returns value after "<type>="
+     */
+    std::string_view Value(std::string_view sdp) const {
+        return sdp.substr(offset, length);
+    }
+
+    /**
+     * Get attribute name, the part of the value before the first ':'
+     * @param [in] sdp SDP text the line was scanned from
+     * @returns name
+     */
+    std::string_view Name(std::string_view sdp) const {
+        return sdp.substr(offset, name_length);
+    }
+
+    /**
+     * Get attribute value, the part of the value after the first ':'
+     * @param [in] sdp SDP text the line was scanned from
+     * @returns attribute value, empty if there is no ':'
+     */
+    std::string_view AttributeValue(std::string_view sdp) const {
+        return (name_length < length) ? sdp.substr(offset + name_length + 1, length - name_length - 1) :
+                                        std::string_view();
+    }
+};
+static_assert(sizeof(SLine) == 16);
+
+using LineIndex = memory::Vector<SLine>;
+
+/**
+ * Instruction set used to find line and attribute name boundaries
+ */
+enum class ScanLevel : uint8_t {
+    Scalar,
+    SSE2,
+    AVX2,
+};
+
+namespace detail {
+
+/**
+ * Collects line boundaries found by the scanners into the index
+ */
+class CLineBuilder {
+ private:
+    static constexpr std::size_t kNoColon = std::numeric_limits<std::size_t>::max();
+
+    std::string_view    m_sdp;
+    LineIndex*          m_lines;
+    std::size_t         m_line_start{0};
+    std::size_t         m_colon{kNoColon};
+    bool                m_valid{true};
+
+ public:
+    CLineBuilder(std::string_view sdp, LineIndex* lines)
+    : m_sdp(sdp), m_lines(lines)
+    {}
+
+    /**
+     * Get whether the colon of the current line is still to be found
+     * @returns boolean
+     */
+    bool NeedsColon() const {
+        return (m_colon == kNoColon);
+    }
+
+    /**
+     * Mark first ':' of the current line
+     * @param [in] pos position in the text
+     */
+    void Colon(const std::size_t pos) {
+        if (m_colon == kNoColon)
+            m_colon = pos;
+    }
+
+    /**
+     * Close the current line
+     * @param [in] pos position of the line feed in the text
+     */
+    void NewLine(std::size_t pos) {
+        const auto start = m_line_start;
+        m_line_start = pos + 1;
+        const auto colon = m_colon;
+        m_colon = kNoColon;
+        if ((pos > start) && (m_sdp[pos - 1] == '\r'))
+            --pos;
+        if (pos == start)
+            return;
+        if ((pos - start < 2) || (m_sdp[start + 1] != '=')) {
+            m_valid = false;
+            return;
+        }
+        SLine line;
+        line.offset = static_cast<uint32_t>(start + 2);
+        line.length = static_cast<uint32_t>(pos - start - 2);
+        line.type = m_sdp[start];
+        line.name_length = static_cast<uint16_t>(std::min<std::size_t>(
+            ((colon != kNoColon) && (colon >= line.offset)) ? colon - line.offset : line.length,
+            std::numeric_limits<uint16_t>::max()));
+        line.name_hash = (line.type == 'a') ? NameHash(line.offset, line.name_length) : 0;
+        m_lines->push_back(line);
+    }
+
+    /**
+     * AttributeHash of a name in the text, reading whole words where the text allows it
+     * @param [in] offset name position
+     * @param [in] size name length
+     * @returns hash
+     */
+    uint32_t NameHash(const std::size_t offset, const std::size_t size) const {
+        const char* name = m_sdp.data() + offset;
+        if (size >= 8) {
+            return MixAttributeHash(semantic_sdp::detail::load_word(name),
+                                    semantic_sdp::detail::load_word(name + size - 8), size);
+        }
+        if (offset + 8 > m_sdp.size())
+            return AttributeHash(std::string_view(name, size));
+        // Short name, the bytes after it belong to the same text and are masked out
+        const uint64_t word = semantic_sdp::detail::load_word(name) & ((uint64_t{1} << (size * 8)) - 1);
+        return MixAttributeHash(word, word, size);
+    }
+
+    /**
+     * Process the boundaries of one block of the text
+     * @param [in] base position of the block in the text
+     * @param [in] newlines bit mask of '\n' in the block
+     * @param [in] colons bit mask of ':' in the block
+     */
+    void Block(const std::size_t base, uint64_t newlines, uint64_t colons) {
+        while (true) {
+            const uint64_t next = newlines & (0 - newlines);
+            const uint64_t before = (next != 0) ? next - 1 : ~uint64_t{0};
+            if (NeedsColon() && ((colons & before) != 0))
+                Colon(base + std::countr_zero(colons & before));
+            colons &= ~before;
+            if (next == 0)
+                break;
+            NewLine(base + std::countr_zero(next));
+            newlines ^= next;
+        }
+    }
+
+    /**
+     * Process the rest of the text one character at a time and close the last line
+     * @param [in] pos position to continue from
+     * @returns false if a line is malformed
+     */
+    bool Finish(std::size_t pos) {
+        for (; pos < m_sdp.size(); ++pos) {
+            if (m_sdp[pos] == '\n')
+                NewLine(pos);
+            else if (m_sdp[pos] == ':')
+                Colon(pos);
+        }
+        if (m_line_start < m_sdp.size())
+            NewLine(m_sdp.size());
+        return m_valid;
+    }
+};
+
+#ifdef SEMANTIC_SDP_SCAN_X86
+
+inline std::size_t ScanSSE2(std::string_view sdp, CLineBuilder* builder) {
+    const __m128i newline = _mm_set1_epi8('\n');
+    const __m128i colon = _mm_set1_epi8(':');
+    std::size_t pos = 0;
+    for (; pos + 16 <= sdp.size(); pos += 16) {
+        const __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(sdp.data() + pos));
+        const auto newlines = static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(block, newline)));
+        const auto colons = static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(block, colon)));
+        if ((newlines | colons) != 0)
+            builder->Block(pos, newlines, colons);
+    }
+    return pos;
+}
+
+__attribute__((target("avx2")))
+inline std::size_t ScanAVX2(std::string_view sdp, CLineBuilder* builder) {
+    const __m256i newline = _mm256_set1_epi8('\n');
+    const __m256i colon = _mm256_set1_epi8(':');
+    std::size_t pos = 0;
+    for (; pos + 64 <= sdp.size(); pos += 64) {
+        const __m256i lo = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(sdp.data() + pos));
+        const __m256i hi = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(sdp.data() + pos + 32));
+        const uint64_t newlines = static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(lo, newline)))
+            | (static_cast<uint64_t>(static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(hi, newline))))
+               << 32);
+        const uint64_t colons = static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(lo, colon)))
+            | (static_cast<uint64_t>(static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(hi, colon))))
+               << 32);
+        if ((newlines | colons) != 0)
+            builder->Block(pos, newlines, colons);
+    }
+    return pos;
+}
+
+#endif
+
+}    // namespace detail
+
+/**
+ * Get the best scan level supported by the CPU, detected once
+ * @returns scan level
+ */
+inline ScanLevel DetectScanLevel() {
+#ifdef SEMANTIC_SDP_SCAN_X86
+    static const ScanLevel level = __builtin_cpu_supports("avx2") ? ScanLevel::AVX2 : ScanLevel::SSE2;
+    return level;
+#else
+    return ScanLevel::Scalar;
+#endif
+}
+
+/**
+ * Build the index of the non-empty lines of SDP text in one pass.
+ * Lines end with "\n" or "\r\n", the last line may have no terminator.
+ * @param [in] sdp SDP text, at most 4 GiB
+ * @param [out] lines line index, cleared first
+ * @param [in] level instruction set, levels the CPU does not support fall back to the best supported one
+ * @returns false if a line does not start with "<type>="
+ */
+inline bool ScanLines(std::string_view sdp, LineIndex* lines, ScanLevel level = DetectScanLevel()) {
+    if ((lines == nullptr) || (sdp.size() > std::numeric_limits<uint32_t>::max()))
+        return false;
+    lines->clear();
+    // Typical SDP lines are a few dozen characters long
+    lines->reserve(sdp.size() / 32 + 1);
+    detail::CLineBuilder builder(sdp, lines);
+    std::size_t pos = 0;
+#ifdef SEMANTIC_SDP_SCAN_X86
+    if (level > DetectScanLevel())
+        level = DetectScanLevel();
+    if (level == ScanLevel::AVX2)
+        pos = detail::ScanAVX2(sdp, &builder);
+    else if (level == ScanLevel::SSE2)
+        pos = detail::ScanSSE2(sdp, &builder);
+#else
+    static_cast<void>(level);
+#endif
+    return builder.Finish(pos);
+}
+
+}    // namespace sdp
+
+}    // namespace semantic_sdp
@@ -2,13 +2,17 @@
 
 #pragma once
 
+#include <array>
 #include <string>
-#include <unordered_map>
+#include <string_view>
 #include <vector>
 #include <memory>
 #include <utility>
 
+#include "./atom.h"
 #include "./util.h"
+#include "./memory.h"
+#include "./candidate_info.h"
 #include "./codec_info.h"
 #include "./rid_info.h"
 #include "./simulcast_info.h"
@@ -16,39 +20,40 @@
 #include "./direction_way.h"
 #include "./rtcp_feedback_info.h"
 #include "./data_channel_info.h"
+#include "./supported_media.h"
 
 namespace semantic_sdp {
 
-struct sSupportedMedia {
-    CodecsMap                        codecs;
-    std::vector<std::string>        extensions;
-    bool                            simulcast;
-    std::vector<RTCPFeedbackInfo>     rtcpfbs;
-    bool                            rtx;
-    DataChannelInfo                    datachannel;
-};
-using SupportedMedia = std::unique_ptr<sSupportedMedia>;
-
 class CMediaInfo;
 using MediaInfo = std::unique_ptr<CMediaInfo>;
 
-using ExtensionsMap = std::unordered_map<int, std::string>;
+using ExtensionsMap = memory::HashMap<int, Atom>;
 
 /**
  * Media information (relates to a m-line in SDP)
  */
-class CMediaInfo {
+class CMediaInfo : public memory::CAllocated {
  private:
-    std::string            m_id;
+    memory::String        m_id;
     MediaType             m_type;
+    // Name of a media type the library does not model, empty otherwise
+    Atom                  m_type_name;
+    // m-line port, 0 rejects the media
+    uint16_t              m_port{9};
+    // m-line protocol, empty for the WebRTC default of the media type
+    Atom                  m_protocol;
+    // m-line formats of a media type the library does not model, as written
+    memory::String        m_formats;
     Direction            m_direction{Direction::SendRecv};
-    ExtensionsMap        m_extensions;
-    CodecsMap            m_codecs;
+    // Shared with clones until changed
+    memory::CShared<ExtensionsMap>  m_extensions;
+    memory::CShared<CodecsMap>      m_codecs;
     RIDsMap                m_rids;
-    SimulcastInfo         m_simulcast;
+    memory::CShared<SimulcastInfo>  m_simulcast;
     int                    m_bitrate{0};
-    std::string            m_control;
+    memory::String        m_control;
     DataChannelInfo        m_data_channel;
+    CCandidatesSet         m_candidates;
 
  public:
     /**
@@ -56,7 +61,7 @@ class CMediaInfo {
      * @param [in] id Media id
      * @param [in] type Media type
      */
-    CMediaInfo(const std::string& id, MediaType type)
+    CMediaInfo(std::string_view id, MediaType type)
     : m_id(id)
     , m_type(type)
     {}
@@ -66,20 +71,21 @@ class CMediaInfo {
      * @returns media info cloned object
      */
     MediaInfo Clone() const {
+        memory::COperation operation(memory::Operation::Clone);
         auto cloned = std::make_unique<CMediaInfo>(m_id, m_type);
+        cloned->CopyMediaLine(*this);
         cloned->SetDirection(m_direction);
         cloned->SetBitrate(m_bitrate);
-        for (const auto& codec_it : m_codecs)
-            cloned->AddCodec(codec_it.second->Clone());
-        for (const auto& extension_it : m_extensions)
-            cloned->AddExtension(extension_it.first, extension_it.second);
+        cloned->m_codecs = m_codecs;
+        cloned->m_extensions = m_extensions;
         for (const auto& rid_it : m_rids)
             cloned->AddRID(rid_it.second->Clone());
-        if (m_simulcast != nullptr)
-            cloned->SetSimulcast(m_simulcast->Clone());
+        cloned->m_simulcast = m_simulcast;
         cloned->SetControl(m_control);
         if (m_data_channel)
             cloned->SetDataChannel(m_data_channel->Clone());
+        for (const auto& candidate : m_candidates)
+            cloned->AddCandidate(candidate->Clone());
         return cloned;
     }
 
@@ -87,10 +93,82 @@ class CMediaInfo {
      * Get media type
      * @returns media type
      */
-    const auto& GetType() const {
+    auto GetType() const {
         return m_type;
     }
 
+    /**
+     * Get media type name as written in the m-line
+     * @returns name
+     */
+    std::string_view GetTypeName() const {
+        return m_type_name.empty() ? m_type.type_str() : m_type_name.view();
+    }
+
+    /**
+     * Set name of a media type the library does not model
+     * @param [in] name
+     */
+    void SetTypeName(Atom name) {
+        m_type_name = std::move(name);
+    }
+
+    /**
+     * Get m-line port
+     * @returns port
+     */
+    auto GetPort() const {
+        return m_port;
+    }
+
+    /**
+     * Set m-line port
+     * @param [in] port 0 to reject the media
+     */
+    void SetPort(const uint16_t port) {
+        m_port = port;
+    }
+
+    /**
+     * Check if the media is rejected, with port 0
+     * @returns boolean
+     */
+    bool IsRejected() const {
+        return m_port == 0;
+    }
+
+    /**
+     * Get m-line protocol
+     * @returns protocol, empty for the WebRTC default of the media type
+     */
+    const auto& GetProtocol() const {
+        return m_protocol;
+    }
+
+    /**
+     * Set m-line protocol
+     * @param [in] protocol
+     */
+    void SetProtocol(Atom protocol) {
+        m_protocol = std::move(protocol);
+    }
+
+    /**
+     * Get m-line formats of a media type the library does not model
+     * @returns formats separated by spaces
+     */
+    const auto& GetFormats() const {
+        return m_formats;
+    }
+
+    /**
+     * Set m-line formats of a media type the library does not model
+     * @param [in] formats formats separated by spaces
+     */
+    void SetFormats(std::string_view formats) {
+        m_formats = formats;
+    }
+
     /**
      * Get id (msid) for the media info
      * @returns msid
@@ -103,7 +181,7 @@ class CMediaInfo {
      * Set id (msid) for the media info
      * @param [in] id
      */
-    void SetId(const std::string& id) {
+    void SetId(std::string_view id) {
         m_id = id;
     }
 
@@ -112,8 +190,8 @@ class CMediaInfo {
      * @param [in] id
      * @param [in] name
      */
-    void AddExtension(const int id, const std::string& name) {
-        m_extensions.emplace(id, name);
+    void AddExtension(const int id, Atom name) {
+        m_extensions.Mutable()->emplace(id, std::move(name));
     }
 
     /**
@@ -130,7 +208,7 @@ class CMediaInfo {
      */
     void AddCodec(CodecInfo&& codec_info) {
         const auto type = codec_info->GetType();
-        m_codecs.emplace(type, std::move(codec_info));
+        m_codecs.Mutable()->emplace(type, std::move(codec_info));
     }
 
     /**
@@ -138,7 +216,7 @@ class CMediaInfo {
      * @param [in] codecs Map of codec info objecs
      */
     void SetCodecs(CodecsMap&& codecs) {
-        m_codecs = std::move(codecs);
+        m_codecs = memory::CShared<CodecsMap>(std::move(codecs));
     }
 
     /**
@@ -147,8 +225,9 @@ class CMediaInfo {
      * @returns codec info object
      */
     const CodecInfo* GetCodecForType(const int type) const {
-        const auto codec_it = m_codecs.find(type);
-        if (codec_it != m_codecs.end())
+        const auto& codecs = m_codecs.Get();
+        const auto codec_it = codecs.find(type);
+        if (codec_it != codecs.end())
             return &codec_it->second;
         return nullptr;
     }
@@ -158,11 +237,10 @@ class CMediaInfo {
      * @param [in] codec Codec name (eg: "vp8")
      * @returns codec info
      */
-    const CodecInfo* GetCodec(const std::string& codec) const {
-        const std::string codec_{to_lower_case_copy(codec)};
-        for (const auto& codec_it : m_codecs) {
+    const CodecInfo* GetCodec(std::string_view codec) const {
+        for (const auto& codec_it : m_codecs.Get()) {
             const auto& info = codec_it.second;
-            if (to_lower_case_copy(info->GetCodec()) == codec_)
+            if (iequals(info->GetCodec(), codec))
                 return &info;
         }
         return nullptr;
@@ -173,16 +251,16 @@ class CMediaInfo {
      * @param [in] codec Codec name
      * @returns boolean
      */
-    bool HasCodec(const std::string& codec) const {
+    bool HasCodec(std::string_view codec) const {
         return (GetCodec(codec) != nullptr);
     }
 
     /**
-     * Get all codecs in this media
+     * Get all codecs in this media, they may be shared with clones and must not be changed
      * @returns all codecs
      */
     const auto& GetCodecs() const {
-        return m_codecs;
+        return m_codecs.Get();
     }
 
     /**
@@ -190,7 +268,7 @@ class CMediaInfo {
      * @returns boolean
      */
     bool HasRTX() const {
-        for (const auto& codec_it : m_codecs) {
+        for (const auto& codec_it : m_codecs.Get()) {
             const auto& info = codec_it.second;
             if (info->HasRTX())
                 return true;
@@ -203,7 +281,7 @@ class CMediaInfo {
      * @returns extensions
      */
     const auto& GetExtensions() const {
-        return m_extensions;
+        return m_extensions.Get();
     }
 
     /**
@@ -219,7 +297,7 @@ class CMediaInfo {
      * @param [in] id rid value to get info for
      * @returns RID info
      */
-    const RIDInfo* GetRID(const std::string& id) const {
+    const RIDInfo* GetRID(std::string_view id) const {
         auto rid_it = m_rids.find(id);
         if (rid_it != m_rids.end())
             return &rid_it->second;
@@ -278,7 +356,7 @@ class CMediaInfo {
      * Set control attribute
      * @param [in] control
      */
-    void SetControl(const std::string& control) {
+    void SetControl(std::string_view control) {
         m_control = control;
     }
 
@@ -306,6 +384,30 @@ class CMediaInfo {
         m_data_channel = std::move(data_channel);
     }
 
+    /**
+     * Add ICE candidate gathered for this media, duplicates of known candidates are dropped
+     * @param [in] candidate
+     * @returns false if the candidate was a duplicate
+     */
+    bool AddCandidate(CandidateInfo&& candidate) {
+        return m_candidates.Insert(std::move(candidate));
+    }
+
+    /**
+     * Remove all ICE candidates of this media, as on ICE restart
+     */
+    void ClearCandidates() {
+        m_candidates.Clear();
+    }
+
+    /**
+     * Get all ICE candidates of this media
+     * @returns candidates
+     */
+    const auto& GetCandidates() const {
+        return m_candidates;
+    }
+
     /**
      * Helper usefull for creating media info answers.
      * - Will reverse the direction
@@ -314,131 +416,139 @@ class CMediaInfo {
      * @param [in] supported Supported codecs and extensions to be included on answer
      * @returns media info
      */
-    MediaInfo Answer(SupportedMedia supported) const {
-        auto answer = std::make_unique<CMediaInfo>(m_id, m_type);
+    MediaInfo Answer(const SupportedMedia& supported) const {
+        if (supported == nullptr)
+            return Reject();
+        return Answer(CSupportedMediaProfile(*supported));
+    }
 
-        if (supported != nullptr) {
-            // Set reverse direction
-            answer->SetDirection(direction::Reverse(m_direction));
-
-            const auto& codecs = supported->codecs;
-            const auto& data_channel = supported->datachannel;
-
-            if (!codecs.empty()) {
-                auto supportedCodecs = MapFromNames(codecs, supported->rtx, supported->rtcpfbs);
-
-                for (const auto& codec_it : m_codecs) {
-                    const auto& codec = codec_it.second;
-                    // Try to find a matching supported codec
-                    for (const auto& supported_it : supportedCodecs) {
-                        const auto& supported_ = supported_it.second;
-                        // Codec name must match
-                        if (!eq_case_insensitive(supported_->GetCodec(), codec->GetCodec()))
-                            continue;
-                        // If it is h264, check packetization mode
-                        if ((supported_->GetCodec() == "h264")
-                            && supported_->HasParam("packetization-mode")
-                            && (supported_->GetParam("packetization-mode")
-                                != codec->GetParam("packetization-mode", "0")))
-                            // Ignore
-                            continue;
-                        // If it is h264, check profile-level-id
-                        if ((supported_->GetCodec() == "h264")
-                            && supported_->HasParam("profile-level-id")
-                            && codec->HasParam("profile-level-id")
-                            && (supported_->GetParam("profile-level-id") != codec->GetParam("profile-level-id")))
-                            continue;
-                        // If it is multiopus, check num_streams
-                        if ((supported_->GetCodec() == "multiopus")
-                            && supported_->HasParam("num_streams")
-                            && codec->HasParam("num_streams")
-                            && (supported_->GetParam("num_streams") != codec->GetParam("num_streams")))
-                            continue;
-                        auto cloned = supported_->Clone();
-                        // Change payload type number
-                        cloned->SetType(codec->GetType());
-                        cloned->SetRTX(codec->GetRTX());
-                        // Use same number of channels
-                        cloned->SetChannels(codec->GetChannels());
-                        cloned->AddParams(codec->GetParams());
-                        answer->AddCodec(std::move(cloned));
-                        break;
-                    }
-                }
-            }
+    /**
+     * Create a media info answer rejecting this media, with port 0 and no codecs
+     * @returns media info
+     */
+    MediaInfo Reject() const {
+        memory::COperation operation(memory::Operation::Answer);
+        auto answer = std::make_unique<CMediaInfo>(m_id, m_type);
+        answer->CopyMediaLine(*this);
+        answer->SetPort(0);
+        answer->SetDirection(Direction::Inactive);
+        return answer;
+    }
 
-            // Get extension set
-            auto extensions = supported->extensions;
-            // Add audio extensions
-            for (const auto& extension_it : m_extensions) {
-                const auto& id = extension_it.first;
-                const auto& uri = extension_it.second;
-                // If is supported
-                if (std::any_of(extensions.cbegin(), extensions.cend(),
-                    [uri](const std::string& extension) { return (extension == uri); }))
-                    // Add to answer
-                    answer->AddExtension(id, uri);
+    /**
+     * Create media info answer from a precompiled profile, see Answer(const SupportedMedia&).
+     * Prefer this overload when the same capabilities answer many offers.
+     * @param [in] profile Supported media capabilities
+     * @returns media info
+     */
+    MediaInfo Answer(const CSupportedMediaProfile& profile) const {
+        if (IsRejected() || (m_type.GetType() == MediaType::Type::other))
+            return Reject();
+        memory::COperation operation(memory::Operation::Answer);
+        auto answer = std::make_unique<CMediaInfo>(m_id, m_type);
+        answer->SetProtocol(m_protocol);
+        // Set reverse direction
+        answer->SetDirection(direction::Reverse(m_direction));
+
+        for (const auto& codec_it : m_codecs.Get()) {
+            const auto& codec = codec_it.second;
+            // Try to find a matching supported codec
+            const auto* supported = profile.Match(*codec);
+            if (supported == nullptr)
+                continue;
+            auto cloned = supported->Clone();
+            // Change payload type number
+            cloned->SetType(codec->GetType());
+            cloned->SetRTX(codec->GetRTX());
+            // Use same number of channels
+            cloned->SetChannels(codec->GetChannels());
+            cloned->AddParams(*codec);
+            // Answer H.264 with the offered profile at the negotiated level
+            if (supported->GetFormatParams().profile_level_id && iequals(codec->GetCodec(), "h264")) {
+                const auto id = h264::Answer(supported->GetFormatParams(), codec->GetFormatParams());
+                std::array<char, 6> buffer;
+                if (id)
+                    cloned->AddParam("profile-level-id", h264::ToString(*id, &buffer));
             }
+            answer->AddCodec(std::move(cloned));
+        }
+        // Reject RTP media without a common codec
+        if ((m_type.GetType() != MediaType::Type::application) && answer->GetCodecs().empty())
+            return Reject();
+
+        // Add supported extensions
+        for (const auto& extension_it : m_extensions.Get()) {
+            if (profile.IsExtensionSupported(extension_it.second))
+                answer->AddExtension(extension_it.first, extension_it.second);
+        }
 
-            // If simulcast is enabled
-            if (supported->simulcast && (m_simulcast != nullptr)) {
-                // Create anser
-                auto simulcast = std::make_unique<CSimulcastInfo>();
-                // Get send streams
-                auto send = m_simulcast->GetSimulcastStreams(DirectionWay::Send);
-                if (send != nullptr) {
-                    for (const auto& streams : *send) {
-                        // Clone streams
-                        std::vector<SimulcastStreamInfo> cloned;
-                        for (const auto& stream : streams)
-                            cloned.push_back(stream->Clone());
-                        // Add alternatives in reverse order
-                        simulcast->AddSimulcastAlternativeStreams(DirectionWay::Recv, std::move(cloned));
-                    }
+        // If simulcast is enabled
+        const auto& offered_simulcast = m_simulcast.Get();
+        if (profile.IsSimulcastSupported() && (offered_simulcast != nullptr)) {
+            // Create anser
+            auto simulcast = std::make_unique<CSimulcastInfo>();
+            // Get send streams
+            auto send = offered_simulcast->GetSimulcastStreams(DirectionWay::Send);
+            if (send != nullptr) {
+                for (const auto& streams : *send) {
+                    // Clone streams
+                    SimulcastStreams cloned;
+                    for (const auto& stream : streams)
+                        cloned.push_back(stream->Clone());
+                    // Add alternatives in reverse order
+                    simulcast->AddSimulcastAlternativeStreams(DirectionWay::Recv, std::move(cloned));
                 }
-                // Get recv streams
-                auto recv = m_simulcast->GetSimulcastStreams(DirectionWay::Recv);
-                if (recv != nullptr) {
-                    for (const auto& streams : *recv) {
-                        // Clone streams
-                        std::vector<SimulcastStreamInfo> cloned;
-                        for (const auto& stream : streams)
-                            cloned.push_back(stream->Clone());
-                        // Add alternatives in reverse order
-                        simulcast->AddSimulcastAlternativeStreams(DirectionWay::Send, std::move(cloned));
-                    }
-                }
-                // Add rids
-                for (const auto& rid_it : m_rids) {
-                    // TODO(Unknown): check if formats is in supported list
-                    auto reversed = rid_it.second->Clone();
-                    reversed->SetDirection(direction_way::Reverse(rid_it.second->GetDirection()));
-                    answer->AddRID(std::move(reversed));
+            }
+            // Get recv streams
+            auto recv = offered_simulcast->GetSimulcastStreams(DirectionWay::Recv);
+            if (recv != nullptr) {
+                for (const auto& streams : *recv) {
+                    // Clone streams
+                    SimulcastStreams cloned;
+                    for (const auto& stream : streams)
+                        cloned.push_back(stream->Clone());
+                    // Add alternatives in reverse order
+                    simulcast->AddSimulcastAlternativeStreams(DirectionWay::Send, std::move(cloned));
                 }
-                answer->SetSimulcast(std::move(simulcast));
             }
-
-            // If we support datachannel
-            if ((data_channel != nullptr) && (m_data_channel != nullptr)) {
-                auto dataChannelInfo = std::make_unique<CDataChannelInfo>(
-                    m_data_channel->GetPort(),
-                    data_channel->GetMaxMessageSize() ?
-                        data_channel->GetMaxMessageSize() :
-                        data_channel->GetMaxMessageSize());
-                answer->SetDataChannel(std::move(dataChannelInfo));
+            // Add rids
+            for (const auto& rid_it : m_rids) {
+                // TODO(Unknown): check if formats is in supported list
+                auto reversed = rid_it.second->Clone();
+                reversed->SetDirection(direction_way::Reverse(rid_it.second->GetDirection()));
+                answer->AddRID(std::move(reversed));
             }
-        } else {
-            answer->SetDirection(Direction::Inactive);
+            answer->SetSimulcast(std::move(simulcast));
+        }
+
+        // If we support datachannel
+        const auto& data_channel = profile.GetDataChannel();
+        if ((data_channel != nullptr) && (m_data_channel != nullptr)) {
+            auto dataChannelInfo = std::make_unique<CDataChannelInfo>(
+                m_data_channel->GetPort(),
+                data_channel->GetMaxMessageSize());
+            answer->SetDataChannel(std::move(dataChannelInfo));
         }
         return answer;
     }
 
+    /**
+     * Copy type name, protocol, port and formats of the m-line of another media
+     * @param [in] media
+     */
+    void CopyMediaLine(const CMediaInfo& media) {
+        m_type_name = media.m_type_name;
+        m_port = media.m_port;
+        m_protocol = media.m_protocol;
+        m_formats = media.m_formats;
+    }
+
     /**
      * Get Simulcast info
      * @returns simulcast info
      */
     const auto& GetSimulcast() const {
-        return m_simulcast;
+        return m_simulcast.Get();
     }
 
     /**
@@ -446,7 +556,8 @@ class CMediaInfo {
      * @param [in] simulcast Simulcast stream info
      */
     void SetSimulcast(SimulcastInfo&& simulcast) {
-        m_simulcast = std::move(simulcast);
+        m_simulcast = (simulcast != nullptr) ? memory::CShared<SimulcastInfo>(std::move(simulcast))
+                                             : memory::CShared<SimulcastInfo>();
     }
 };
 
@@ -456,7 +567,7 @@ class CMediaInfo {
 * @param [in] supported Supported media capabilities to be included on media info
 * @returns media info
 */
-MediaInfo Create(const MediaType& type, const SupportedMedia& supported) {
+inline MediaInfo Create(const MediaType type, const SupportedMedia& supported) {
     // Create new media
     auto media_info = std::make_unique<CMediaInfo>(type.type_str(), type);
     if (supported != nullptr) {
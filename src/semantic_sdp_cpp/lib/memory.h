@@ -0,0 +1,426 @@
+// "Copyright 2024 <Oldnick85>"
+
+#pragma once
+
+#include <atomic>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <memory_resource>
+#include <new>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+#include "./allocation_stats.h"
+
+namespace semantic_sdp {
+
+namespace memory {
+
+namespace detail {
+
+/**
+ * Memory resource of the model allocations on this thread, nullptr means global heap
+ */
+inline std::pmr::memory_resource*& Current() {
+    static thread_local std::pmr::memory_resource* resource = nullptr;
+    return resource;
+}
+
+}    // namespace detail
+
+/**
+ * Get memory resource the model allocates from on this thread
+ * @returns memory resource
+ */
+inline std::pmr::memory_resource* Resource() {
+    auto* resource = detail::Current();
+    return (resource != nullptr) ? resource : std::pmr::new_delete_resource();
+}
+
+/**
+ * Route the model allocations of this thread into a memory resource while the scope is alive.
+ * Objects remember the resource they were created with, so they may be used and destroyed
+ * outside the scope, but not after the resource itself is gone. Containers move constructed
+ * from an arena container take the arena resource with them, move assignment and copies do not.
+ * Model objects held by pointer stay in the resource they were created in wherever the pointer goes.
+ */
+class CScope {
+ private:
+    std::pmr::memory_resource*  m_previous;
+
+ public:
+    /**
+     * constructor for CScope
+     * @param [in] resource memory resource for this thread
+     */
+    explicit CScope(std::pmr::memory_resource* resource)
+    : m_previous(detail::Current()) {
+        detail::Current() = (resource == std::pmr::new_delete_resource()) ? nullptr : resource;
+    }
+
+    ~CScope() {
+        detail::Current() = m_previous;
+    }
+
+    CScope(const CScope&) = delete;
+    CScope& operator=(const CScope&) = delete;
+};
+
+/**
+ * Monotonic arena holding a whole session description.
+ * Deallocation inside the arena is a no-op, all memory is given back at once on Release()
+ * or destruction.
+ */
+class CArena {
+ private:
+    std::pmr::monotonic_buffer_resource     m_resource;
+
+ public:
+    static constexpr std::size_t kDefaultSize = 16 * 1024;
+
+    /**
+     * constructor for CArena
+     * @param [in] initial_size size of the first arena block
+     */
+    explicit CArena(const std::size_t initial_size = kDefaultSize)
+    : m_resource(initial_size)
+    {}
+
+    /**
+     * constructor for CArena on caller provided storage
+     * @param [in] buffer first arena block
+     * @param [in] size size of buffer
+     */
+    CArena(void* buffer, const std::size_t size)
+    : m_resource(buffer, size)
+    {}
+
+    CArena(const CArena&) = delete;
+    CArena& operator=(const CArena&) = delete;
+
+    /**
+     * Get memory resource of the arena
+     * @returns memory resource
+     */
+    std::pmr::memory_resource* GetResource() {
+        return &m_resource;
+    }
+
+    /**
+     * Give back all memory of the arena. Objects allocated in it must not be used afterwards.
+     */
+    void Release() {
+        m_resource.release();
+    }
+
+    /**
+     * Forget an object tree without running its destructors, its memory goes away with Release().
+     * Only valid when the whole tree was built inside the arena.
+     * @param [in] object
+     */
+    template <typename T>
+    void Drop(std::unique_ptr<T>&& object) {
+        static_cast<void>(object.release());
+    }
+};
+
+/**
+ * Allocator of model containers.
+ * Default constructed instances bind to the memory resource of the current thread, so
+ * containers follow the active CScope without passing allocators around.
+ */
+template <typename T>
+class CAllocator {
+ private:
+    template <typename U>
+    friend class CAllocator;
+
+    std::pmr::memory_resource*  m_resource;
+
+ public:
+    using value_type = T;
+    using propagate_on_container_copy_assignment = std::false_type;
+    // A container keeps its resource when another is moved into it, elements of a container from another
+    // resource are moved one by one, so a heap container never ends up pointing into an arena
+    using propagate_on_container_move_assignment = std::false_type;
+    using propagate_on_container_swap = std::true_type;
+    using is_always_equal = std::false_type;
+
+    CAllocator() noexcept
+    : m_resource(detail::Current())
+    {}
+
+    /**
+     * constructor for CAllocator
+     * @param [in] resource memory resource, nullptr for global heap
+     */
+    explicit CAllocator(std::pmr::memory_resource* resource) noexcept
+    : m_resource((resource == std::pmr::new_delete_resource()) ? nullptr : resource)
+    {}
+
+    template <typename U>
+    CAllocator(const CAllocator<U>& other) noexcept    // NOLINT(runtime/explicit)
+    : m_resource(other.m_resource)
+    {}
+
+    T* allocate(const std::size_t n) {
+        if (m_resource == nullptr) {
+            detail::RecordAllocation(n * sizeof(T));
+            return std::allocator<T>().allocate(n);
+        }
+        return static_cast<T*>(m_resource->allocate(n * sizeof(T), alignof(T)));
+    }
+
+    void deallocate(T* ptr, const std::size_t n) noexcept {
+        if (m_resource == nullptr)
+            std::allocator<T>().deallocate(ptr, n);
+        else
+            m_resource->deallocate(ptr, n * sizeof(T), alignof(T));
+    }
+
+    /**
+     * Construct an element, elements that are containers themselves get the resource of this allocator
+     * @param [in] ptr storage
+     * @param [in] args constructor arguments
+     */
+    template <typename U, typename... Args>
+    void construct(U* ptr, Args&&... args) {
+        std::uninitialized_construct_using_allocator(ptr, *this, std::forward<Args>(args)...);
+    }
+
+    /**
+     * Copies of containers are placed in the resource of the current thread
+     */
+    CAllocator select_on_container_copy_construction() const noexcept {
+        return CAllocator();
+    }
+
+    /**
+     * Get memory resource of the allocator
+     * @returns memory resource
+     */
+    std::pmr::memory_resource* GetResource() const noexcept {
+        return (m_resource != nullptr) ? m_resource : std::pmr::new_delete_resource();
+    }
+
+    template <typename U>
+    bool operator==(const CAllocator<U>& other) const noexcept {
+        return m_resource == other.m_resource;
+    }
+};
+
+/**
+ * Base of the model classes, places the object itself into the resource of the current thread.
+ * The resource is stored in front of the object so it can be freed from any thread and scope.
+ */
+class CAllocated {
+ private:
+    static constexpr std::size_t kHeader = alignof(std::max_align_t);
+
+ public:
+    static void* operator new(const std::size_t size) {
+        auto* resource = detail::Current();
+        if (resource == nullptr)
+            detail::RecordAllocation(size + kHeader);
+        void* block = (resource != nullptr) ?
+            resource->allocate(size + kHeader, alignof(std::max_align_t)) :
+            ::operator new(size + kHeader);
+        *static_cast<std::pmr::memory_resource**>(block) = resource;
+        return static_cast<std::byte*>(block) + kHeader;
+    }
+
+    static void operator delete(void* ptr, const std::size_t size) noexcept {
+        if (ptr == nullptr)
+            return;
+        void* block = static_cast<std::byte*>(ptr) - kHeader;
+        auto* resource = *static_cast<std::pmr::memory_resource**>(block);
+        if (resource != nullptr)
+            resource->deallocate(block, size + kHeader, alignof(std::max_align_t));
+        else
+            ::operator delete(block, size + kHeader);
+    }
+
+    /**
+     * Get memory resource an object was placed in
+     * @param [in] object
+     * @returns memory resource, nullptr for global heap
+     */
+    static std::pmr::memory_resource* ResourceOf(const CAllocated* object) {
+        const void* block = reinterpret_cast<const std::byte*>(object) - kHeader;
+        return *static_cast<std::pmr::memory_resource* const*>(block);
+    }
+};
+
+/**
+ * Deep copy of a model value: Clone() of the value, of the object it points to or of each element
+ * @param [in] value
+ * @returns copy
+ */
+template <typename T>
+T DeepCopy(const T& value) {
+    if constexpr (requires { { value.Clone() } -> std::convertible_to<T>; }) {
+        return value.Clone();
+    } else if constexpr (requires { { value->Clone() } -> std::convertible_to<T>; }) {
+        return (value != nullptr) ? T(value->Clone()) : T();
+    } else if constexpr (requires { (*value.begin())->Clone(); }) {
+        T copy;
+        for (const auto& element : value)
+            copy.insert(copy.end(), element->Clone());
+        return copy;
+    } else {
+        return T(value);
+    }
+}
+
+/**
+ * Copy-on-write holder of a model subtree.
+ * Copies share one reference counted node and the node is copied deeply on the first mutation
+ * through a holder that is not its only owner, so copying a large subtree costs one atomic increment.
+ * Nodes are only shared within the memory resource they were placed in, a copy made in another scope
+ * is deep, so sharing never makes an object depend on an arena it was not created in.
+ * The shared value must not be changed through pointers obtained from Get().
+ */
+template <typename T>
+class CShared {
+ private:
+    struct SNode : CAllocated {
+        std::atomic<uint32_t>   refs{1};
+        T                       value;
+
+        explicit SNode(T&& v)
+        : value(std::move(v))
+        {}
+    };
+
+    SNode*  m_node{nullptr};
+
+    static SNode* Share(SNode* node) {
+        if (node == nullptr)
+            return nullptr;
+        if (CAllocated::ResourceOf(node) == detail::Current()) {
+            node->refs.fetch_add(1, std::memory_order_relaxed);
+            return node;
+        }
+        return new SNode(DeepCopy(node->value));
+    }
+
+    void Release() {
+        if ((m_node != nullptr) && (m_node->refs.fetch_sub(1, std::memory_order_acq_rel) == 1))
+            delete m_node;
+        m_node = nullptr;
+    }
+
+ public:
+    CShared() = default;
+
+    /**
+     * constructor for CShared
+     * @param [in] value
+     */
+    explicit CShared(T&& value)
+    : m_node(new SNode(std::move(value)))
+    {}
+
+    CShared(const CShared& other)
+    : m_node(Share(other.m_node))
+    {}
+
+    CShared(CShared&& other) noexcept
+    : m_node(other.m_node) {
+        other.m_node = nullptr;
+    }
+
+    CShared& operator=(const CShared& other) {
+        if (this != &other) {
+            auto* node = Share(other.m_node);
+            Release();
+            m_node = node;
+        }
+        return *this;
+    }
+
+    CShared& operator=(CShared&& other) noexcept {
+        if (this != &other) {
+            Release();
+            m_node = other.m_node;
+            other.m_node = nullptr;
+        }
+        return *this;
+    }
+
+    ~CShared() {
+        Release();
+    }
+
+    /**
+     * Get value
+     * @returns value, an empty one if nothing was set
+     */
+    const T& Get() const {
+        if (m_node == nullptr) {
+            static const T empty{};
+            return empty;
+        }
+        return m_node->value;
+    }
+
+    /**
+     * Get value for changing it, copying the node first if it is shared
+     * @returns value
+     */
+    T* Mutable() {
+        if (m_node == nullptr) {
+            m_node = new SNode(T());
+        } else if (m_node->refs.load(std::memory_order_acquire) != 1) {
+            auto* node = new SNode(DeepCopy(m_node->value));
+            Release();
+            m_node = node;
+        }
+        return &m_node->value;
+    }
+
+    /**
+     * Check if the value is shared with other holders
+     * @returns boolean
+     */
+    bool IsShared() const {
+        return (m_node != nullptr) && (m_node->refs.load(std::memory_order_acquire) > 1);
+    }
+};
+
+/**
+ * Hash of string keys allowing lookup by std::string_view
+ */
+struct SStringHash {
+    using is_transparent = void;
+
+    std::size_t operator()(std::string_view str) const noexcept {
+        return std::hash<std::string_view>{}(str);
+    }
+};
+
+using String = std::basic_string<char, std::char_traits<char>, CAllocator<char>>;
+
+template <typename T>
+using Vector = std::vector<T, CAllocator<T>>;
+
+template <typename K, typename V, typename H = std::hash<K>, typename E = std::equal_to<K>>
+using HashMap = std::unordered_map<K, V, H, E, CAllocator<std::pair<const K, V>>>;
+
+template <typename K, typename H = std::hash<K>, typename E = std::equal_to<K>>
+using HashSet = std::unordered_set<K, H, E, CAllocator<K>>;
+
+template <typename V>
+using StringMap = HashMap<String, V, SStringHash, std::equal_to<>>;
+
+}    // namespace memory
+
+}    // namespace semantic_sdp
@@ -0,0 +1,95 @@
+// "Copyright 2024 <Oldnick85>"
+
+#pragma once
+
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string_view>
+#include <utility>
+
+#include "./util.h"
+
+namespace semantic_sdp {
+
+namespace detail {
+
+/**
+ * Called when no perfect hash seed exists, not being constexpr it stops the compilation
+ */
+inline void PerfectHashSeedNotFound() {}
+
+}    // namespace detail
+
+/**
+ * Case-insensitive perfect hash map from a fixed set of names to values, built at compile time.
+ * Lookup hashes the key once, probes a single slot and confirms the match with one comparison,
+ * so it neither allocates nor walks a chain of string comparisons.
+ */
+template <typename T, std::size_t N>
+class CPerfectHash {
+ public:
+    struct SEntry {
+        std::string_view    name;
+        T                   value;
+    };
+
+ private:
+    static constexpr std::size_t    kSlots = std::bit_ceil(N * 2);
+    static constexpr uint32_t       kMaxSeed = 1U << 16;
+
+    std::array<SEntry, N>               m_entries;
+    std::array<uint8_t, kSlots>         m_slots{};    // entry index + 1, 0 for empty slot
+    uint32_t                            m_seed{0};
+
+    static_assert(N < 255, "perfect hash is meant for small keyword sets");
+
+    static constexpr uint32_t Hash(std::string_view key, const uint32_t seed) {
+        uint32_t hash = 2166136261U ^ seed;
+        for (const char c : key)
+            hash = (hash ^ static_cast<uint8_t>(to_lower_ascii(c))) * 16777619U;
+        return hash ^ (hash >> 15);
+    }
+
+    constexpr bool TrySeed(const uint32_t seed) {
+        m_slots = {};
+        for (std::size_t i = 0; i < N; ++i) {
+            auto& slot = m_slots[Hash(m_entries[i].name, seed) & (kSlots - 1)];
+            if (slot != 0)
+                return false;
+            slot = static_cast<uint8_t>(i + 1);
+        }
+        m_seed = seed;
+        return true;
+    }
+
+ public:
+    /**
+     * constructor for CPerfectHash, searches a seed without collisions
+     * @param [in] entries names and values
+     */
+    constexpr explicit CPerfectHash(const std::array<SEntry, N>& entries)
+    : m_entries(entries) {
+        for (uint32_t seed = 0; seed < kMaxSeed; ++seed) {
+            if (TrySeed(seed))
+                return;
+        }
+        detail::PerfectHashSeedNotFound();
+    }
+
+    /**
+     * Find value by name
+     * @param [in] name (case insensitive)
+     * @returns value or nullopt if the name is unknown
+     */
+    constexpr std::optional<T> Find(std::string_view name) const {
+        const auto slot = m_slots[Hash(name, m_seed) & (kSlots - 1)];
+        if ((slot == 0) || !iequals(m_entries[slot - 1].name, name))
+            return std::nullopt;
+        return m_entries[slot - 1].value;
+    }
+};
+
+}    // namespace semantic_sdp
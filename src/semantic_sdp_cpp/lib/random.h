@@ -0,0 +1,194 @@
+// "Copyright 2024 <Oldnick85>"
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+#if defined(__linux__)
+#include <pthread.h>
+#include <sys/random.h>
+#define SEMANTIC_SDP_RANDOM_GETRANDOM
+#elif defined(__APPLE__) || defined(__FreeBSD__) || defined(__OpenBSD__) || defined(__NetBSD__)
+#include <pthread.h>
+#include <stdlib.h>
+#define SEMANTIC_SDP_RANDOM_ARC4RANDOM
+#else
+#include <random>
+#endif
+
+namespace semantic_sdp {
+
+namespace random {
+
+namespace detail {
+
+/**
+ * Fill buffer from the operating system CSPRNG
+ * @param [out] out buffer
+ * @param [in] size number of bytes
+ * @returns false if the system source failed
+ */
+inline bool SystemFill(uint8_t* out, std::size_t size) {
+#if defined(SEMANTIC_SDP_RANDOM_GETRANDOM)
+    while (size > 0) {
+        const auto res = getrandom(out, size, 0);
+        if (res < 0) {
+            if (errno == EINTR)
+                continue;
+            return false;
+        }
+        out += res;
+        size -= static_cast<std::size_t>(res);
+    }
+    return true;
+#elif defined(SEMANTIC_SDP_RANDOM_ARC4RANDOM)
+    arc4random_buf(out, size);
+    return true;
+#else
+    std::random_device dev;
+    for (std::size_t i = 0; i < size; ++i)
+        out[i] = static_cast<uint8_t>(dev());
+    return true;
+#endif
+}
+
+/**
+ * Counter increased in the child process after fork, so pools never hand out the bytes the parent also has
+ * @returns counter
+ */
+inline std::atomic<uint32_t>& ForkGeneration() {
+    static std::atomic<uint32_t> generation{0};
+#if defined(SEMANTIC_SDP_RANDOM_GETRANDOM) || defined(SEMANTIC_SDP_RANDOM_ARC4RANDOM)
+    static const bool registered = (pthread_atfork(nullptr, nullptr, [] {
+        generation.fetch_add(1, std::memory_order_relaxed);
+    }) == 0);
+    static_cast<void>(registered);
+#endif
+    return generation;
+}
+
+}    // namespace detail
+
+/**
+ * Buffered random source, refilled from the operating system CSPRNG in blocks
+ * so that small requests do not cost a system call each.
+ * Not thread safe, every thread uses its own pool (see ThreadPool()).
+ */
+class CRandomPool {
+ public:
+    static constexpr std::size_t kBufferSize = 512;
+
+ private:
+    std::array<uint8_t, kBufferSize>    m_buffer;
+    std::size_t                         m_pos{kBufferSize};
+    uint32_t                            m_generation{0};
+
+    bool Refill() {
+        if (!detail::SystemFill(m_buffer.data(), m_buffer.size()))
+            return false;
+        m_pos = 0;
+        return true;
+    }
+
+ public:
+    CRandomPool() = default;
+    CRandomPool(const CRandomPool&) = delete;
+    CRandomPool& operator=(const CRandomPool&) = delete;
+
+    ~CRandomPool() {
+        // Do not leave unused key material behind
+        volatile uint8_t* buffer = m_buffer.data();
+        for (std::size_t i = 0; i < kBufferSize; ++i)
+            buffer[i] = 0;
+    }
+
+    /**
+     * Fill buffer with random bytes
+     * @param [out] out buffer
+     * @param [in] size number of bytes
+     * @returns false if the system source failed
+     */
+    bool Fill(uint8_t* out, std::size_t size) {
+        const auto generation = detail::ForkGeneration().load(std::memory_order_relaxed);
+        if (generation != m_generation) {
+            m_generation = generation;
+            m_pos = kBufferSize;
+        }
+        // Large requests bypass the buffer
+        if (size >= kBufferSize / 2)
+            return detail::SystemFill(out, size);
+        while (size > 0) {
+            if ((m_pos == kBufferSize) && !Refill())
+                return false;
+            const auto chunk = std::min(size, kBufferSize - m_pos);
+            std::memcpy(out, m_buffer.data() + m_pos, chunk);
+            // Bytes are handed out once
+            std::memset(m_buffer.data() + m_pos, 0, chunk);
+            m_pos += chunk;
+            out += chunk;
+            size -= chunk;
+        }
+        return true;
+    }
+};
+
+/**
+ * Get random pool of the calling thread
+ * @returns pool
+ */
+inline CRandomPool& ThreadPool() {
+    thread_local CRandomPool pool;
+    return pool;
+}
+
+/**
+ * Fill buffer with random bytes from the thread pool
+ * @param [out] out buffer
+ * @param [in] size number of bytes
+ * @returns false if the system source failed
+ */
+inline bool Fill(uint8_t* out, const std::size_t size) {
+    return ThreadPool().Fill(out, size);
+}
+
+/**
+ * Get random bytes, e.g. a nonce
+ * @param [out] bytes random bytes
+ * @returns false if the system source failed
+ */
+template <std::size_t N>
+inline bool Fill(std::array<uint8_t, N>* bytes) {
+    return Fill(bytes->data(), N);
+}
+
+/**
+ * Get random 32 bit value
+ * @param [out] value
+ * @returns false if the system source failed
+ */
+inline bool Uint32(uint32_t* value) {
+    return Fill(reinterpret_cast<uint8_t*>(value), sizeof(*value));
+}
+
+/**
+ * Get random SSRC, zero is never returned
+ * @returns SSRC or zero if the system source failed
+ */
+inline uint32_t SSRC() {
+    uint32_t ssrc = 0;
+    while (ssrc == 0) {
+        if (!Uint32(&ssrc))
+            return 0;
+    }
+    return ssrc;
+}
+
+}    // namespace random
+
+}    // namespace semantic_sdp
@@ -3,11 +3,12 @@
 #pragma once
 
 #include <string>
+#include <string_view>
 #include <memory>
-#include <vector>
-#include <unordered_map>
+#include <span>
 
 #include "./util.h"
+#include "./memory.h"
 #include "./direction_way.h"
 
 namespace semantic_sdp {
@@ -18,11 +19,11 @@ using RIDInfo = std::unique_ptr<CRIDInfo>;
 /**
  * RID info
  */
-class CRIDInfo {
+class CRIDInfo : public memory::CAllocated {
  private:
-    std::string         m_id;
+    memory::String      m_id;
     DirectionWay        m_direction;
-    std::vector<int>    m_formats;
+    memory::Vector<int> m_formats;
     ParamsMap           m_params;
 
  public:
@@ -31,7 +32,7 @@ class CRIDInfo {
      * @param [in] id rid value
      * @param [in] direction direction
      */
-    CRIDInfo(const std::string& id, const DirectionWay direction)
+    CRIDInfo(std::string_view id, const DirectionWay direction)
     : m_id(id)
     , m_direction(direction)
     {}
@@ -41,6 +42,7 @@ class CRIDInfo {
      * @returns RID info
      */
     RIDInfo Clone() const {
+        memory::COperation operation(memory::Operation::Clone);
         auto cloned = std::make_unique<CRIDInfo>(m_id, m_direction);
         cloned->SetFormats(m_formats);
         cloned->SetParams(m_params);
@@ -83,8 +85,8 @@ class CRIDInfo {
      * Set pt formats for rid
      * @param {Array<Number>} formats
      */
-    void SetFormats(const std::vector<int>& formats) {
-        m_formats = formats;
+    void SetFormats(std::span<const int> formats) {
+        m_formats.assign(formats.begin(), formats.end());
     }
 
     /**
@@ -108,11 +110,11 @@ class CRIDInfo {
      * @param [in] id
      * @param [in] param
      */
-    void AddParam(const std::string& id, const std::string& param) {
+    void AddParam(std::string_view id, std::string_view param) {
         m_params.emplace(id, param);
     }
 };
 
-using RIDsMap = std::unordered_map<std::string, RIDInfo>;
+using RIDsMap = memory::StringMap<RIDInfo>;
 
 }    // namespace semantic_sdp
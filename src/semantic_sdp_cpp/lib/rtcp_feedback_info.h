@@ -2,40 +2,159 @@
 
 #pragma once
 
-#include <string>
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <initializer_list>
+#include <iterator>
 #include <memory>
-#include <vector>
+#include <string>
+#include <string_view>
+#include <utility>
+
+#include "./atom.h"
+#include "./memory.h"
+#include "./util.h"
 
 namespace semantic_sdp {
 
 /**
- * RTCP Feedback parameter
+ * RTCP feedback types with a slot in CRTCPFeedbackSet
+ */
+enum class RTCPFeedbackType : uint8_t {
+    Nack,
+    NackPli,
+    NackSli,
+    NackRpsi,
+    CcmFir,
+    CcmTmmbr,
+    CcmTstr,
+    CcmVbcm,
+    GoogRemb,
+    TransportCC,
+    Other,
+};
+
+namespace rtcp_feedback {
+
+namespace detail {
+
+struct SKnown {
+    std::string_view    id;
+    std::string_view    params;
+};
+
+inline constexpr std::array<SKnown, static_cast<std::size_t>(RTCPFeedbackType::Other)> kKnown{{
+    {"nack",            ""},
+    {"nack",            "pli"},
+    {"nack",            "sli"},
+    {"nack",            "rpsi"},
+    {"ccm",             "fir"},
+    {"ccm",             "tmmbr"},
+    {"ccm",             "tstr"},
+    {"ccm",             "vbcm"},
+    {"goog-remb",       ""},
+    {"transport-cc",    ""},
+}};
+
+}    // namespace detail
+
+}    // namespace rtcp_feedback
+
+/**
+ * RTCP Feedback parameter, a value compared and hashed by its id and parameters
  */
 class CRTCPFeedbackInfo;
 using RTCPFeedbackInfo = std::unique_ptr<CRTCPFeedbackInfo>;
 
-class CRTCPFeedbackInfo {
+class CRTCPFeedbackInfo : public memory::CAllocated {
  private:
-    std::string                 m_id;
-    std::vector<std::string>    m_params;
+    Atom                m_id;
+    // Parameters separated by single spaces
+    Atom                m_params;
+    RTCPFeedbackType    m_type{RTCPFeedbackType::Other};
+
+    CRTCPFeedbackInfo(Atom id, Atom params, const RTCPFeedbackType type)
+        : m_id(std::move(id))
+        , m_params(std::move(params))
+        , m_type(type)
+    {}
+
+    void Classify();
 
  public:
+    /**
+     * constructor for CRTCPFeedbackInfo
+     * @param [in] id RTCP feedback id
+     */
+    explicit CRTCPFeedbackInfo(Atom id)
+        : m_id(std::move(id)) {
+        Classify();
+    }
+
     /**
      * constructor for CRTCPFeedbackInfo
      * @param [in] id RTCP feedback id
      * @param [in] params RTCP feedback params
      */
-    CRTCPFeedbackInfo(const std::string& id, const std::vector<std::string>& params)
-        : m_id(id)
-        , m_params(params)
-    {}
+    template <typename Params = std::initializer_list<std::string_view>>
+    CRTCPFeedbackInfo(Atom id, const Params& params)
+        : m_id(std::move(id)) {
+        for (const auto& param : params)
+            AddParam(param);
+        Classify();
+    }
+
+    /**
+     * Parse the value of an rtcp-fb attribute after the payload type
+     * @param [in] value "<id> [<params>]"
+     * @returns RTCP feedback info
+     */
+    static CRTCPFeedbackInfo Parse(std::string_view value) {
+        const auto id = next_token(&value, ' ');
+        value = trim_view(value);
+        if (value.find("  ") == std::string_view::npos)
+            return CRTCPFeedbackInfo(id, Atom(value), RTCPFeedbackType::Other).Classified();
+        CRTCPFeedbackInfo rtcpfb{Atom(id)};
+        for (const auto param : split_view(value, ' ')) {
+            if (!param.empty())
+                rtcpfb.AddParam(param);
+        }
+        return rtcpfb;
+    }
+
+    /**
+     * Get well known feedback of a type
+     * @param [in] type known type, not Other
+     * @returns RTCP feedback info
+     */
+    static const CRTCPFeedbackInfo& Known(const RTCPFeedbackType type);
 
     /**
      * Create a clone of this RTCPFeedbackParameter info object
      * @returns RTCP feedback info
      */
     RTCPFeedbackInfo Clone() const {
-        return std::make_unique<CRTCPFeedbackInfo>(m_id, m_params);
+        memory::COperation operation(memory::Operation::Clone);
+        return std::make_unique<CRTCPFeedbackInfo>(*this);
+    }
+
+    /**
+     * Add rtcp feedback parameter
+     * @param [in] param
+     */
+    void AddParam(std::string_view param) {
+        if (m_params.empty()) {
+            m_params = Atom(param);
+        } else {
+            std::string joined(m_params.view());
+            joined += ' ';
+            joined += param;
+            m_params = Atom(joined);
+        }
+        Classify();
     }
 
     /**
@@ -48,11 +167,245 @@ class CRTCPFeedbackInfo {
 
     /**
      * Get codec  rtcp feedback parameters
-     * @returns parameters
+     * @returns range of parameters
      */
-    const auto& GetParams() const {
+    auto GetParams() const {
+        return split_view(m_params.view(), ' ');
+    }
+
+    /**
+     * Get codec rtcp feedback parameters as written in the attribute
+     * @returns parameters separated by spaces
+     */
+    const auto& GetParamsText() const {
         return m_params;
     }
+
+    /**
+     * Get feedback type
+     * @returns type, Other if it is not a well known one
+     */
+    auto GetType() const {
+        return m_type;
+    }
+
+    /**
+     * Get hash of id and parameters
+     * @returns hash
+     */
+    std::size_t GetHash() const {
+        return hash_combine(m_id.Hash(), m_params.Hash());
+    }
+
+    bool operator==(const CRTCPFeedbackInfo& other) const {
+        return (m_id == other.m_id) && (m_params == other.m_params);
+    }
+
+ private:
+    CRTCPFeedbackInfo Classified() && {
+        Classify();
+        return std::move(*this);
+    }
 };
 
+/**
+ * Set of RTCP feedbacks of a codec.
+ * Well known feedbacks are bits of a mask, others are kept in a short list, so sets made only of
+ * well known feedbacks are copied, merged and compared without allocating.
+ * Iteration gives the well known feedbacks in RTCPFeedbackType order, then the others as added.
+ */
+class CRTCPFeedbackSet {
+ private:
+    uint16_t                                m_known{0};
+    memory::Vector<CRTCPFeedbackInfo>       m_other;
+
+    static constexpr std::size_t kKnown = static_cast<std::size_t>(RTCPFeedbackType::Other);
+
+    static uint16_t Bit(const RTCPFeedbackType type) {
+        return static_cast<uint16_t>(1U << static_cast<unsigned>(type));
+    }
+
+ public:
+    class CIterator {
+     private:
+        const CRTCPFeedbackSet*     m_set{nullptr};
+        std::size_t                 m_pos{0};
+
+        void Skip() {
+            while ((m_pos < kKnown) && ((m_set->m_known & (1U << m_pos)) == 0))
+                ++m_pos;
+        }
+
+     public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = CRTCPFeedbackInfo;
+        using difference_type = std::ptrdiff_t;
+        using pointer = const CRTCPFeedbackInfo*;
+        using reference = const CRTCPFeedbackInfo&;
+
+        CIterator() = default;
+
+        CIterator(const CRTCPFeedbackSet* set, const std::size_t pos)
+        : m_set(set), m_pos(pos) {
+            Skip();
+        }
+
+        reference operator*() const {
+            if (m_pos < kKnown)
+                return CRTCPFeedbackInfo::Known(static_cast<RTCPFeedbackType>(m_pos));
+            return m_set->m_other[m_pos - kKnown];
+        }
+
+        pointer operator->() const {
+            return &**this;
+        }
+
+        CIterator& operator++() {
+            ++m_pos;
+            Skip();
+            return *this;
+        }
+
+        CIterator operator++(int) {
+            auto it = *this;
+            ++*this;
+            return it;
+        }
+
+        bool operator==(const CIterator& other) const {
+            return m_pos == other.m_pos;
+        }
+    };
+
+    /**
+     * Add feedback unless it is already in the set
+     * @param [in] rtcpfb
+     * @returns false if the feedback was already in the set
+     */
+    bool Insert(const CRTCPFeedbackInfo& rtcpfb) {
+        if (rtcpfb.GetType() != RTCPFeedbackType::Other) {
+            const auto bit = Bit(rtcpfb.GetType());
+            if ((m_known & bit) != 0)
+                return false;
+            m_known |= bit;
+            return true;
+        }
+        if (Contains(rtcpfb))
+            return false;
+        m_other.push_back(rtcpfb);
+        return true;
+    }
+
+    /**
+     * Check if the set has a feedback
+     * @param [in] rtcpfb
+     * @returns boolean
+     */
+    bool Contains(const CRTCPFeedbackInfo& rtcpfb) const {
+        if (rtcpfb.GetType() != RTCPFeedbackType::Other)
+            return Contains(rtcpfb.GetType());
+        for (const auto& other : m_other) {
+            if (other == rtcpfb)
+                return true;
+        }
+        return false;
+    }
+
+    /**
+     * Check if the set has a well known feedback
+     * @param [in] type
+     * @returns boolean
+     */
+    bool Contains(const RTCPFeedbackType type) const {
+        return (type != RTCPFeedbackType::Other) && ((m_known & Bit(type)) != 0);
+    }
+
+    /**
+     * Add all feedbacks of another set
+     * @param [in] other
+     */
+    void Merge(const CRTCPFeedbackSet& other) {
+        m_known |= other.m_known;
+        for (const auto& rtcpfb : other.m_other)
+            Insert(rtcpfb);
+    }
+
+    std::size_t size() const {
+        return static_cast<std::size_t>(std::popcount(m_known)) + m_other.size();
+    }
+
+    bool empty() const {
+        return (m_known == 0) && m_other.empty();
+    }
+
+    void clear() {
+        m_known = 0;
+        m_other.clear();
+    }
+
+    CIterator begin() const {
+        return CIterator(this, 0);
+    }
+
+    CIterator end() const {
+        return CIterator(this, kKnown + m_other.size());
+    }
+
+    bool operator==(const CRTCPFeedbackSet& other) const {
+        if ((m_known != other.m_known) || (m_other.size() != other.m_other.size()))
+            return false;
+        for (const auto& rtcpfb : m_other) {
+            if (!other.Contains(rtcpfb))
+                return false;
+        }
+        return true;
+    }
+};
+
+namespace rtcp_feedback {
+
+namespace detail {
+
+using KnownTable = std::array<CRTCPFeedbackInfo, kKnown.size()>;
+
+template <std::size_t... I>
+KnownTable MakeKnown(std::index_sequence<I...>) {
+    return KnownTable{CRTCPFeedbackInfo(kKnown[I].id, {kKnown[I].params})...};
+}
+
+inline const KnownTable& Known() {
+    static const KnownTable known = [] {
+        // Interned texts outlive any arena, the table must not be placed in one
+        memory::CScope scope(nullptr);
+        return MakeKnown(std::make_index_sequence<kKnown.size()>());
+    }();
+    return known;
+}
+
+}    // namespace detail
+
+}    // namespace rtcp_feedback
+
+inline const CRTCPFeedbackInfo& CRTCPFeedbackInfo::Known(const RTCPFeedbackType type) {
+    return rtcp_feedback::detail::Known()[static_cast<std::size_t>(type)];
+}
+
+inline void CRTCPFeedbackInfo::Classify() {
+    m_type = RTCPFeedbackType::Other;
+    for (std::size_t i = 0; i < rtcp_feedback::detail::kKnown.size(); ++i) {
+        const auto& known = rtcp_feedback::detail::kKnown[i];
+        if ((m_id == known.id) && (m_params == known.params)) {
+            m_type = static_cast<RTCPFeedbackType>(i);
+            return;
+        }
+    }
+}
+
 }    // namespace semantic_sdp
+
+template <>
+struct std::hash<semantic_sdp::CRTCPFeedbackInfo> {
+    std::size_t operator()(const semantic_sdp::CRTCPFeedbackInfo& rtcpfb) const noexcept {
+        return rtcpfb.GetHash();
+    }
+};
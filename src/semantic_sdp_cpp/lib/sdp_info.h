@@ -0,0 +1,361 @@
+// "Copyright 2024 <Oldnick85>"
+
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <memory>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "./util.h"
+#include "./memory.h"
+#include "./media_info.h"
+#include "./supported_media.h"
+#include "./stream_info.h"
+#include "./ice_info.h"
+#include "./dtls_info.h"
+#include "./crypto_info.h"
+#include "./worker_pool.h"
+
+namespace semantic_sdp {
+
+class CSDPInfo;
+using SDPInfo = std::unique_ptr<CSDPInfo>;
+
+/**
+ * Session description information (the whole SDP)
+ */
+class CSDPInfo : public memory::CAllocated {
+ public:
+    static constexpr std::size_t kMinMediasPerThread = 8;
+
+    using Medias = memory::Vector<MediaInfo>;
+    using Streams = memory::StringMap<StreamInfo>;
+
+ private:
+    int         m_version{1};
+    uint64_t    m_session_id{0};
+    Medias      m_medias;
+    Streams     m_streams;
+    ICEInfo     m_ice;
+    DTLSInfo    m_dtls;
+    CryptoInfo  m_crypto;
+    CSSRCIndex  m_ssrc_index;
+
+    void UnindexStream(CStreamInfo* stream) {
+        for (const auto& track_it : stream->GetTracks())
+            m_ssrc_index.RemoveTrack(*track_it.second);
+        stream->SetSSRCIndex(nullptr);
+    }
+
+    void AttachStreams() {
+        for (const auto& stream_it : m_streams)
+            stream_it.second->SetSSRCIndex(&m_ssrc_index);
+    }
+
+ public:
+    /**
+     * constructor for CSDPInfo
+     * @param [in] version SDP version attribute
+     */
+    explicit CSDPInfo(const int version = 1)
+    : m_version(version)
+    {}
+
+    CSDPInfo(const CSDPInfo&) = delete;
+    CSDPInfo& operator=(const CSDPInfo&) = delete;
+
+    /**
+     * Move constructor, the streams are attached to the SSRC index of the new object
+     * @param [in] other
+     */
+    CSDPInfo(CSDPInfo&& other) noexcept
+    : m_version(other.m_version)
+    , m_session_id(other.m_session_id)
+    , m_medias(std::move(other.m_medias))
+    , m_streams(std::move(other.m_streams))
+    , m_ice(std::move(other.m_ice))
+    , m_dtls(std::move(other.m_dtls))
+    , m_crypto(std::move(other.m_crypto))
+    , m_ssrc_index(std::move(other.m_ssrc_index)) {
+        other.m_ssrc_index.clear();
+        AttachStreams();
+    }
+
+    /**
+     * Move assignment, the streams are attached to the SSRC index of this object
+     * @param [in] other
+     * @returns this
+     */
+    CSDPInfo& operator=(CSDPInfo&& other) noexcept {
+        if (this == &other)
+            return *this;
+        m_version = other.m_version;
+        m_session_id = other.m_session_id;
+        m_medias = std::move(other.m_medias);
+        m_streams = std::move(other.m_streams);
+        m_ice = std::move(other.m_ice);
+        m_dtls = std::move(other.m_dtls);
+        m_crypto = std::move(other.m_crypto);
+        m_ssrc_index = std::move(other.m_ssrc_index);
+        other.m_ssrc_index.clear();
+        AttachStreams();
+        return *this;
+    }
+
+    /**
+     * Clone SDPInfo object
+     * @returns cloned SDP info
+     */
+    SDPInfo Clone() const {
+        memory::COperation operation(memory::Operation::Clone);
+        auto cloned = std::make_unique<CSDPInfo>(m_version);
+        cloned->SetSessionId(m_session_id);
+        for (const auto& media : m_medias)
+            cloned->AddMedia(media->Clone());
+        for (const auto& stream_it : m_streams)
+            cloned->AddStream(stream_it.second->Clone());
+        if (m_ice != nullptr)
+            cloned->SetICE(m_ice->Clone());
+        if (m_dtls != nullptr)
+            cloned->SetDTLS(m_dtls->Clone());
+        if (m_crypto != nullptr)
+            cloned->SetCrypto(m_crypto->Clone());
+        return cloned;
+    }
+
+    /**
+     * Answer all media descriptions of this offer in one pass.
+     * The answer has the m-lines in the offer order, streams, ICE and DTLS info are left
+     * for the caller to set.
+     * Independent m-lines may be answered on several threads of the process worker pool. Threads are
+     * only used when the model allocates from the global heap, inside a memory::CScope the answer is
+     * built on the calling thread as scoped resources are not synchronized.
+     * An exception thrown while answering an m-line is rethrown here.
+     * @param [in] profiles Supported capabilities per media type
+     * @param [in] threads Maximum number of threads, 0 for hardware concurrency
+     * @returns SDP answer
+     */
+    SDPInfo Answer(const sSupportedProfiles& profiles, unsigned threads = 1) const {
+        memory::COperation operation(memory::Operation::Answer);
+        auto answer = std::make_unique<CSDPInfo>(m_version);
+        Medias medias(m_medias.size());
+        const auto answer_media = [this, &profiles, &medias](const std::size_t i) {
+            const auto& media = m_medias[i];
+            const auto* profile = profiles.Get(media->GetType());
+            medias[i] = (profile != nullptr) ? media->Answer(*profile) : media->Answer(SupportedMedia());
+        };
+
+        if (threads == 0) {
+            // Querying the system is not free, ask once
+            static const unsigned hardware_threads = std::max(1U, std::thread::hardware_concurrency());
+            threads = hardware_threads;
+        }
+        // Starting a thread costs about as much as answering a few m-lines
+        threads = std::min<std::size_t>(threads, m_medias.size() / kMinMediasPerThread);
+        if ((threads <= 1) || (memory::detail::Current() != nullptr)) {
+            for (std::size_t i = 0; i < m_medias.size(); ++i)
+                answer_media(i);
+        } else {
+            CWorkerPool::Instance().ParallelFor(m_medias.size(), threads, answer_media);
+        }
+
+        for (auto& media : medias)
+            answer->AddMedia(std::move(media));
+        return answer;
+    }
+
+    /**
+     * Get SDP version
+     * @returns version
+     */
+    auto GetVersion() const {
+        return m_version;
+    }
+
+    /**
+     * Set SDP version
+     * @param [in] version
+     */
+    void SetVersion(const int version) {
+        m_version = version;
+    }
+
+    /**
+     * Get origin session id
+     * @returns session id
+     */
+    auto GetSessionId() const {
+        return m_session_id;
+    }
+
+    /**
+     * Set origin session id
+     * @param [in] session_id
+     */
+    void SetSessionId(const uint64_t session_id) {
+        m_session_id = session_id;
+    }
+
+    /**
+     * Add a media description (m-line) to the SDP
+     * @param [in] media
+     */
+    void AddMedia(MediaInfo&& media) {
+        m_medias.push_back(std::move(media));
+    }
+
+    /**
+     * Get all media descriptions in the order of the m-lines
+     * @returns medias
+     */
+    const auto& GetMedias() const {
+        return m_medias;
+    }
+
+    /**
+     * Get media description by its mid
+     * @param [in] mid
+     * @returns media info
+     */
+    const MediaInfo* GetMediaById(std::string_view mid) const {
+        for (const auto& media : m_medias) {
+            if (media->GetId() == mid)
+                return &media;
+        }
+        return nullptr;
+    }
+
+    /**
+     * Get first media description of the requested type
+     * @param [in] type Media type
+     * @returns media info
+     */
+    const MediaInfo* GetMedia(const MediaType type) const {
+        for (const auto& media : m_medias) {
+            if (media->GetType() == type)
+                return &media;
+        }
+        return nullptr;
+    }
+
+    /**
+     * Add media stream, replacing the stream with the same id, and index the SSRCs of its tracks
+     * @param [in] stream
+     */
+    void AddStream(StreamInfo&& stream) {
+        const auto stream_it = m_streams.find(stream->GetId());
+        if (stream_it != m_streams.end())
+            UnindexStream(stream_it->second.get());
+        stream->SetSSRCIndex(&m_ssrc_index);
+        for (const auto& track_it : stream->GetTracks())
+            m_ssrc_index.AddTrack(*stream, *track_it.second);
+        if (stream_it != m_streams.end())
+            stream_it->second = std::move(stream);
+        else
+            m_streams.emplace(stream->GetId(), std::move(stream));
+    }
+
+    /**
+     * Get media stream by id
+     * @param [in] id
+     * @returns stream info
+     */
+    const StreamInfo* GetStream(std::string_view id) const {
+        const auto stream_it = m_streams.find(id);
+        if (stream_it != m_streams.end())
+            return &stream_it->second;
+        return nullptr;
+    }
+
+    /**
+     * Get all media streams
+     * @returns streams
+     */
+    const auto& GetStreams() const {
+        return m_streams;
+    }
+
+    /**
+     * Remove media stream
+     * @param [in] id
+     */
+    void RemoveStream(std::string_view id) {
+        const auto stream_it = m_streams.find(id);
+        if (stream_it == m_streams.end())
+            return;
+        UnindexStream(stream_it->second.get());
+        m_streams.erase(stream_it);
+    }
+
+    /**
+     * Find the stream, track and source group an SSRC belongs to
+     * @param [in] ssrc
+     * @returns index entry or nullptr if no track of the session has the SSRC
+     */
+    const CSSRCIndex::SEntry* FindSSRC(const uint32_t ssrc) const {
+        return m_ssrc_index.Find(ssrc);
+    }
+
+    /**
+     * Get the SSRC index of all tracks of all streams
+     * @returns index
+     */
+    const auto& GetSSRCIndex() const {
+        return m_ssrc_index;
+    }
+
+    /**
+     * Get peer ICE info
+     * @returns ICE info
+     */
+    const auto& GetICE() const {
+        return m_ice;
+    }
+
+    /**
+     * Set peer ICE info
+     * @param [in] ice
+     */
+    void SetICE(ICEInfo&& ice) {
+        m_ice = std::move(ice);
+    }
+
+    /**
+     * Get peer DTLS info
+     * @returns DTLS info
+     */
+    const auto& GetDTLS() const {
+        return m_dtls;
+    }
+
+    /**
+     * Set peer DTLS info
+     * @param [in] dtls
+     */
+    void SetDTLS(DTLSInfo&& dtls) {
+        m_dtls = std::move(dtls);
+    }
+
+    /**
+     * Get SDES crypto info
+     * @returns crypto info
+     */
+    const auto& GetCrypto() const {
+        return m_crypto;
+    }
+
+    /**
+     * Set SDES crypto info
+     * @param [in] crypto
+     */
+    void SetCrypto(CryptoInfo&& crypto) {
+        m_crypto = std::move(crypto);
+    }
+};
+
+}    // namespace semantic_sdp
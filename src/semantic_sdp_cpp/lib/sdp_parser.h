@@ -0,0 +1,851 @@
+// "Copyright 2024 <Oldnick85>"
+
+#pragma once
+
+#include <algorithm>
+#include <bit>
+#include <charconv>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <memory>
+#include <utility>
+
+#include "./util.h"
+#include "./memory.h"
+#include "./direction.h"
+#include "./direction_way.h"
+#include "./setup.h"
+#include "./line_scanner.h"
+#include "./candidate_info.h"
+#include "./codec_info.h"
+#include "./crypto_info.h"
+#include "./data_channel_info.h"
+#include "./dtls_info.h"
+#include "./ice_info.h"
+#include "./rid_info.h"
+#include "./rtcp_feedback_info.h"
+#include "./simulcast_info.h"
+#include "./source_group_info.h"
+#include "./track_info.h"
+#include "./media_info.h"
+#include "./stream_info.h"
+#include "./sdp_info.h"
+
+namespace semantic_sdp {
+
+namespace sdp {
+
+namespace detail {
+
+/**
+ * Parse the whole view as a decimal number
+ * @param [in] str
+ * @param [out] value
+ * @returns true if the whole view was a number
+ */
+template <typename T>
+inline bool to_number(std::string_view str, T* value) {
+    if constexpr (std::is_integral_v<T> && (sizeof(T) <= 4)) {
+        // Numbers in SDP are short unsigned decimals, accumulate them in 64 bits and range check once
+        const bool negative = std::is_signed_v<T> && !str.empty() && (str.front() == '-');
+        if (negative)
+            str.remove_prefix(1);
+        if (str.empty() || (str.size() > 19))
+            return false;
+        uint64_t number = 0;
+        for (const char c : str) {
+            const auto digit = static_cast<unsigned>(c - '0');
+            if (digit > 9)
+                return false;
+            number = number * 10 + digit;
+        }
+        const auto limit = static_cast<uint64_t>(std::numeric_limits<T>::max()) + (negative ? 1 : 0);
+        if (number > limit)
+            return false;
+        *value = negative ? static_cast<T>(-static_cast<int64_t>(number)) : static_cast<T>(number);
+        return true;
+    } else {
+        const auto* end = str.data() + str.size();
+        const auto res = std::from_chars(str.data(), end, *value);
+        return (res.ec == std::errc()) && (res.ptr == end);
+    }
+}
+
+/**
+ * Parse ICE candidate attribute value
+ * "<foundation> <component> <transport> <priority> <address> <port> typ <type> [raddr <addr>] [rport <port>] ..."
+ * @param [in] value attribute value after "candidate:"
+ * @returns candidate info or nullptr if malformed
+ */
+inline CandidateInfo ParseCandidateValue(std::string_view value) {
+    const auto foundation = next_token(&value, ' ');
+    const auto component_str = next_token(&value, ' ');
+    const auto transport = candidate_transport::ByValue(next_token(&value, ' '));
+    const auto priority_str = next_token(&value, ' ');
+    const auto address = next_token(&value, ' ');
+    const auto port_str = next_token(&value, ' ');
+    if (next_token(&value, ' ') != "typ")
+        return nullptr;
+    const auto type = candidate_type::ByValue(next_token(&value, ' '));
+    if ((transport == CandidateTransport::Unknown) || (type == CandidateType::Unknown) || address.empty())
+        return nullptr;
+
+    uint16_t component = 0;
+    uint32_t priority = 0;
+    uint16_t port = 0;
+    if (!to_number(component_str, &component) || !to_number(priority_str, &priority) || !to_number(port_str, &port))
+        return nullptr;
+
+    IPAddress rel_addr;
+    std::optional<uint16_t> rel_port;
+    while (!value.empty()) {
+        const auto key = next_token(&value, ' ');
+        const auto val = next_token(&value, ' ');
+        if (key == "raddr") {
+            rel_addr = IPAddress::Parse(val);
+        } else if (key == "rport") {
+            uint16_t rport = 0;
+            if (to_number(val, &rport))
+                rel_port = rport;
+        }
+    }
+    return std::make_unique<CCandidateInfo>(foundation, component, transport, priority, IPAddress::Parse(address),
+                                            port, type, std::move(rel_addr), rel_port);
+}
+
+/**
+ * Single pass SDP parser.
+ * All intermediate data is kept as views into the SDP text, strings are only
+ * allocated when they are stored into the semantic model.
+ */
+class CParser {
+ private:
+    struct SSource {
+        int                 ssrc;
+        std::string_view    cname;
+        std::string_view    stream_id;
+        std::string_view    track_id;
+        // Position + 1 of the Plan B track of the source in SMediaState::tracks
+        uint32_t            track{0};
+    };
+
+    /**
+     * Plan B track being built from the ssrc attributes of an m-line
+     */
+    struct SPendingTrack {
+        TrackInfo           track;
+        std::string_view    stream_id;
+    };
+
+    struct SSourceGroup {
+        std::string_view    semantics;
+        memory::Vector<int> ssrcs;
+    };
+
+    /**
+     * State of the m-line being parsed
+     */
+    struct SMediaState {
+        MediaInfo                               media;
+        CodecsMap                               codecs;
+        memory::Vector<int>                     formats;
+        memory::Vector<std::pair<int, int>>     rtx;
+        memory::Vector<std::string_view>        wildcard_rtcpfbs;
+        std::string_view                        msid_stream;
+        std::string_view                        msid_track;
+        memory::Vector<SSource>                 sources;
+        // Position + 1 in sources by SSRC, open addressing over a power of two table at most half full
+        memory::Vector<uint32_t>                source_index;
+        memory::Vector<SSourceGroup>            groups;
+        memory::Vector<SPendingTrack>           tracks;
+        // Position + 1 in tracks by track id, open addressing like source_index
+        memory::Vector<uint32_t>                track_index;
+        int                                     sctp_port{0};
+        int                                     max_message_size{0};
+
+        void Reset() {
+            media.reset();
+            codecs.clear();
+            formats.clear();
+            rtx.clear();
+            wildcard_rtcpfbs.clear();
+            msid_stream = {};
+            msid_track = {};
+            sources.clear();
+            source_index.clear();
+            groups.clear();
+            tracks.clear();
+            track_index.clear();
+            sctp_port = 0;
+            max_message_size = 0;
+        }
+    };
+
+    SDPInfo                                             m_sdp;
+    SMediaState                                         m_state;
+    memory::HashMap<std::string_view, StreamInfo>       m_streams;
+    std::string_view                                    m_ice_ufrag;
+    std::string_view                                    m_ice_pwd;
+    bool                                                m_ice_lite{false};
+    bool                                                m_end_of_candidates{false};
+    std::string_view                                    m_fingerprint_hash;
+    std::string_view                                    m_fingerprint;
+    Setup                                               m_setup{Setup::ActPass};
+
+ public:
+    CParser()
+    : m_sdp(std::make_unique<CSDPInfo>())
+    {}
+
+    /**
+     * Parse SDP text
+     * @param [in] sdp SDP text
+     * @returns SDP info or nullptr if the text is not a valid SDP
+     */
+    SDPInfo Parse(std::string_view sdp) {
+        // Outside an arena the line index of this thread is reused, a fresh block per call
+        // churns the heap more than the scan costs
+        LineIndex arena_lines;
+        auto& lines = (memory::detail::Current() != nullptr) ? arena_lines : ThreadLines();
+        if (!ScanLines(sdp, &lines) || lines.empty() || (lines.front().type != 'v'))
+            return nullptr;
+        for (const auto& line : lines) {
+            if (!ParseLine(line, sdp))
+                return nullptr;
+        }
+        FinalizeMedia();
+        FinalizeSession();
+        return std::move(m_sdp);
+    }
+
+ private:
+    static LineIndex& ThreadLines() {
+        static thread_local LineIndex lines{memory::CAllocator<SLine>(nullptr)};
+        return lines;
+    }
+
+    bool ParseLine(const SLine& line, std::string_view sdp) {
+        switch (line.type) {
+            case 'o':   return ParseOrigin(line.Value(sdp));
+            case 'm':   return ParseMedia(line.Value(sdp));
+            case 'a':   return ParseAttribute(line.Name(sdp), line.name_hash, line.AttributeValue(sdp));
+            case 'b':   return ParseBandwidth(line.Value(sdp));
+            default:    break;
+        }
+        return true;
+    }
+
+    bool ParseOrigin(std::string_view value) {
+        // o=<username> <sess-id> <sess-version> <nettype> <addrtype> <unicast-address>
+        next_token(&value, ' ');
+        uint64_t session_id = 0;
+        if (to_number(next_token(&value, ' '), &session_id))
+            m_sdp->SetSessionId(session_id);
+        int version = 0;
+        if (to_number(next_token(&value, ' '), &version))
+            m_sdp->SetVersion(version);
+        return true;
+    }
+
+    bool ParseMedia(std::string_view value) {
+        FinalizeMedia();
+        const auto type_str = next_token(&value, ' ');
+        // Media of other types is kept so the answer can reject just its m-line
+        const auto type = MediaType::ByValue(type_str).value_or(MediaType(MediaType::Type::other));
+        // <port>[/<number of ports>]
+        auto port_str = next_token(&value, ' ');
+        uint16_t port = 0;
+        if (!to_number(next_token(&port_str, '/'), &port))
+            return false;
+        const auto protocol = next_token(&value, ' ');
+        m_state.media = std::make_unique<CMediaInfo>(type_str, type);
+        m_state.media->SetPort(port);
+        m_state.media->SetProtocol(protocol);
+        if (type.GetType() == MediaType::Type::other) {
+            m_state.media->SetTypeName(type_str);
+            m_state.media->SetFormats(trim_view(value));
+            return true;
+        }
+        while (!value.empty()) {
+            const auto fmt = next_token(&value, ' ');
+            int pt = 0;
+            if (to_number(fmt, &pt))
+                m_state.formats.push_back(pt);
+        }
+        return true;
+    }
+
+    bool ParseBandwidth(std::string_view value) {
+        if (m_state.media == nullptr)
+            return true;
+        const auto type = next_token(&value, ':');
+        int bitrate = 0;
+        if ((type == "AS") && to_number(value, &bitrate))
+            m_state.media->SetBitrate(bitrate);
+        return true;
+    }
+
+    bool ParseAttribute(std::string_view name, const uint32_t hash, std::string_view line) {
+        // Hashes only select the candidate attribute, the name is confirmed before use
+        switch (hash) {
+            case AttributeHash("ice-ufrag"):
+                if (name == "ice-ufrag")
+                    m_ice_ufrag = line;
+                return true;
+            case AttributeHash("ice-pwd"):
+                if (name == "ice-pwd")
+                    m_ice_pwd = line;
+                return true;
+            case AttributeHash("ice-lite"):
+                if (name == "ice-lite")
+                    m_ice_lite = true;
+                return true;
+            case AttributeHash("fingerprint"):
+                if (name == "fingerprint") {
+                    m_fingerprint_hash = next_token(&line, ' ');
+                    m_fingerprint = line;
+                }
+                return true;
+            case AttributeHash("setup"):
+                if (name == "setup")
+                    m_setup = setup::ByValue(line);
+                return true;
+            case AttributeHash("end-of-candidates"):
+                if (name == "end-of-candidates")
+                    m_end_of_candidates = true;
+                return true;
+            case AttributeHash("crypto"):
+                return (name != "crypto") || ParseCrypto(line);
+            default:
+                break;
+        }
+        if (m_state.media == nullptr)
+            return true;
+        return ParseMediaAttribute(name, hash, line);
+    }
+
+    bool ParseMediaAttribute(std::string_view name, const uint32_t hash, std::string_view line) {
+        auto* media = m_state.media.get();
+        switch (hash) {
+            case AttributeHash("candidate"):
+                if (name == "candidate") {
+                    auto candidate = ParseCandidateValue(line);
+                    if (candidate != nullptr)
+                        media->AddCandidate(std::move(candidate));
+                }
+                return true;
+            case AttributeHash("control"):
+                if (name == "control")
+                    media->SetControl(line);
+                return true;
+            case AttributeHash("extmap"):
+                return (name != "extmap") || ParseExtmap(line);
+            case AttributeHash("fmtp"):
+                return (name != "fmtp") || ParseFmtp(line);
+            case AttributeHash("mid"):
+                if (name == "mid")
+                    media->SetId(line);
+                return true;
+            case AttributeHash("msid"):
+                if (name == "msid") {
+                    m_state.msid_stream = next_token(&line, ' ');
+                    m_state.msid_track = line;
+                }
+                return true;
+            case AttributeHash("max-message-size"):
+                if (name == "max-message-size")
+                    to_number(line, &m_state.max_message_size);
+                return true;
+            case AttributeHash("rtpmap"):
+                return (name != "rtpmap") || ParseRtpmap(line);
+            case AttributeHash("rtcp-fb"):
+                return (name != "rtcp-fb") || ParseRtcpFb(line);
+            case AttributeHash("rid"):
+                return (name != "rid") || ParseRid(line);
+            case AttributeHash("ssrc"):
+                return (name != "ssrc") || ParseSsrc(line);
+            case AttributeHash("ssrc-group"):
+                return (name != "ssrc-group") || ParseSsrcGroup(line);
+            case AttributeHash("simulcast"):
+                return (name != "simulcast") || ParseSimulcast(line);
+            case AttributeHash("sendrecv"):
+                if (name == "sendrecv")
+                    media->SetDirection(Direction::SendRecv);
+                return true;
+            case AttributeHash("sendonly"):
+                if (name == "sendonly")
+                    media->SetDirection(Direction::SendOnly);
+                return true;
+            case AttributeHash("recvonly"):
+                if (name == "recvonly")
+                    media->SetDirection(Direction::RecvOnly);
+                return true;
+            case AttributeHash("inactive"):
+                if (name == "inactive")
+                    media->SetDirection(Direction::Inactive);
+                return true;
+            case AttributeHash("sctp-port"):
+                if (name == "sctp-port")
+                    to_number(line, &m_state.sctp_port);
+                return true;
+            case AttributeHash("sctpmap"):
+                if (name != "sctpmap")
+                    return true;
+                // Legacy "<port> webrtc-datachannel <max-message-size>"
+                if (!to_number(next_token(&line, ' '), &m_state.sctp_port))
+                    return false;
+                next_token(&line, ' ');
+                if (!line.empty())
+                    to_number(line, &m_state.max_message_size);
+                return true;
+            default:
+                break;
+        }
+        return true;
+    }
+
+    bool ParseCrypto(std::string_view value) {
+        // <tag> <crypto-suite> <key-params> [<session-params>]
+        int tag = 0;
+        if (!to_number(next_token(&value, ' '), &tag))
+            return false;
+        const auto suite = next_token(&value, ' ');
+        const auto key_params = next_token(&value, ' ');
+        if (m_sdp->GetCrypto() == nullptr)
+            m_sdp->SetCrypto(std::make_unique<CCryptoInfo>(tag, suite, key_params, value));
+        return true;
+    }
+
+    bool ParseExtmap(std::string_view value) {
+        // <id>[/<direction>] <uri> [<attributes>]
+        auto id_str = next_token(&value, ' ');
+        id_str = next_token(&id_str, '/');
+        int id = 0;
+        if (!to_number(id_str, &id))
+            return false;
+        m_state.media->AddExtension(id, next_token(&value, ' '));
+        return true;
+    }
+
+    bool ParseRtpmap(std::string_view value) {
+        // <payload type> <encoding name>/<clock rate>[/<encoding parameters>]
+        int pt = 0;
+        if (!to_number(next_token(&value, ' '), &pt))
+            return false;
+        const auto name = next_token(&value, '/');
+        if (iequals(name, "rtx")) {
+            m_state.rtx.emplace_back(pt, -1);
+            return true;
+        }
+        auto codec = std::make_unique<CCodecInfo>(name, pt);
+        int rate = 0;
+        if (to_number(next_token(&value, '/'), &rate))
+            codec->SetRate(rate);
+        int channels = 0;
+        if (!value.empty() && to_number(value, &channels))
+            codec->SetChannels(channels);
+        m_state.codecs.insert_or_assign(pt, std::move(codec));
+        return true;
+    }
+
+    bool ParseFmtp(std::string_view value) {
+        // <format> <format specific parameters>
+        int pt = 0;
+        if (!to_number(next_token(&value, ' '), &pt))
+            return false;
+        for (auto& rtx : m_state.rtx) {
+            if (rtx.first != pt)
+                continue;
+            while (!value.empty()) {
+                auto param = next_token(&value, ';');
+                const auto key = trim_view(next_token(&param, '='));
+                if (key == "apt")
+                    to_number(trim_view(param), &rtx.second);
+            }
+            return true;
+        }
+        const auto codec_it = m_state.codecs.find(pt);
+        if (codec_it == m_state.codecs.end())
+            return true;
+        auto& codec = codec_it->second;
+        while (!value.empty()) {
+            auto param = next_token(&value, ';');
+            const auto key = trim_view(next_token(&param, '='));
+            if (!key.empty())
+                codec->AddParam(key, trim_view(param));
+        }
+        return true;
+    }
+
+    bool ParseRtcpFb(std::string_view value) {
+        // <payload type>|* <id> [<params>]
+        const auto fmt = next_token(&value, ' ');
+        if (fmt == "*") {
+            m_state.wildcard_rtcpfbs.push_back(value);
+            return true;
+        }
+        int pt = 0;
+        if (!to_number(fmt, &pt))
+            return false;
+        const auto codec_it = m_state.codecs.find(pt);
+        if (codec_it != m_state.codecs.end())
+            codec_it->second->AddRTCPFeedback(CRTCPFeedbackInfo::Parse(value));
+        return true;
+    }
+
+    bool ParseRid(std::string_view value) {
+        // <rid-id> <send|recv> [pt=<fmt-list>;<restriction>=<value>...]
+        const auto id = next_token(&value, ' ');
+        const auto direction = direction_way::ByValue(next_token(&value, ' '));
+        auto rid = std::make_unique<CRIDInfo>(id, direction);
+        while (!value.empty()) {
+            auto param = next_token(&value, ';');
+            const auto key = next_token(&param, '=');
+            if (key == "pt") {
+                memory::Vector<int> formats;
+                while (!param.empty()) {
+                    int pt = 0;
+                    if (to_number(next_token(&param, ','), &pt))
+                        formats.push_back(pt);
+                }
+                rid->SetFormats(formats);
+            } else if (!key.empty()) {
+                rid->AddParam(key, param);
+            }
+        }
+        m_state.media->AddRID(std::move(rid));
+        return true;
+    }
+
+    bool ParseSimulcast(std::string_view value) {
+        // <send|recv> <streams> [<send|recv> <streams>]
+        auto simulcast = std::make_unique<CSimulcastInfo>();
+        while (!value.empty()) {
+            const auto direction = direction_way::ByValue(next_token(&value, ' '));
+            auto list = next_token(&value, ' ');
+            // Old drafts used "rid=" prefix
+            if (list.substr(0, 4) == "rid=")
+                list.remove_prefix(4);
+            while (!list.empty()) {
+                auto alternatives = next_token(&list, ';');
+                SimulcastStreams streams;
+                while (!alternatives.empty()) {
+                    auto id = next_token(&alternatives, ',');
+                    const bool paused = (!id.empty() && (id[0] == '~'));
+                    if (paused)
+                        id.remove_prefix(1);
+                    streams.push_back(std::make_unique<CSimulcastStreamInfo>(id, paused));
+                }
+                simulcast->AddSimulcastAlternativeStreams(direction, std::move(streams));
+            }
+        }
+        m_state.media->SetSimulcast(std::move(simulcast));
+        return true;
+    }
+
+    static uint32_t* FindSourceSlot(memory::Vector<uint32_t>* index, const int ssrc,
+                                    const memory::Vector<SSource>& sources) {
+        const auto mask = index->size() - 1;
+        for (auto i = CSSRCIndex::Hash(static_cast<uint32_t>(ssrc)) & mask;; i = (i + 1) & mask) {
+            auto& position = (*index)[i];
+            if ((position == 0) || (sources[position - 1].ssrc == ssrc))
+                return &position;
+        }
+    }
+
+    static uint32_t* FindTrackSlot(memory::Vector<uint32_t>* index, std::string_view track_id,
+                                   const memory::Vector<SPendingTrack>& tracks) {
+        const auto mask = index->size() - 1;
+        for (auto i = std::hash<std::string_view>{}(track_id) & mask;; i = (i + 1) & mask) {
+            auto& position = (*index)[i];
+            if ((position == 0) || (tracks[position - 1].track->GetId() == track_id))
+                return &position;
+        }
+    }
+
+    SSource& GetSource(const int ssrc) {
+        auto& sources = m_state.sources;
+        auto& index = m_state.source_index;
+        if ((sources.size() + 1) * 2 > index.size()) {
+            index.assign(std::max<std::size_t>(16, index.size() * 2), 0);
+            for (std::size_t i = 0; i < sources.size(); ++i)
+                *FindSourceSlot(&index, sources[i].ssrc, sources) = static_cast<uint32_t>(i + 1);
+        }
+        auto* position = FindSourceSlot(&index, ssrc, sources);
+        if (*position != 0)
+            return sources[*position - 1];
+        sources.push_back(SSource{ssrc, {}, {}, {}});
+        *position = static_cast<uint32_t>(sources.size());
+        return sources.back();
+    }
+
+    bool ParseSsrc(std::string_view value) {
+        // <ssrc> <attribute>[:<value>]
+        uint32_t ssrc = 0;
+        if (!to_number(next_token(&value, ' '), &ssrc))
+            return false;
+        auto& source = GetSource(static_cast<int>(ssrc));
+        const auto attribute = next_token(&value, ':');
+        if (attribute == "cname") {
+            source.cname = value;
+        } else if (attribute == "msid") {
+            source.stream_id = next_token(&value, ' ');
+            source.track_id = value;
+        }
+        return true;
+    }
+
+    bool ParseSsrcGroup(std::string_view value) {
+        // <semantics> <ssrc>...
+        SSourceGroup group;
+        group.semantics = next_token(&value, ' ');
+        while (!value.empty()) {
+            uint32_t ssrc = 0;
+            if (!to_number(next_token(&value, ' '), &ssrc))
+                return false;
+            group.ssrcs.push_back(static_cast<int>(ssrc));
+        }
+        m_state.groups.push_back(std::move(group));
+        return true;
+    }
+
+    CStreamInfo* GetStream(std::string_view id) {
+        auto& stream = m_streams[id];
+        if (stream == nullptr)
+            stream = std::make_unique<CStreamInfo>(id);
+        return stream.get();
+    }
+
+    void AddGroups(CTrackInfo* track) {
+        for (const auto& group : m_state.groups) {
+            const auto& ssrcs = track->GetSSRCs();
+            if (!group.ssrcs.empty() && (std::find(ssrcs.cbegin(), ssrcs.cend(), group.ssrcs.front()) != ssrcs.cend()))
+                track->AddSourceGroup(std::make_unique<CSourceGroupInfo>(group.semantics, group.ssrcs));
+        }
+    }
+
+    void AddEncodings(CTrackInfo* track) {
+        const auto& media = m_state.media;
+        const auto& simulcast = media->GetSimulcast();
+        if (simulcast == nullptr)
+            return;
+        for (const auto& streams : *simulcast->GetSimulcastStreams(DirectionWay::Send)) {
+            EncodingsList alternatives;
+            for (const auto& stream : streams) {
+                auto encoding = std::make_unique<CTrackEncodingInfo>(stream->GetId(), stream->IsPaused());
+                const auto* rid = media->GetRID(stream->GetId());
+                if (rid != nullptr) {
+                    for (const auto pt : (*rid)->GetFormats()) {
+                        const auto* codec = media->GetCodecForType(pt);
+                        if (codec != nullptr)
+                            encoding->AddCodec((*codec)->Clone());
+                    }
+                    encoding->SetParams((*rid)->GetParams());
+                }
+                alternatives.push_back(std::move(encoding));
+            }
+            track->AddAlternativeEncodings(std::move(alternatives));
+        }
+    }
+
+    void FinalizeTracks() {
+        const auto& media = m_state.media;
+        if (!m_state.msid_track.empty()) {
+            // Unified plan, one track per m-line
+            auto track = std::make_unique<CTrackInfo>(media->GetType(), m_state.msid_track);
+            track->SetMediaId(media->GetId());
+            for (const auto& source : m_state.sources) {
+                track->AddSSRC(source.ssrc);
+                if (track->GetCName().empty())
+                    track->SetCName(source.cname);
+            }
+            AddGroups(track.get());
+            AddEncodings(track.get());
+            GetStream(m_state.msid_stream)->AddTrack(std::move(track));
+            return;
+        }
+        // Plan B, tracks are signaled in ssrc attributes, group the sources by track id in one pass
+        if (m_state.sources.empty())
+            return;
+        auto& tracks = m_state.tracks;
+        auto& index = m_state.track_index;
+        index.assign(std::max<std::size_t>(16, std::bit_ceil(m_state.sources.size() * 2)), 0);
+        for (auto& source : m_state.sources) {
+            if (source.track_id.empty())
+                continue;
+            auto* position = FindTrackSlot(&index, source.track_id, tracks);
+            if (*position == 0) {
+                auto track = std::make_unique<CTrackInfo>(media->GetType(), source.track_id);
+                track->SetMediaId(media->GetId());
+                tracks.push_back(SPendingTrack{std::move(track), source.stream_id});
+                *position = static_cast<uint32_t>(tracks.size());
+            }
+            auto& track = tracks[*position - 1].track;
+            track->AddSSRC(source.ssrc);
+            if (track->GetCName().empty())
+                track->SetCName(source.cname);
+            source.track = *position;
+        }
+        // A group belongs to the track of its first SSRC
+        for (const auto& group : m_state.groups) {
+            if (group.ssrcs.empty() || m_state.source_index.empty())
+                continue;
+            const auto position = *FindSourceSlot(&m_state.source_index, group.ssrcs.front(), m_state.sources);
+            if ((position == 0) || (m_state.sources[position - 1].track == 0))
+                continue;
+            auto& track = tracks[m_state.sources[position - 1].track - 1].track;
+            track->AddSourceGroup(std::make_unique<CSourceGroupInfo>(group.semantics, group.ssrcs));
+        }
+        for (auto& pending : tracks)
+            GetStream(pending.stream_id)->AddTrack(std::move(pending.track));
+    }
+
+    void FinalizeMedia() {
+        auto& media = m_state.media;
+        if (media == nullptr)
+            return;
+        // Static payload types without rtpmap
+        for (const auto pt : m_state.formats) {
+            if (m_state.codecs.find(pt) != m_state.codecs.end())
+                continue;
+            std::string_view name;
+            if (pt == 0)
+                name = "PCMU";
+            else if (pt == 8)
+                name = "PCMA";
+            else if (pt == 9)
+                name = "G722";
+            else
+                continue;
+            auto codec = std::make_unique<CCodecInfo>(name, pt);
+            codec->SetRate(8000);
+            m_state.codecs.emplace(pt, std::move(codec));
+        }
+        // Associate rtx payloads with their codecs
+        for (const auto& rtx : m_state.rtx) {
+            const auto codec_it = m_state.codecs.find(rtx.second);
+            if (codec_it != m_state.codecs.end())
+                codec_it->second->SetRTX(rtx.first);
+        }
+        for (const auto& value : m_state.wildcard_rtcpfbs) {
+            const auto rtcpfb = CRTCPFeedbackInfo::Parse(value);
+            for (auto& codec_it : m_state.codecs)
+                codec_it.second->AddRTCPFeedback(rtcpfb);
+        }
+        media->SetCodecs(std::move(m_state.codecs));
+        if (m_state.sctp_port != 0)
+            media->SetDataChannel(std::make_unique<CDataChannelInfo>(m_state.sctp_port, m_state.max_message_size));
+        // Only audio and video carry tracks
+        const auto kind = media->GetType().GetType();
+        if ((kind == MediaType::Type::audio) || (kind == MediaType::Type::video))
+            FinalizeTracks();
+        m_sdp->AddMedia(std::move(media));
+        m_state.Reset();
+    }
+
+    void FinalizeSession() {
+        for (auto& stream_it : m_streams)
+            m_sdp->AddStream(std::move(stream_it.second));
+        if (!m_ice_ufrag.empty() || !m_ice_pwd.empty()) {
+            auto ice = std::make_unique<CICEInfo>(m_ice_ufrag, m_ice_pwd);
+            ice->SetLite(m_ice_lite);
+            ice->SetEndOfCandidates(m_end_of_candidates);
+            m_sdp->SetICE(std::move(ice));
+        }
+        if (!m_fingerprint.empty())
+            m_sdp->SetDTLS(std::make_unique<CDTLSInfo>(m_setup, m_fingerprint_hash, m_fingerprint));
+    }
+};
+
+}    // namespace detail
+
+/**
+ * Parse SDP text into the semantic model.
+ * The text is walked once, lines and attributes are handled as views into the input.
+ * @param [in] sdp SDP text
+ * @returns SDP info or nullptr if the text is not a valid SDP
+ */
+inline SDPInfo Parse(std::string_view sdp) {
+    memory::COperation operation(memory::Operation::Parse);
+    detail::CParser parser;
+    return parser.Parse(sdp);
+}
+
+/**
+ * Parse a single trickled ICE candidate
+ * @param [in] line "a=candidate:..." or "candidate:...", a trailing line terminator is ignored
+ * @returns candidate info or nullptr if malformed
+ */
+inline CandidateInfo ParseCandidate(std::string_view line) {
+    memory::COperation operation(memory::Operation::Parse);
+    line = rtrim_view(line);
+    if (line.starts_with("a="))
+        line.remove_prefix(2);
+    if (!line.starts_with("candidate:"))
+        return nullptr;
+    line.remove_prefix(std::string_view("candidate:").size());
+    return detail::ParseCandidateValue(line);
+}
+
+/**
+ * Apply a trickled "a=candidate:..." or "a=end-of-candidates" line to a media of a parsed description,
+ * without parsing the description again
+ * @param [in] sdp description to update
+ * @param [in] media media the line was trickled for
+ * @param [in] line trickled line, the "a=" prefix and a trailing line terminator are optional
+ * @returns false if the line is malformed or neither a candidate nor an end of candidates
+ */
+inline bool AddTrickle(CSDPInfo* sdp, CMediaInfo* media, std::string_view line) {
+    if ((sdp == nullptr) || (media == nullptr))
+        return false;
+    const auto trimmed = rtrim_view(line);
+    if ((trimmed == "a=end-of-candidates") || (trimmed == "end-of-candidates")) {
+        const auto& ice = sdp->GetICE();
+        if (ice == nullptr)
+            return false;
+        ice->SetEndOfCandidates(true);
+        return true;
+    }
+    auto candidate = ParseCandidate(trimmed);
+    if (candidate == nullptr)
+        return false;
+    // A candidate trickled again is accepted but not added twice
+    media->AddCandidate(std::move(candidate));
+    return true;
+}
+
+/**
+ * Apply a trickled line to the media with the given mid
+ * @param [in] sdp description to update
+ * @param [in] mid media id (sdpMid)
+ * @param [in] line trickled line
+ * @returns false if the media is unknown or the line is malformed
+ */
+inline bool AddTrickle(CSDPInfo* sdp, std::string_view mid, std::string_view line) {
+    if (sdp == nullptr)
+        return false;
+    const auto* media = sdp->GetMediaById(mid);
+    return (media != nullptr) && AddTrickle(sdp, media->get(), line);
+}
+
+/**
+ * Apply a trickled line to the media of the given m-line
+ * @param [in] sdp description to update
+ * @param [in] mline_index m-line index (sdpMLineIndex)
+ * @param [in] line trickled line
+ * @returns false if there is no such m-line or the line is malformed
+ */
+inline bool AddTrickle(CSDPInfo* sdp, const std::size_t mline_index, std::string_view line) {
+    if ((sdp == nullptr) || (mline_index >= sdp->GetMedias().size()))
+        return false;
+    return AddTrickle(sdp, sdp->GetMedias()[mline_index].get(), line);
+}
+
+}    // namespace sdp
+
+}    // namespace semantic_sdp
@@ -0,0 +1,566 @@
+// "Copyright 2024 <Oldnick85>"
+
+#pragma once
+
+#include <algorithm>
+#include <charconv>
+#include <concepts>
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+#include "./util.h"
+#include "./memory.h"
+#include "./direction.h"
+#include "./direction_way.h"
+#include "./setup.h"
+#include "./candidate_info.h"
+#include "./codec_info.h"
+#include "./rid_info.h"
+#include "./simulcast_info.h"
+#include "./track_info.h"
+#include "./media_info.h"
+#include "./stream_info.h"
+#include "./sdp_info.h"
+
+namespace semantic_sdp {
+
+namespace sdp {
+
+/**
+ * Output of the serializer, anything that text can be appended to
+ */
+template <typename T>
+concept Sink = requires(T sink, std::string_view str) {
+    sink.Append(str);
+};
+
+/**
+ * String the serializer can write into, std::string or memory::String
+ */
+template <typename T>
+concept OutputString = requires(T out, std::string_view str, std::size_t size) {
+    out.append(str);
+    out.reserve(size);
+    { out.size() } -> std::convertible_to<std::size_t>;
+    { out.capacity() } -> std::convertible_to<std::size_t>;
+};
+
+/**
+ * Sink appending to a caller owned string
+ */
+template <OutputString String = std::string>
+class CStringSink {
+ private:
+    String*     m_out;
+
+ public:
+    /**
+     * constructor for CStringSink
+     * @param [in] out string to append to
+     */
+    explicit CStringSink(String* out)
+    : m_out(out)
+    {}
+
+    void Append(std::string_view str) {
+        m_out->append(str);
+    }
+};
+
+/**
+ * Sink that only counts the bytes that would be written
+ */
+class CSizeSink {
+ private:
+    std::size_t     m_size{0};
+
+ public:
+    void Append(std::string_view str) {
+        m_size += str.size();
+    }
+
+    /**
+     * Get number of bytes appended so far
+     * @returns size
+     */
+    auto GetSize() const {
+        return m_size;
+    }
+};
+
+namespace detail {
+
+/**
+ * Track of the session with the mid of its m-line
+ */
+struct STrackRef {
+    std::string_view        mid;
+    // Position in the streams and tracks of the session, keeps their order within an m-line
+    std::size_t             order;
+    const CStreamInfo*      stream;
+    const CTrackInfo*       track;
+};
+
+/**
+ * Tracks of the session sorted by mid, so the tracks of each m-line are found without walking all streams
+ */
+using TrackView = memory::Vector<STrackRef>;
+
+inline TrackView& ThreadTrackView() {
+    static thread_local TrackView tracks{memory::CAllocator<STrackRef>(nullptr)};
+    return tracks;
+}
+
+/**
+ * Build the track view of a session
+ * @param [in] sdp SDP info
+ * @param [out] tracks view, reused if not empty
+ */
+inline void BuildTrackView(const CSDPInfo& sdp, TrackView* tracks) {
+    tracks->clear();
+    std::size_t count = 0;
+    for (const auto& stream_it : sdp.GetStreams())
+        count += stream_it.second->GetTracks().size();
+    tracks->reserve(count);
+    for (const auto& stream_it : sdp.GetStreams()) {
+        for (const auto& track_it : stream_it.second->GetTracks())
+            tracks->push_back({track_it.second->GetMediaId(), tracks->size(), stream_it.second.get(),
+                               track_it.second.get()});
+    }
+    std::sort(tracks->begin(), tracks->end(), [](const STrackRef& lhs, const STrackRef& rhs) {
+        return (lhs.mid < rhs.mid) || ((lhs.mid == rhs.mid) && (lhs.order < rhs.order));
+    });
+}
+
+/**
+ * Writes SDP lines for the semantic model into a sink
+ */
+template <Sink S>
+class CWriter {
+ private:
+    S*                  m_sink;
+    const CSDPInfo&     m_sdp;
+    const TrackView&    m_tracks;
+
+ public:
+    CWriter(S* sink, const CSDPInfo& sdp, const TrackView& tracks)
+    : m_sink(sink)
+    , m_sdp(sdp)
+    , m_tracks(tracks)
+    {}
+
+    void Write() {
+        WriteSession();
+        for (const auto& media : m_sdp.GetMedias())
+            WriteMedia(*media);
+    }
+
+ private:
+    void Put(std::string_view str) {
+        m_sink->Append(str);
+    }
+
+    template <typename T>
+    void Put(const T number) requires std::integral<T> {
+        char buf[24];
+        const auto res = std::to_chars(buf, buf + sizeof(buf), number);
+        m_sink->Append(std::string_view(buf, res.ptr - buf));
+    }
+
+    void Put(const IPAddress& address) {
+        IPAddress::TextBuffer buffer;
+        Put(address.Format(&buffer));
+    }
+
+    template <typename... Args>
+    void Line(const Args&... args) {
+        (Put(args), ...);
+        Put("\r\n");
+    }
+
+    void WriteSession() {
+        Line("v=0");
+        Line("o=- ", m_sdp.GetSessionId(), " ", m_sdp.GetVersion(), " IN IP4 127.0.0.1");
+        Line("s=-");
+        Line("t=0 0");
+        const auto& ice = m_sdp.GetICE();
+        if ((ice != nullptr) && ice->IsLite())
+            Line("a=ice-lite");
+        // Only accepted m-lines with a mid can be bundled
+        bool bundle = false;
+        for (const auto& media : m_sdp.GetMedias()) {
+            if (IsRejected(*media) || media->GetId().empty())
+                continue;
+            Put(bundle ? " " : "a=group:BUNDLE ");
+            Put(media->GetId());
+            bundle = true;
+        }
+        if (bundle)
+            Put("\r\n");
+        Line("a=msid-semantic: WMS *");
+    }
+
+    static bool IsRejected(const CMediaInfo& media) {
+        const auto type = media.GetType().GetType();
+        // RTP media without codecs can not be accepted either
+        return media.IsRejected() ||
+               (((type == MediaType::Type::audio) || (type == MediaType::Type::video)) && media.GetCodecs().empty());
+    }
+
+    static std::string_view Protocol(const CMediaInfo& media) {
+        if (!media.GetProtocol().empty())
+            return media.GetProtocol();
+        return (media.GetType().GetType() == MediaType::Type::application) ? "UDP/DTLS/SCTP" : "UDP/TLS/RTP/SAVPF";
+    }
+
+    static bool IsStaticPayload(const int pt) {
+        return (pt == 0) || (pt == 8) || (pt == 9);
+    }
+
+    static int DefaultRate(const CMediaInfo& media, const CCodecInfo& codec) {
+        if (media.GetType().GetType() == MediaType::Type::video)
+            return 90000;
+        return IsStaticPayload(codec.GetType()) ? 8000 : 48000;
+    }
+
+    void WriteMediaLine(const CMediaInfo& media) {
+        const auto type = media.GetType().GetType();
+        Put("m=");
+        Put(media.GetTypeName());
+        Put(" ");
+        Put(IsRejected(media) ? 0 : static_cast<int>(media.GetPort()));
+        Put(" ");
+        Put(Protocol(media));
+        if (type == MediaType::Type::other) {
+            if (!media.GetFormats().empty())
+                Put(" ");
+            Line(media.GetFormats());
+            return;
+        }
+        if (type == MediaType::Type::application) {
+            Line(" webrtc-datachannel");
+            return;
+        }
+        const auto& codecs = media.GetCodecs();
+        if (codecs.empty()) {
+            // An m-line needs a format even when rejected
+            Line(" 0");
+            return;
+        }
+        for (const auto& codec_it : codecs) {
+            Put(" ");
+            Put(codec_it.second->GetType());
+            if (codec_it.second->HasRTX()) {
+                Put(" ");
+                Put(*codec_it.second->GetRTX());
+            }
+        }
+        Put("\r\n");
+    }
+
+    void WriteCandidate(const CCandidateInfo& candidate) {
+        Put("a=candidate:");
+        Put(candidate.GetFoundation());
+        Put(" ");
+        Put(candidate.GetComponentId());
+        Put(" ");
+        Put(candidate.GetTransport());
+        Put(" ");
+        Put(candidate.GetPriority());
+        Put(" ");
+        Put(candidate.GetIPAddress());
+        Put(" ");
+        Put(candidate.GetPort());
+        Put(" typ ");
+        Put(candidate.GetType());
+        if (candidate.GetRelIPAddress() != nullptr) {
+            Put(" raddr ");
+            Put(*candidate.GetRelIPAddress());
+        }
+        if (candidate.GetRelPort().has_value()) {
+            Put(" rport ");
+            Put(*candidate.GetRelPort());
+        }
+        Put("\r\n");
+    }
+
+    void WriteTransport(const CMediaInfo& media) {
+        for (const auto& candidate : media.GetCandidates())
+            WriteCandidate(*candidate);
+        const auto& ice = m_sdp.GetICE();
+        if (ice != nullptr) {
+            if (ice->IsEndOfCandidates())
+                Line("a=end-of-candidates");
+            Line("a=ice-ufrag:", ice->GetUfrag());
+            Line("a=ice-pwd:", ice->GetPwd());
+        }
+        const auto& dtls = m_sdp.GetDTLS();
+        if (dtls != nullptr) {
+            Line("a=fingerprint:", dtls->GetHash(), " ", dtls->GetFingerprint());
+            Line("a=setup:", setup::ToString(dtls->GetSetup()));
+        }
+        const auto& crypto = m_sdp.GetCrypto();
+        if (crypto != nullptr) {
+            Put("a=crypto:");
+            Put(crypto->GetTag());
+            Put(" ");
+            Put(crypto->GetSuite());
+            Put(" ");
+            Put(crypto->GetKeyParams());
+            if (!crypto->GetSessionParams().empty()) {
+                Put(" ");
+                Put(crypto->GetSessionParams());
+            }
+            Put("\r\n");
+        }
+    }
+
+    void WriteCodec(const CMediaInfo& media, const CCodecInfo& codec) {
+        const auto pt = codec.GetType();
+        const auto rate = codec.HasRate() ? *codec.GetRate() : DefaultRate(media, codec);
+        Put("a=rtpmap:");
+        Put(pt);
+        Put(" ");
+        Put(codec.GetCodec());
+        Put("/");
+        Put(rate);
+        if (codec.HasChannels()) {
+            Put("/");
+            Put(*codec.GetChannels());
+        }
+        Put("\r\n");
+        for (const auto& rtcpfb : codec.GetRTCPFeedbacks()) {
+            Put("a=rtcp-fb:");
+            Put(pt);
+            Put(" ");
+            Put(rtcpfb.GetId());
+            if (!rtcpfb.GetParamsText().empty()) {
+                Put(" ");
+                Put(rtcpfb.GetParamsText());
+            }
+            Put("\r\n");
+        }
+        const auto& params = codec.GetParams();
+        if (!params.empty()) {
+            Put("a=fmtp:");
+            Put(pt);
+            Put(" ");
+            bool first = true;
+            for (const auto& param_it : params) {
+                if (!first)
+                    Put(";");
+                first = false;
+                Put(param_it.first);
+                if (!param_it.second.empty()) {
+                    Put("=");
+                    Put(param_it.second);
+                }
+            }
+            Put("\r\n");
+        }
+        if (codec.HasRTX()) {
+            const auto rtx = *codec.GetRTX();
+            Line("a=rtpmap:", rtx, " rtx/", rate);
+            Line("a=fmtp:", rtx, " apt=", pt);
+        }
+    }
+
+    void WriteRIDs(const CMediaInfo& media) {
+        for (const auto& rid_it : media.GetRIDs()) {
+            const auto& rid = rid_it.second;
+            Put("a=rid:");
+            Put(rid->GetId());
+            Put(" ");
+            Put(direction_way::ToString(rid->GetDirection()));
+            char sep = ' ';
+            const auto& formats = rid->GetFormats();
+            if (!formats.empty()) {
+                Put(" pt=");
+                bool first = true;
+                for (const auto pt : formats) {
+                    if (!first)
+                        Put(",");
+                    first = false;
+                    Put(pt);
+                }
+                sep = ';';
+            }
+            for (const auto& param_it : rid->GetParams()) {
+                Put(std::string_view(&sep, 1));
+                Put(param_it.first);
+                Put("=");
+                Put(param_it.second);
+                sep = ';';
+            }
+            Put("\r\n");
+        }
+    }
+
+    void WriteSimulcastStreams(const memory::Vector<SimulcastStreams>& streams) {
+        bool first_stream = true;
+        for (const auto& alternatives : streams) {
+            if (!first_stream)
+                Put(";");
+            first_stream = false;
+            bool first = true;
+            for (const auto& stream : alternatives) {
+                if (!first)
+                    Put(",");
+                first = false;
+                if (stream->IsPaused())
+                    Put("~");
+                Put(stream->GetId());
+            }
+        }
+    }
+
+    void WriteSimulcast(const CMediaInfo& media) {
+        const auto& simulcast = media.GetSimulcast();
+        if (simulcast == nullptr)
+            return;
+        const auto* send = simulcast->GetSimulcastStreams(DirectionWay::Send);
+        const auto* recv = simulcast->GetSimulcastStreams(DirectionWay::Recv);
+        if (send->empty() && recv->empty())
+            return;
+        Put("a=simulcast:");
+        if (!send->empty()) {
+            Put("send ");
+            WriteSimulcastStreams(*send);
+        }
+        if (!recv->empty()) {
+            if (!send->empty())
+                Put(" ");
+            Put("recv ");
+            WriteSimulcastStreams(*recv);
+        }
+        Put("\r\n");
+    }
+
+    void WriteTracks(const CMediaInfo& media) {
+        const std::string_view mid = media.GetId();
+        const auto range = std::equal_range(m_tracks.begin(), m_tracks.end(), STrackRef{mid, 0, nullptr, nullptr},
+                                            [](const STrackRef& lhs, const STrackRef& rhs) {
+                                                return lhs.mid < rhs.mid;
+                                            });
+        for (auto it = range.first; it != range.second; ++it) {
+            const auto* stream = it->stream;
+            const auto* track = it->track;
+            Line("a=msid:", stream->GetId(), " ", track->GetId());
+            for (const auto& group : track->GetSourceGroups()) {
+                Put("a=ssrc-group:");
+                Put(group->GetSemantics());
+                for (const auto ssrc : group->GetSSRCs()) {
+                    Put(" ");
+                    Put(static_cast<uint32_t>(ssrc));
+                }
+                Put("\r\n");
+            }
+            for (const auto ssrc : track->GetSSRCs()) {
+                if (!track->GetCName().empty())
+                    Line("a=ssrc:", static_cast<uint32_t>(ssrc), " cname:", track->GetCName());
+                Line("a=ssrc:", static_cast<uint32_t>(ssrc), " msid:", stream->GetId(), " ", track->GetId());
+            }
+        }
+    }
+
+    void WriteMedia(const CMediaInfo& media) {
+        WriteMediaLine(media);
+        Line("c=IN IP4 0.0.0.0");
+        if (media.GetBitrate() > 0)
+            Line("b=AS:", media.GetBitrate());
+        WriteTransport(media);
+        Line("a=mid:", media.GetId());
+        if (media.GetType().GetType() == MediaType::Type::other)
+            return;
+        if (media.GetType().GetType() == MediaType::Type::application) {
+            const auto& data_channel = media.GetDataChannel();
+            if (data_channel != nullptr) {
+                Line("a=sctp-port:", data_channel->GetPort());
+                if (data_channel->GetMaxMessageSize() > 0)
+                    Line("a=max-message-size:", data_channel->GetMaxMessageSize());
+            }
+            return;
+        }
+        for (const auto& extension_it : media.GetExtensions())
+            Line("a=extmap:", extension_it.first, " ", extension_it.second);
+        Line("a=", direction::ToString(media.GetDirection()));
+        if (media.HasControl())
+            Line("a=control:", media.GetControl());
+        WriteTracks(media);
+        Line("a=rtcp-mux");
+        if (media.GetType().GetType() == MediaType::Type::video)
+            Line("a=rtcp-rsize");
+        for (const auto& codec_it : media.GetCodecs())
+            WriteCodec(media, *codec_it.second);
+        WriteRIDs(media);
+        WriteSimulcast(media);
+    }
+};
+
+}    // namespace detail
+
+/**
+ * Write SDP text of the description into a sink
+ * @param [in] sdp SDP info
+ * @param [in] sink output sink
+ */
+template <Sink S>
+void Write(const CSDPInfo& sdp, S* sink) {
+    // Outside an arena the track view of this thread is reused
+    detail::TrackView arena_tracks;
+    auto& tracks = (memory::detail::Current() != nullptr) ? arena_tracks : detail::ThreadTrackView();
+    detail::BuildTrackView(sdp, &tracks);
+    detail::CWriter<S> writer(sink, sdp, tracks);
+    writer.Write();
+}
+
+/**
+ * Get the exact size of the SDP text the description serializes to
+ * @param [in] sdp SDP info
+ * @returns size in bytes
+ */
+inline std::size_t EstimateSize(const CSDPInfo& sdp) {
+    CSizeSink sink;
+    Write(sdp, &sink);
+    return sink.GetSize();
+}
+
+/**
+ * Append SDP text of the description to the buffer.
+ * Buffer capacity is grown once up front, so a reused buffer that is already
+ * large enough is not reallocated. Growth of a memory::String buffer goes through
+ * its allocator and is counted by the allocation statistics.
+ * @param [in] sdp SDP info
+ * @param [out] out buffer to append to
+ */
+template <OutputString String>
+void Serialize(const CSDPInfo& sdp, String* out) {
+    if (out == nullptr)
+        return;
+    memory::COperation operation(memory::Operation::Serialize);
+    // The track view is built once for measuring and writing
+    detail::TrackView arena_tracks;
+    auto& tracks = (memory::detail::Current() != nullptr) ? arena_tracks : detail::ThreadTrackView();
+    detail::BuildTrackView(sdp, &tracks);
+    CSizeSink size_sink;
+    detail::CWriter<CSizeSink>(&size_sink, sdp, tracks).Write();
+    out->reserve(out->size() + size_sink.GetSize());
+    CStringSink<String> sink(out);
+    detail::CWriter<CStringSink<String>>(&sink, sdp, tracks).Write();
+}
+
+/**
+ * Get SDP text of the description
+ * @param [in] sdp SDP info
+ * @returns SDP text
+ */
+inline std::string ToString(const CSDPInfo& sdp) {
+    std::string out;
+    Serialize(sdp, &out);
+    return out;
+}
+
+}    // namespace sdp
+
+}    // namespace semantic_sdp
@@ -3,8 +3,10 @@
 #pragma once
 
 #include <string>
+#include <string_view>
 
 #include "./util.h"
+#include "./perfect_hash.h"
 
 namespace semantic_sdp {
 
@@ -21,22 +23,24 @@ enum class Setup {
 
 namespace setup {
 
+namespace detail {
+
+inline constexpr CPerfectHash<Setup, 4> kNames({{
+    {"active", Setup::Active},
+    {"passive", Setup::Passive},
+    {"actpass", Setup::ActPass},
+    {"inactive", Setup::Inactive},
+}});
+
+}    // namespace detail
+
 /**
  * Get Setup by name
  * @param [in] setup
  * @returns setup
  */
-Setup ByValue(const std::string& setup) {
-    std::string str{to_lower_case_copy(setup)};
-    if (str == "inactive")
-        return Setup::Inactive;
-    if (str == "active")
-        return Setup::Active;
-    if (str == "passive")
-        return Setup::Passive;
-    if (str == "actpass")
-        return Setup::ActPass;
-    return Setup::Unknown;
+constexpr Setup ByValue(std::string_view setup) {
+    return detail::kNames.Find(setup).value_or(Setup::Unknown);
 }
 
 /**
@@ -44,7 +48,7 @@ Setup ByValue(const std::string& setup) {
  * @param [in] setup
  * @returns name
  */
-std::string ToString(Setup setup) {
+constexpr std::string_view ToString(Setup setup) {
     switch (setup) {
         case Setup::Active:
             return "active";
@@ -66,7 +70,7 @@ std::string ToString(Setup setup) {
  * @param [in] prefferActive
  * @returns setup
  */
-Setup Reverse(const Setup setup, const bool prefferActive) {
+constexpr Setup Reverse(const Setup setup, const bool prefferActive) {
     switch (setup) {
         case Setup::Active:
             return Setup::Passive;
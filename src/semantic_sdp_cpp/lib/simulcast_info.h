@@ -5,9 +5,9 @@
 #include <string>
 #include <memory>
 #include <utility>
-#include <vector>
 
 #include "./util.h"
+#include "./memory.h"
 #include "./simulcast_stream_info.h"
 
 namespace semantic_sdp {
@@ -17,10 +17,10 @@ using SimulcastInfo = std::unique_ptr<CSimulcastInfo>;
 /**
  * Simulcast information
  */
-class CSimulcastInfo {
+class CSimulcastInfo : public memory::CAllocated {
  private:
-    std::vector<std::vector<SimulcastStreamInfo>>    m_send;
-    std::vector<std::vector<SimulcastStreamInfo>>    m_recv;
+    memory::Vector<SimulcastStreams>    m_send;
+    memory::Vector<SimulcastStreams>    m_recv;
 
  public:
     /**
@@ -33,15 +33,16 @@ class CSimulcastInfo {
      * @returns simulcast info
      */
     SimulcastInfo Clone() const {
+        memory::COperation operation(memory::Operation::Clone);
         auto cloned = std::make_unique<CSimulcastInfo>();
         for (const auto& streams : m_send) {
-            std::vector<SimulcastStreamInfo> streams_cloned;
+            SimulcastStreams streams_cloned;
             for (const auto& stream : streams)
                 streams_cloned.push_back(stream->Clone());
             cloned->AddSimulcastAlternativeStreams(DirectionWay::Send, std::move(streams_cloned));
         }
         for (const auto& streams : m_recv) {
-            std::vector<SimulcastStreamInfo> streams_cloned;
+            SimulcastStreams streams_cloned;
             for (const auto& stream : streams)
                 streams_cloned.push_back(stream->Clone());
             cloned->AddSimulcastAlternativeStreams(DirectionWay::Recv, std::move(streams_cloned));
@@ -54,7 +55,7 @@ class CSimulcastInfo {
      * @param [in] direction Which direction you want the streams for
      * @param [in] streams Stream info of all the alternatives
      */
-    void AddSimulcastAlternativeStreams(DirectionWay direction, std::vector<SimulcastStreamInfo>&& streams) {
+    void AddSimulcastAlternativeStreams(DirectionWay direction, SimulcastStreams&& streams) {
         if (direction == DirectionWay::Send)
             m_send.push_back(std::move(streams));
         else if (direction == DirectionWay::Recv)
@@ -67,7 +68,7 @@ class CSimulcastInfo {
      * @param [in] stream Stream info of the single alternative
      */
     void AddSimulcastStream(DirectionWay direction, SimulcastStreamInfo&& stream) {
-        std::vector<SimulcastStreamInfo> streams;
+        SimulcastStreams streams;
         streams.push_back(std::move(stream));
         if (direction == DirectionWay::Send)
             m_send.push_back(std::move(streams));
@@ -80,7 +81,7 @@ class CSimulcastInfo {
      * @param [in] direction Which direction you want the streams for
      * @returns streams
      */
-    const std::vector<std::vector<SimulcastStreamInfo>>* GetSimulcastStreams(DirectionWay direction) const {
+    const memory::Vector<SimulcastStreams>* GetSimulcastStreams(DirectionWay direction) const {
         if (direction == DirectionWay::Send)
             return &m_send;
         else if (direction == DirectionWay::Recv)
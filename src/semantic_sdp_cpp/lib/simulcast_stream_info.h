@@ -3,9 +3,11 @@
 #pragma once
 
 #include <string>
+#include <string_view>
 #include <memory>
 
 #include "./util.h"
+#include "./memory.h"
 #include "./direction_way.h"
 
 namespace semantic_sdp {
@@ -16,9 +18,9 @@ using SimulcastStreamInfo = std::unique_ptr<CSimulcastStreamInfo>;
 /**
  * Simulcast streams info
  */
-class CSimulcastStreamInfo {
+class CSimulcastStreamInfo : public memory::CAllocated {
  private:
-    std::string     m_id;
+    memory::String  m_id;
     bool            m_paused;
 
  public:
@@ -27,7 +29,7 @@ class CSimulcastStreamInfo {
      * @param [in] id rid for this simulcast stream
      * @param [in] paused If this stream is initially paused
      */
-    CSimulcastStreamInfo(const std::string& id, const bool paused)
+    CSimulcastStreamInfo(std::string_view id, const bool paused)
     : m_id(id)
     , m_paused(paused)
     {}
@@ -37,6 +39,7 @@ class CSimulcastStreamInfo {
      * @returns simulcast stream info
      */
     SimulcastStreamInfo Clone() const {
+        memory::COperation operation(memory::Operation::Clone);
         return std::make_unique<CSimulcastStreamInfo>(m_id, m_paused);
     }
 
@@ -57,4 +60,6 @@ class CSimulcastStreamInfo {
     }
 };
 
+using SimulcastStreams = memory::Vector<SimulcastStreamInfo>;
+
 }    // namespace semantic_sdp
@@ -2,24 +2,83 @@
 
 #pragma once
 
+#include <cstdint>
 #include <string>
+#include <string_view>
 #include <memory>
-#include <vector>
+#include <span>
+#include <utility>
 
+#include "./atom.h"
 #include "./util.h"
+#include "./memory.h"
 
 namespace semantic_sdp {
 
+/**
+ * Enum for source group semantics values.
+ */
+enum class SourceGroupSemantics : uint8_t {
+    FID,
+    FEC,
+    FECFR,
+    SIM,
+    Other,
+};
+
+namespace source_group_semantics {
+
+/**
+ * Get source group semantics by name
+ * @param [in] semantics name (case insensitive)
+ * @returns semantics, Other if it is not a well known one
+ */
+constexpr SourceGroupSemantics ByValue(std::string_view semantics) {
+    if (iequals(semantics, "FID"))
+        return SourceGroupSemantics::FID;
+    if (iequals(semantics, "FEC"))
+        return SourceGroupSemantics::FEC;
+    if (iequals(semantics, "FEC-FR"))
+        return SourceGroupSemantics::FECFR;
+    if (iequals(semantics, "SIM"))
+        return SourceGroupSemantics::SIM;
+    return SourceGroupSemantics::Other;
+}
+
+/**
+ * Get source group semantics name
+ * @param [in] semantics
+ * @returns string
+ */
+constexpr std::string_view ToString(const SourceGroupSemantics semantics) {
+    switch (semantics) {
+        case SourceGroupSemantics::FID:
+            return "FID";
+        case SourceGroupSemantics::FEC:
+            return "FEC";
+        case SourceGroupSemantics::FECFR:
+            return "FEC-FR";
+        case SourceGroupSemantics::SIM:
+            return "SIM";
+        default:
+            return "";
+    }
+    return "";
+}
+
+}    // namespace source_group_semantics
+
 class CSourceGroupInfo;
 using SourceGroupInfo = std::unique_ptr<CSourceGroupInfo>;
 
 /**
  * Group of SSRCS info
  */
-class CSourceGroupInfo {
+class CSourceGroupInfo : public memory::CAllocated {
  private:
-    std::string         m_semantics;
-    std::vector<int>    m_ssrcs;
+    Atom                    m_semantics;
+    SourceGroupSemantics    m_type;
+    memory::Vector<int>     m_ssrcs;
 
  public:
     /**
@@ -27,9 +86,10 @@ class CSourceGroupInfo {
      * @param [in] semantics Group semantics
      * @param [in] ssrcs SSRC list
      */
-    CSourceGroupInfo(const std::string& semantics, const std::vector<int>& ssrcs)
-    : m_semantics(semantics)
-    , m_ssrcs(ssrcs)
+    CSourceGroupInfo(Atom semantics, std::span<const int> ssrcs)
+    : m_semantics(std::move(semantics))
+    , m_type(source_group_semantics::ByValue(m_semantics))
+    , m_ssrcs(ssrcs.begin(), ssrcs.end())
     {}
 
     /**
@@ -37,6 +97,7 @@ class CSourceGroupInfo {
      * @returns source group info
      */
     SourceGroupInfo Clone() const {
+        memory::COperation operation(memory::Operation::Clone);
         return std::make_unique<CSourceGroupInfo>(m_semantics, m_ssrcs);
     }
 
@@ -48,6 +109,14 @@ class CSourceGroupInfo {
         return m_semantics;
     }
 
+    /**
+     * Get group semantics as classified when the group was created
+     * @returns semantics, Other if it is not a well known one
+     */
+    auto GetSemanticsType() const {
+        return m_type;
+    }
+
     /**
      * Get list of ssrcs from this group
      * @returns list of ssrcs
@@ -3,9 +3,11 @@
 #pragma once
 
 #include <string>
+#include <string_view>
 #include <memory>
 
 #include "./util.h"
+#include "./memory.h"
 
 namespace semantic_sdp {
 
@@ -15,12 +17,12 @@ using SourceInfo = std::unique_ptr<CSourceInfo>;
 /**
  * Strem Source information
  */
-class CSourceInfo {
+class CSourceInfo : public memory::CAllocated {
  private:
     int             m_ssrc;
-    std::string     m_track_id;
-    std::string     m_cname;
-    std::string     m_stream_id;
+    memory::String  m_track_id;
+    memory::String  m_cname;
+    memory::String  m_stream_id;
 
  public:
     /**
@@ -36,6 +38,7 @@ class CSourceInfo {
      * @returns source info
      */
     SourceInfo Clone() const {
+        memory::COperation operation(memory::Operation::Clone);
         auto clone = std::make_unique<CSourceInfo>(m_ssrc);
         clone->SetCName(m_cname);
         clone->SetStreamId(m_stream_id);
@@ -47,7 +50,7 @@ class CSourceInfo {
      * Get source CName
      * @returns CName
      */
-    const std::string& GetCName() const {
+    const memory::String& GetCName() const {
         return m_cname;
     }
 
@@ -55,7 +58,7 @@ class CSourceInfo {
      * Set source CName
      * @param [in] cname
      */
-    void SetCName(const std::string& cname) {
+    void SetCName(std::string_view cname) {
         m_cname = cname;
     }
 
@@ -63,7 +66,7 @@ class CSourceInfo {
      * Get associated stream id
      * @returns stream id
      */
-    auto GetStreamId() const {
+    const auto& GetStreamId() const {
         return m_stream_id;
     }
 
@@ -71,7 +74,7 @@ class CSourceInfo {
      * Set associated stream id for this ssrc
      * @param [in] stream_id
      */
-    void SetStreamId(const std::string& stream_id) {
+    void SetStreamId(std::string_view stream_id) {
         m_stream_id = stream_id;
     }
 
@@ -79,7 +82,7 @@ class CSourceInfo {
      * Get associated track id
      * @returns track id
      */
-    auto GetTrackId() const {
+    const auto& GetTrackId() const {
         return m_track_id;
     }
 
@@ -87,7 +90,7 @@ class CSourceInfo {
      * Set associated track id for this ssrc
      * @param [in] track_id
      */
-    void SetTrackId(const std::string& track_id) {
+    void SetTrackId(std::string_view track_id) {
         m_track_id = track_id;
     }
 
@@ -0,0 +1,225 @@
+// "Copyright 2024 <Oldnick85>"
+
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+
+#include "./util.h"
+#include "./memory.h"
+#include "./track_info.h"
+
+namespace semantic_sdp {
+
+class CStreamInfo;
+
+/**
+ * Role of an SSRC within its track, given by the source groups of the track
+ */
+enum class SSRCRole : uint8_t {
+    Media,
+    // Repair stream of a FID group
+    RTX,
+    // Repair stream of a FEC or FEC-FR group
+    FEC,
+};
+
+/**
+ * Session wide reverse index from SSRC to the stream, track and source group it belongs to.
+ * Open addressing with linear probing over a power of two table, removed slots are kept as tombstones
+ * until the next rehash. Entries point into the model, so the index must be told about every track
+ * added or removed (CSDPInfo and CStreamInfo do that).
+ */
+class CSSRCIndex {
+ public:
+    static constexpr uint8_t kNoLayer = 0xFF;
+
+    /**
+     * What an SSRC belongs to
+     */
+    struct SEntry {
+        uint32_t                    ssrc{0};
+        SSRCRole                    role{SSRCRole::Media};
+        // Position in the SIM group of the track, kNoLayer if the track is not simulcast
+        uint8_t                     layer{kNoLayer};
+        // Media SSRC a repair stream protects, the SSRC itself for media
+        uint32_t                    primary{0};
+        const CStreamInfo*          stream{nullptr};
+        const CTrackInfo*           track{nullptr};
+        // FID/FEC group of a repair stream, SIM group of a simulcast layer, otherwise nullptr
+        const CSourceGroupInfo*     group{nullptr};
+    };
+
+ private:
+    enum class SlotState : uint8_t {
+        Empty,
+        Full,
+        Deleted,
+    };
+
+    struct SSlot {
+        SEntry      entry;
+        SlotState   state{SlotState::Empty};
+    };
+
+    static constexpr std::size_t kMinCapacity = 16;
+
+    memory::Vector<SSlot>   m_slots;
+    std::size_t             m_size{0};
+    std::size_t             m_used{0};    // full and deleted slots
+
+    const SSlot* FindSlot(const uint32_t ssrc) const {
+        if (m_slots.empty())
+            return nullptr;
+        const auto mask = m_slots.size() - 1;
+        for (auto i = Hash(ssrc) & mask;; i = (i + 1) & mask) {
+            const auto& slot = m_slots[i];
+            if (slot.state == SlotState::Empty)
+                return nullptr;
+            if ((slot.state == SlotState::Full) && (slot.entry.ssrc == ssrc))
+                return &slot;
+        }
+    }
+
+    void Rehash(const std::size_t capacity) {
+        memory::Vector<SSlot> slots(capacity, SSlot{}, m_slots.get_allocator());
+        slots.swap(m_slots);
+        m_used = m_size;
+        for (const auto& slot : slots) {
+            if (slot.state == SlotState::Full)
+                Place(slot.entry);
+        }
+    }
+
+    void Place(const SEntry& entry) {
+        const auto mask = m_slots.size() - 1;
+        auto i = Hash(entry.ssrc) & mask;
+        while (m_slots[i].state == SlotState::Full)
+            i = (i + 1) & mask;
+        if (m_slots[i].state == SlotState::Empty)
+            ++m_used;
+        m_slots[i].entry = entry;
+        m_slots[i].state = SlotState::Full;
+    }
+
+    bool Insert(const SEntry& entry) {
+        if (Find(entry.ssrc) != nullptr)
+            return false;
+        // Keep the table at most half used, tombstones included
+        if ((m_used + 1) * 2 > m_slots.size()) {
+            auto capacity = std::max(kMinCapacity, m_slots.size());
+            while ((m_size + 1) * 2 > capacity / 2)
+                capacity *= 2;
+            Rehash(capacity);
+        }
+        Place(entry);
+        ++m_size;
+        return true;
+    }
+
+ public:
+    /**
+     * Hash of an SSRC for open addressing tables
+     * @param [in] ssrc
+     * @returns hash
+     */
+    static std::size_t Hash(const uint32_t ssrc) {
+        // SSRCs are random but may be chosen sequentially by some endpoints, mix them
+        return static_cast<std::size_t>((static_cast<uint64_t>(ssrc) * 0x9E3779B97F4A7C15ULL) >> 32);
+    }
+
+    /**
+     * Find what an SSRC belongs to
+     * @param [in] ssrc
+     * @returns entry or nullptr if no track has the SSRC
+     */
+    const SEntry* Find(const uint32_t ssrc) const {
+        const auto* slot = FindSlot(ssrc);
+        return (slot != nullptr) ? &slot->entry : nullptr;
+    }
+
+    /**
+     * Index the SSRCs of a track, its SSRCs and groups must not change while it is indexed
+     * @param [in] stream stream holding the track
+     * @param [in] track
+     * @returns false if an SSRC was already taken by another track, it stays with that track
+     */
+    bool AddTrack(const CStreamInfo& stream, const CTrackInfo& track) {
+        const auto* sim_group = track.getSourceGroup(SourceGroupSemantics::SIM);
+        const auto* sim = (sim_group != nullptr) ? sim_group->get() : nullptr;
+        bool added = true;
+        for (const auto ssrc : track.GetSSRCs()) {
+            SEntry entry;
+            entry.ssrc = static_cast<uint32_t>(ssrc);
+            entry.primary = entry.ssrc;
+            entry.stream = &stream;
+            entry.track = &track;
+            for (const auto& group : track.GetSourceGroups()) {
+                const auto& ssrcs = group->GetSSRCs();
+                if ((ssrcs.size() < 2) || (ssrcs.front() == ssrc) ||
+                    (std::find(ssrcs.begin() + 1, ssrcs.end(), ssrc) == ssrcs.end()))
+                    continue;
+                switch (group->GetSemanticsType()) {
+                    case SourceGroupSemantics::FID:
+                        entry.role = SSRCRole::RTX;
+                        break;
+                    case SourceGroupSemantics::FEC:
+                    case SourceGroupSemantics::FECFR:
+                        entry.role = SSRCRole::FEC;
+                        break;
+                    default:
+                        continue;
+                }
+                entry.primary = static_cast<uint32_t>(ssrcs.front());
+                entry.group = group.get();
+                break;
+            }
+            if (sim != nullptr) {
+                const auto& layers = sim->GetSSRCs();
+                const auto layer_it = std::find(layers.begin(), layers.end(), static_cast<int>(entry.primary));
+                if (layer_it != layers.end()) {
+                    const auto layer = std::min<std::ptrdiff_t>(layer_it - layers.begin(), kNoLayer - 1);
+                    entry.layer = static_cast<uint8_t>(layer);
+                    if (entry.group == nullptr)
+                        entry.group = sim;
+                }
+            }
+            added = Insert(entry) && added;
+        }
+        return added;
+    }
+
+    /**
+     * Remove the SSRCs of a track from the index
+     * @param [in] track
+     */
+    void RemoveTrack(const CTrackInfo& track) {
+        for (const auto ssrc : track.GetSSRCs()) {
+            auto* slot = const_cast<SSlot*>(FindSlot(static_cast<uint32_t>(ssrc)));
+            if ((slot == nullptr) || (slot->entry.track != &track))
+                continue;
+            slot->state = SlotState::Deleted;
+            --m_size;
+        }
+    }
+
+    /**
+     * Remove all entries
+     */
+    void clear() {
+        m_slots.clear();
+        m_size = 0;
+        m_used = 0;
+    }
+
+    std::size_t size() const {
+        return m_size;
+    }
+
+    bool empty() const {
+        return m_size == 0;
+    }
+};
+
+}    // namespace semantic_sdp
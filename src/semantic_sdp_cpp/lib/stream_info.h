@@ -2,13 +2,18 @@
 
 #pragma once
 
+#include <algorithm>
+#include <array>
+#include <cstddef>
 #include <string>
-#include <unordered_map>
+#include <string_view>
 #include <memory>
 #include <utility>
 
 #include "./util.h"
+#include "./memory.h"
 #include "./track_info.h"
+#include "./ssrc_index.h"
 
 namespace semantic_sdp {
 
@@ -18,20 +23,46 @@ using StreamInfo = std::unique_ptr<CStreamInfo>;
 /**
  * Media Stream information
  */
-class CStreamInfo {
+class CStreamInfo : public memory::CAllocated {
  public:
-    using Tracks = std::unordered_map<std::string, TrackInfo>;
+    using Tracks = memory::StringMap<TrackInfo>;
 
  private:
-    std::string        m_id;
-    Tracks            m_tracks;
+    memory::String  m_id;
+    Tracks          m_tracks;
+    // Index of the session the stream belongs to, kept up to date when tracks come and go
+    CSSRCIndex*     m_ssrc_index{nullptr};
+    // Tracks in the order they were added
+    memory::Vector<const TrackInfo*>    m_order;
+    // Earliest added track of each media kind, by MediaType::Type
+    std::array<const TrackInfo*, static_cast<std::size_t>(MediaType::Type::other) + 1> m_first_tracks{};
+
+    static std::size_t Kind(const MediaType media) {
+        return static_cast<std::size_t>(media.GetType());
+    }
+
+    static std::size_t Kind(const TrackType media) {
+        return (media.GetType() == TrackType::Type::video) ? Kind(MediaType(MediaType::Type::video))
+                                                           : Kind(MediaType(MediaType::Type::audio));
+    }
+
+    void IndexKind(const MediaType media) {
+        auto& first = m_first_tracks[Kind(media)];
+        first = nullptr;
+        for (const auto* track : m_order) {
+            if ((*track)->GetMedia() == media) {
+                first = track;
+                return;
+            }
+        }
+    }
 
  public:
     /**
      * constructor for StreamInfo
      * @param [in] id
      */
-    explicit CStreamInfo(const std::string& id)
+    explicit CStreamInfo(std::string_view id)
     : m_id(id)
     {}
 
@@ -40,9 +71,10 @@ class CStreamInfo {
      * @returns stream info
      */
     StreamInfo Clone() const {
+        memory::COperation operation(memory::Operation::Clone);
         auto cloned = std::make_unique<CStreamInfo>(m_id);
-        for (const auto& track_it : m_tracks)
-            cloned->AddTrack(track_it.second->Clone());
+        for (const auto* track : m_order)
+            cloned->AddTrack((*track)->Clone());
         return cloned;
     }
 
@@ -55,11 +87,27 @@ class CStreamInfo {
     }
 
     /**
-     * Add media track
+     * Attach the SSRC index of the session, set by CSDPInfo when the stream is added to it
+     * @param [in] index index or nullptr to detach
+     */
+    void SetSSRCIndex(CSSRCIndex* index) {
+        m_ssrc_index = index;
+    }
+
+    /**
+     * Add media track, its SSRCs and source groups must be set before
      * @param [in] track
      */
     void AddTrack(TrackInfo&& track) {
-        m_tracks.emplace(track->GetId(), std::move(track));
+        const auto [track_it, inserted] = m_tracks.emplace(track->GetId(), std::move(track));
+        if (!inserted)
+            return;
+        m_order.push_back(&track_it->second);
+        auto& first = m_first_tracks[Kind(track_it->second->GetMedia())];
+        if (first == nullptr)
+            first = &track_it->second;
+        if (m_ssrc_index != nullptr)
+            m_ssrc_index->AddTrack(*this, *track_it->second);
     }
 
     /**
@@ -68,7 +116,7 @@ class CStreamInfo {
      * @returns if the track was present on track map or not
      */
     void RemoveTrack(const TrackInfo& track) {
-        m_tracks.erase(track->GetId());
+        RemoveTrackById(track->GetId());
     }
 
     /**
@@ -76,29 +124,43 @@ class CStreamInfo {
      * @param [in] track_id Id of the track to remote
      * @returns if the track was present on track map or not
      */
-    void RemoveTrackById(const std::string& track_id) {
-        m_tracks.erase(track_id);
+    void RemoveTrackById(std::string_view track_id) {
+        const auto track_it = m_tracks.find(track_id);
+        if (track_it == m_tracks.end())
+            return;
+        if (m_ssrc_index != nullptr)
+            m_ssrc_index->RemoveTrack(*track_it->second);
+        const auto media = track_it->second->GetMedia();
+        const bool first = (m_first_tracks[Kind(media)] == &track_it->second);
+        m_order.erase(std::find(m_order.begin(), m_order.end(), &track_it->second));
+        m_tracks.erase(track_it);
+        if (first)
+            IndexKind(media);
     }
+
     /**
-     * Get first track for the media type
+     * Get first track for the media type, the earliest added one still in the stream
      * @param [in] media Track type
      * @returns track info
      */
-    const TrackInfo* GetFirstTrack(const TrackType& media) {
-        const auto media_type = to_lower_case_copy(media.type_str());
-        for (const auto& track_it : m_tracks) {
-            auto type = track_it.second->GetMedia().type_str();
-            if (to_lower_case_copy(type) == media_type)
-                return &track_it.second;
-        }
-        return nullptr;
+    const TrackInfo* GetFirstTrack(const TrackType media) const {
+        return m_first_tracks[Kind(media)];
+    }
+
+    /**
+     * Get first track for the media type, the earliest added one still in the stream
+     * @param [in] media Media type
+     * @returns track info
+     */
+    const TrackInfo* GetFirstTrack(const MediaType media) const {
+        return m_first_tracks[Kind(media)];
     }
 
     /**
      * Get all tracks from the media stream
      * @returns all tracks
      */
-    const auto& GetTracks() {
+    const auto& GetTracks() const {
         return m_tracks;
     }
 
@@ -106,7 +168,13 @@ class CStreamInfo {
      * Remove all tracks from media sream
      */
     void RemoveAllTracks() {
+        if (m_ssrc_index != nullptr) {
+            for (const auto& track_it : m_tracks)
+                m_ssrc_index->RemoveTrack(*track_it.second);
+        }
         m_tracks.clear();
+        m_order.clear();
+        m_first_tracks = {};
     }
 
     /**
@@ -114,7 +182,7 @@ class CStreamInfo {
      * @param [in] track_id
      * @returns track info
      */
-    const TrackInfo* GetTrack(const std::string& track_id) {
+    const TrackInfo* GetTrack(std::string_view track_id) const {
         auto track_it = m_tracks.find(track_id);
         if (track_it != m_tracks.end())
             return &track_it->second;
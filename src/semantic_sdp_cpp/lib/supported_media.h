@@ -0,0 +1,184 @@
+// "Copyright 2024 <Oldnick85>"
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <memory>
+#include <optional>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+#include "./atom.h"
+#include "./util.h"
+#include "./memory.h"
+#include "./codec_info.h"
+#include "./rtcp_feedback_info.h"
+#include "./data_channel_info.h"
+#include "./h264_profile.h"
+
+namespace semantic_sdp {
+
+struct sSupportedMedia {
+    CodecsMap                        codecs;
+    std::vector<Atom>               extensions;
+    bool                            simulcast;
+    std::vector<CRTCPFeedbackInfo>    rtcpfbs;
+    bool                            rtx;
+    DataChannelInfo                    datachannel;
+};
+using SupportedMedia = std::unique_ptr<sSupportedMedia>;
+
+class CSupportedMediaProfile;
+using SupportedMediaProfile = std::unique_ptr<CSupportedMediaProfile>;
+
+/**
+ * Supported media capabilities prepared once for answering many offers.
+ * Codec names are normalized, the parameters deciding codec compatibility are parsed
+ * and extension URIs are hashed, so answering an m-line does no string processing
+ * beyond the lookups.
+ */
+class CSupportedMediaProfile {
+ private:
+    /**
+     * Codec family needing extra format parameter checks
+     */
+    enum class Family : uint8_t {
+        Other,
+        H264,
+        MultiOpus,
+    };
+
+    /**
+     * Supported codec with its precomputed matching parameters
+     */
+    struct SCodec {
+        CodecInfo                   codec;
+        Family                      family{Family::Other};
+    };
+
+    // Keyed by the lower case codec name
+    using CodecsByName = std::unordered_map<Atom, std::vector<SCodec>>;
+
+    CodecsByName                m_codecs;
+    std::unordered_set<Atom>    m_extensions;
+    bool                        m_simulcast{false};
+    DataChannelInfo             m_data_channel;
+
+ public:
+    /**
+     * constructor for CSupportedMediaProfile
+     * @param [in] supported Supported codecs and extensions to be included on answers
+     */
+    explicit CSupportedMediaProfile(const sSupportedMedia& supported)
+    : m_simulcast(supported.simulcast) {
+        for (const auto& supported_it : supported.codecs) {
+            // Build each entry from its own supported codec, so variants of the same codec keep their parameters
+            auto codecs = MapFromNames(std::vector<std::string>{std::string(supported_it.second->GetCodec())},
+                                       supported.rtx, supported.rtcpfbs);
+            if (codecs.empty())
+                continue;
+            SCodec entry;
+            entry.codec = std::move(codecs.begin()->second);
+            auto name = entry.codec->GetCodec().Folded();
+            // Keep the format parameters the application configured for this codec
+            entry.codec->AddParams(*supported_it.second);
+            if (name == "h264")
+                entry.family = Family::H264;
+            else if (name == "multiopus")
+                entry.family = Family::MultiOpus;
+            // Intern the configured names so lookups of offered names in the vocabulary compare pointers
+            m_codecs[Atom::Intern(name)].push_back(std::move(entry));
+        }
+        for (const auto& extension : supported.extensions)
+            m_extensions.insert(Atom::Intern(extension));
+        if (supported.datachannel != nullptr)
+            m_data_channel = supported.datachannel->Clone();
+    }
+
+    /**
+     * Find the supported codec an offered codec can be answered with
+     * @param [in] offered Offered codec
+     * @returns supported codec or nullptr if none matches
+     */
+    const CCodecInfo* Match(const CCodecInfo& offered) const {
+        const auto codecs_it = m_codecs.find(offered.GetCodec().Folded());
+        if (codecs_it == m_codecs.end())
+            return nullptr;
+        const auto& offered_params = offered.GetFormatParams();
+        for (const auto& entry : codecs_it->second) {
+            const auto& params = entry.codec->GetFormatParams();
+            if (entry.family == Family::H264) {
+                // Check packetization mode, 0 when not set
+                if (params.packetization_mode
+                    && (offered_params.packetization_mode.value_or(0) != *params.packetization_mode))
+                    continue;
+                // Check the offered profile is decodable, an entry without profile-level-id takes any
+                if (params.profile_level_id && !h264::Answer(params, offered_params))
+                    continue;
+            } else if (entry.family == Family::MultiOpus) {
+                // Check num_streams
+                if (params.num_streams && offered_params.num_streams
+                    && (*offered_params.num_streams != *params.num_streams))
+                    continue;
+            }
+            return entry.codec.get();
+        }
+        return nullptr;
+    }
+
+    /**
+     * Check if a header extension is supported
+     * @param [in] uri Extension URI
+     * @returns boolean
+     */
+    bool IsExtensionSupported(const Atom& uri) const {
+        return (m_extensions.find(uri) != m_extensions.end());
+    }
+
+    /**
+     * Check if simulcast is supported
+     * @returns boolean
+     */
+    bool IsSimulcastSupported() const {
+        return m_simulcast;
+    }
+
+    /**
+     * Get supported datachannel info
+     * @returns data channel info, nullptr if datachannels are not supported
+     */
+    const auto& GetDataChannel() const {
+        return m_data_channel;
+    }
+};
+
+/**
+ * Capability profiles for answering a whole session, one per media type.
+ * Media of a type without a profile is answered as inactive.
+ */
+struct sSupportedProfiles {
+    const CSupportedMediaProfile*   audio{nullptr};
+    const CSupportedMediaProfile*   video{nullptr};
+    const CSupportedMediaProfile*   application{nullptr};
+
+    /**
+     * Get profile for a media type
+     * @param [in] type Media type
+     * @returns profile or nullptr if the media type is not supported
+     */
+    const CSupportedMediaProfile* Get(const MediaType type) const {
+        switch (type.GetType()) {
+        case MediaType::Type::audio:        return audio;
+        case MediaType::Type::video:        return video;
+        case MediaType::Type::application:  return application;
+        default:                            break;
+        }
+        return nullptr;
+    }
+};
+
+}    // namespace semantic_sdp
@@ -3,11 +3,12 @@
 #pragma once
 
 #include <string>
+#include <string_view>
 #include <memory>
 #include <utility>
-#include <vector>
 
 #include "./util.h"
+#include "./memory.h"
 #include "./codec_info.h"
 
 namespace semantic_sdp {
@@ -17,9 +18,9 @@ using TrackEncodingInfo = std::unique_ptr<CTrackEncodingInfo>;
 /**
  * Simulcast encoding layer information for track
  */
-class CTrackEncodingInfo {
+class CTrackEncodingInfo : public memory::CAllocated {
  private:
-    std::string     m_id;
+    memory::String  m_id;
     bool            m_paused;
     CodecsMap       m_codecs;
     ParamsMap       m_params;
@@ -30,7 +31,7 @@ class CTrackEncodingInfo {
      * @param [in] id rid value
      * @param [in] paused
      */
-    explicit CTrackEncodingInfo(const std::string& id, bool paused = false)
+    explicit CTrackEncodingInfo(std::string_view id, bool paused = false)
     : m_id(id)
     , m_paused(paused)
     {}
@@ -40,6 +41,7 @@ class CTrackEncodingInfo {
      * @returns track encoding info
      */
     TrackEncodingInfo Clone() const {
+        memory::COperation operation(memory::Operation::Clone);
         auto cloned = std::make_unique<CTrackEncodingInfo>(m_id, m_paused);
         for (const auto& codec_it : m_codecs)
             cloned->AddCodec(codec_it.second->Clone());
@@ -94,7 +96,7 @@ class CTrackEncodingInfo {
      * @param [in] id
      * @param [in] param
      */
-    void AddParam(const std::string& id, const std::string& param) {
+    void AddParam(std::string_view id, std::string_view param) {
         m_params.emplace(id, param);
     }
 
@@ -107,7 +109,7 @@ class CTrackEncodingInfo {
     }
 };
 
-using EncodingsList = std::vector<TrackEncodingInfo>;
-using EncodingsListList = std::vector<EncodingsList>;
+using EncodingsList = memory::Vector<TrackEncodingInfo>;
+using EncodingsListList = memory::Vector<EncodingsList>;
 
 }    // namespace semantic_sdp
@@ -2,12 +2,16 @@
 
 #pragma once
 
+#include <array>
+#include <cstdint>
 #include <string>
+#include <string_view>
 #include <memory>
-#include <vector>
 #include <utility>
 
 #include "./util.h"
+#include "./memory.h"
+#include "./source_group_info.h"
 #include "./track_encoding_info.h"
 
 namespace semantic_sdp {
@@ -18,17 +22,21 @@ using TrackInfo = std::unique_ptr<CTrackInfo>;
 /**
  * Media Track information
  */
-class CTrackInfo {
+class CTrackInfo : public memory::CAllocated {
  public:
-    using Groups = std::vector<SourceGroupInfo>;
+    using Groups = memory::Vector<SourceGroupInfo>;
 
  private:
     MediaType           m_media;
-    std::string         m_id;
-    std::string         m_media_id;
-    std::vector<int>    m_ssrcs;
+    memory::String      m_id;
+    memory::String      m_media_id;
+    // RTCP CNAME of the sources of the track, empty if not signaled
+    memory::String      m_cname;
+    memory::Vector<int> m_ssrcs;
     Groups              m_groups;
     EncodingsListList   m_encodings;
+    // Position + 1 in m_groups of the first group of each well known semantics, 0 if there is none
+    std::array<uint16_t, static_cast<std::size_t>(SourceGroupSemantics::Other)>    m_group_index{};
 
  public:
     /**
@@ -36,7 +44,7 @@ class CTrackInfo {
      * @param [in] media Media type
      * @param [in] id Track id
      */
-    CTrackInfo(MediaType media, const std::string& id)
+    CTrackInfo(MediaType media, std::string_view id)
     : m_media(media)
     , m_id(id)
     {}
@@ -46,8 +54,10 @@ class CTrackInfo {
      * @returns track info
      */
     TrackInfo Clone() const {
+        memory::COperation operation(memory::Operation::Clone);
         auto cloned = std::make_unique<CTrackInfo>(m_media, m_id);
         cloned->SetMediaId(m_media_id);
+        cloned->SetCName(m_cname);
         for (const auto& ssrc : m_ssrcs)
             cloned->AddSSRC(ssrc);
         for (const auto& group : m_groups)
@@ -66,7 +76,7 @@ class CTrackInfo {
      * Get media type
      * @returns media type
      */
-    const auto& GetMedia() const {
+    auto GetMedia() const {
         return m_media;
     }
 
@@ -74,7 +84,7 @@ class CTrackInfo {
      * Set the media line id this track belongs to. Set to null for first media line of the media type
      * @param [in] mediaId MediaInfo id
      */
-    void SetMediaId(const std::string& mediaId) {
+    void SetMediaId(std::string_view mediaId) {
         m_media_id = mediaId;
     }
 
@@ -86,6 +96,22 @@ class CTrackInfo {
         return m_media_id;
     }
 
+    /**
+     * Set RTCP CNAME of the track sources
+     * @param [in] cname
+     */
+    void SetCName(std::string_view cname) {
+        m_cname = cname;
+    }
+
+    /**
+     * Get RTCP CNAME of the track sources
+     * @returns cname, empty if not known
+     */
+    const auto& GetCName() const {
+        return m_cname;
+    }
+
     /**
      * Get track id
      * @returns track id
@@ -115,7 +141,22 @@ class CTrackInfo {
      * @param [in] group
      */
     void AddSourceGroup(SourceGroupInfo&& group) {
+        const auto type = group->GetSemanticsType();
         m_groups.push_back(std::move(group));
+        if ((type != SourceGroupSemantics::Other) && (m_group_index[static_cast<std::size_t>(type)] == 0))
+            m_group_index[static_cast<std::size_t>(type)] = static_cast<uint16_t>(m_groups.size());
+    }
+
+    /**
+     * Get the first source group of a well known semantics
+     * @param [in] semantics Group type, not Other
+     * @returns source group
+     */
+    const SourceGroupInfo* getSourceGroup(const SourceGroupSemantics semantics) const {
+        if (semantics == SourceGroupSemantics::Other)
+            return nullptr;
+        const auto position = m_group_index[static_cast<std::size_t>(semantics)];
+        return (position != 0) ? &m_groups[position - 1] : nullptr;
     }
 
     /**
@@ -123,10 +164,12 @@ class CTrackInfo {
      * @param [in] schematics Group type
      * @returns source group
      */
-    const SourceGroupInfo* getSourceGroup(const std::string& schematics) const {
-        const auto schema = to_lower_case_copy(schematics);
+    const SourceGroupInfo* getSourceGroup(std::string_view schematics) const {
+        const auto semantics = source_group_semantics::ByValue(schematics);
+        if (semantics != SourceGroupSemantics::Other)
+            return getSourceGroup(semantics);
         for (const auto& group : m_groups) {
-            if (to_lower_case_copy(group->GetSemantics()) == schema)
+            if (iequals(group->GetSemantics(), schematics))
                 return &group;
         }
         return nullptr;
@@ -145,11 +188,17 @@ class CTrackInfo {
      * @param [in] schematics
      * @returns boolean
      */
-    bool HasSourceGroup(const std::string& schematics) const {
-        return std::any_of(m_groups.cbegin(), m_groups.cend(),
-                            [&schematics](const SourceGroupInfo& group) {
-                                return eq_case_insensitive(group->GetSemantics(), schematics);
-                                });
+    bool HasSourceGroup(std::string_view schematics) const {
+        return getSourceGroup(schematics) != nullptr;
+    }
+
+    /**
+     * Check if track has a group of a well known semantics
+     * @param [in] semantics
+     * @returns boolean
+     */
+    bool HasSourceGroup(const SourceGroupSemantics semantics) const {
+        return getSourceGroup(semantics) != nullptr;
     }
 
     /**
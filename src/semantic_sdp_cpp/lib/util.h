@@ -2,117 +2,496 @@
 
 #pragma once
 
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <iterator>
+#include <optional>
 #include <string>
-#include <sstream>
+#include <string_view>
+#include <type_traits>
 #include <algorithm>
-#include <cctype>
-#include <locale>
 #include <list>
-#include <random>
 #include <unordered_map>
 #include <vector>
 
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+#include "./memory.h"
+#include "./random.h"
+#include "./hex.h"
+
 namespace semantic_sdp {
 
-using ParamsMap = std::unordered_map<std::string, std::string>;
+using ParamsMap = memory::StringMap<memory::String>;
+
+namespace detail {
+
+inline constexpr uint64_t kByteOnes = 0x0101010101010101ULL;
+
+/**
+ * Load up to 8 characters as a little-endian word, missing bytes are zero.
+ * Same value at compile time and at run time, so hashes of constants may be used as case labels.
+ * @param [in] str
+ * @param [in] size number of characters to load, at most 8
+ * @returns word
+ */
+constexpr uint64_t load_word(const char* str, const std::size_t size = 8) {
+    uint64_t word = 0;
+    if (std::is_constant_evaluated()) {
+        for (std::size_t i = 0; i < size; ++i)
+            word |= static_cast<uint64_t>(static_cast<uint8_t>(str[i])) << (8 * i);
+    } else {
+        std::memcpy(&word, str, size);
+        if constexpr (std::endian::native == std::endian::big)
+            word = __builtin_bswap64(word);
+    }
+    return word;
+}
+
+/**
+ * Lower case of 8 packed ASCII characters without branches, bytes above 0x7F are left as they are
+ * @param [in] word
+ * @returns lower case word
+ */
+constexpr uint64_t to_lower_word(const uint64_t word) {
+    const uint64_t heptets = word & (0x7F * kByteOnes);
+    const uint64_t ge_a = heptets + ((0x80 - 'A') * kByteOnes);
+    const uint64_t gt_z = heptets + ((0x80 - 'Z' - 1) * kByteOnes);
+    const uint64_t upper = (ge_a ^ gt_z) & ~word & (0x80 * kByteOnes);
+    return word | (upper >> 2);
+}
+
+}    // namespace detail
+
+/**
+ * Lower case of an ASCII character, usable in constant expressions
+ * @param [in] c
+ * @returns lower case character
+ */
+constexpr char to_lower_ascii(const char c) {
+    return static_cast<char>(c | (static_cast<int>(static_cast<unsigned char>(c - 'A') < 26) << 5));
+}
+
+/**
+ * ASCII white space check, independent of the C locale
+ * @param [in] c
+ * @returns boolean
+ */
+constexpr bool is_space_ascii(const char c) {
+    return (c == ' ') || (static_cast<unsigned char>(c - '\t') < 5);
+}
+
+/**
+ * ASCII case-insensitive comparison that does not copy its arguments.
+ * Compares 16 characters at a time with SSE2 and 8 at a time otherwise, without branching per character.
+ * @param [in] s1
+ * @param [in] s2
+ * @returns boolean
+ */
+constexpr bool iequals(std::string_view s1, std::string_view s2) {
+    if (s1.size() != s2.size())
+        return false;
+    std::size_t i = 0;
+#if defined(__SSE2__)
+    if (!std::is_constant_evaluated()) {
+        const auto lower = [](const __m128i chars) {
+            const __m128i upper = _mm_and_si128(_mm_cmpgt_epi8(chars, _mm_set1_epi8('A' - 1)),
+                                                _mm_cmplt_epi8(chars, _mm_set1_epi8('Z' + 1)));
+            return _mm_or_si128(chars, _mm_and_si128(upper, _mm_set1_epi8(0x20)));
+        };
+        for (; i + 16 <= s1.size(); i += 16) {
+            const __m128i c1 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(s1.data() + i));
+            const __m128i c2 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(s2.data() + i));
+            if (_mm_movemask_epi8(_mm_cmpeq_epi8(lower(c1), lower(c2))) != 0xFFFF)
+                return false;
+        }
+    }
+#endif
+    uint64_t diff = 0;
+    for (; i + 8 <= s1.size(); i += 8)
+        diff |= detail::to_lower_word(detail::load_word(s1.data() + i))
+              ^ detail::to_lower_word(detail::load_word(s2.data() + i));
+    const auto tail = s1.size() - i;
+    diff |= detail::to_lower_word(detail::load_word(s1.data() + i, tail))
+          ^ detail::to_lower_word(detail::load_word(s2.data() + i, tail));
+    return (diff == 0);
+}
+
+/**
+ * ASCII case-insensitive hash, consistent with iequals
+ * @param [in] str
+ * @returns hash
+ */
+constexpr std::size_t ihash(std::string_view str) {
+    uint64_t hash = 14695981039346656037ULL ^ str.size();
+    std::size_t i = 0;
+    for (; i + 8 <= str.size(); i += 8)
+        hash = (hash ^ detail::to_lower_word(detail::load_word(str.data() + i))) * 1099511628211ULL;
+    hash = (hash ^ detail::to_lower_word(detail::load_word(str.data() + i, str.size() - i))) * 1099511628211ULL;
+    return static_cast<std::size_t>(hash ^ (hash >> 29));
+}
+
+/**
+ * Hash of string keys ignoring ASCII case, allowing lookup by std::string_view
+ */
+struct SCaseInsensitiveHash {
+    using is_transparent = void;
+
+    constexpr std::size_t operator()(std::string_view str) const noexcept {
+        return ihash(str);
+    }
+};
+
+/**
+ * Comparison of string keys ignoring ASCII case
+ */
+struct SCaseInsensitiveEqual {
+    using is_transparent = void;
+
+    constexpr bool operator()(std::string_view s1, std::string_view s2) const noexcept {
+        return iequals(s1, s2);
+    }
+};
+
+/**
+ * Mix a value into a hash, as boost::hash_combine does
+ * @param [in] seed hash so far
+ * @param [in] value hash of the next value
+ * @returns combined hash
+ */
+constexpr std::size_t hash_combine(const std::size_t seed, const std::size_t value) {
+    return seed ^ (value + 0x9E3779B97F4A7C15ULL + (seed << 6) + (seed >> 2));
+}
+
+/**
+ * Cut the token up to the separator from the front of the view, the separator is dropped
+ * @param [in,out] str view to cut from
+ * @param [in] sep separator
+ * @returns token
+ */
+constexpr std::string_view next_token(std::string_view* str, const char sep) {
+    const auto pos = str->find(sep);
+    const auto token = str->substr(0, pos);
+    str->remove_prefix((pos == std::string_view::npos) ? str->size() : pos + 1);
+    return token;
+}
+
+/**
+ * Lazy range of the fields of a string separated by a delimiter.
+ * Fields are views into the string, so it must outlive the range. Empty fields are kept,
+ * an empty string has no fields.
+ */
+class CSplitView {
+ public:
+    class CIterator {
+     private:
+        std::string_view    m_rest;
+        std::string_view    m_token;
+        char                m_delim{0};
+        bool                m_last{true};
+        bool                m_end{true};
+
+        constexpr void Advance() {
+            if (m_last) {
+                m_end = true;
+                return;
+            }
+            const auto pos = m_rest.find(m_delim);
+            m_last = (pos == std::string_view::npos);
+            m_token = next_token(&m_rest, m_delim);
+        }
+
+     public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = std::string_view;
+        using difference_type = std::ptrdiff_t;
+        using pointer = const std::string_view*;
+        using reference = std::string_view;
+
+        constexpr CIterator() = default;
+
+        /**
+         * constructor for CIterator, positioned on the first field
+         * @param [in] str string to split, not empty
+         * @param [in] delim delimiter
+         */
+        constexpr CIterator(std::string_view str, const char delim)
+        : m_rest(str), m_delim(delim), m_last(false), m_end(false) {
+            Advance();
+        }
+
+        constexpr std::string_view operator*() const {
+            return m_token;
+        }
+
+        constexpr CIterator& operator++() {
+            Advance();
+            return *this;
+        }
+
+        constexpr CIterator operator++(int) {
+            auto it = *this;
+            Advance();
+            return it;
+        }
+
+        constexpr bool operator==(const CIterator& other) const {
+            return (m_end == other.m_end) && (m_end || (m_token.data() == other.m_token.data()));
+        }
+    };
 
-class TrackType {
  private:
-    enum class Type {
+    std::string_view    m_str;
+    char                m_delim;
+
+ public:
+    /**
+     * constructor for CSplitView
+     * @param [in] str string to split
+     * @param [in] delim delimiter
+     */
+    constexpr CSplitView(std::string_view str, const char delim)
+    : m_str(str), m_delim(delim)
+    {}
+
+    constexpr CIterator begin() const {
+        return m_str.empty() ? CIterator() : CIterator(m_str, m_delim);
+    }
+
+    constexpr CIterator end() const {
+        return CIterator();
+    }
+};
+
+/**
+ * Split a string lazily, no memory is allocated
+ * @param [in] str string to split, must outlive the result
+ * @param [in] delim delimiter
+ * @returns range of field views
+ */
+constexpr CSplitView split_view(std::string_view str, const char delim) {
+    return CSplitView(str, delim);
+}
+
+// trim from start (view)
+constexpr std::string_view ltrim_view(std::string_view s) {
+    while (!s.empty() && is_space_ascii(s.front()))
+        s.remove_prefix(1);
+    return s;
+}
+
+// trim from end (view)
+constexpr std::string_view rtrim_view(std::string_view s) {
+    while (!s.empty() && is_space_ascii(s.back()))
+        s.remove_suffix(1);
+    return s;
+}
+
+// trim from both ends (view)
+constexpr std::string_view trim_view(std::string_view s) {
+    return rtrim_view(ltrim_view(s));
+}
+
+/**
+ * Kind of a media track, one byte and trivially copyable
+ */
+class TrackType {
+ public:
+    enum class Type : uint8_t {
         audio,
         video,
     };
-    std::string audio_str{"audio"};
-    std::string video_str{"video"};
 
+ private:
     Type    type{Type::audio};
+
  public:
-    const std::string& type_str() const {
+    constexpr TrackType() = default;
+
+    /**
+     * constructor for TrackType
+     * @param [in] type_ track type
+     */
+    constexpr explicit TrackType(const Type type_)
+        : type(type_)
+    {}
+
+    /**
+     * Get track type by name
+     * @param [in] name track type name (case insensitive)
+     * @returns track type or nullopt if unknown
+     */
+    static constexpr std::optional<TrackType> ByValue(std::string_view name) {
+        if (iequals(name, "audio"))
+            return TrackType(Type::audio);
+        if (iequals(name, "video"))
+            return TrackType(Type::video);
+        return std::nullopt;
+    }
+
+    /**
+     * Get track type value
+     * @returns type
+     */
+    constexpr Type GetType() const {
+        return type;
+    }
+
+    /**
+     * Get track type name
+     * @returns name
+     */
+    constexpr std::string_view type_str() const {
         switch (type) {
-        case Type::audio:       return audio_str;
-        case Type::video:       return video_str;
+        case Type::audio:       return "audio";
+        case Type::video:       return "video";
         default:                break;
         }
-        return audio_str;
+        return "audio";
     }
+
+    constexpr bool operator==(const TrackType&) const = default;
 };
 
+/**
+ * Kind of a media description (m-line), one byte and trivially copyable
+ */
 class MediaType {
- private:
-    enum class Type {
+ public:
+    enum class Type : uint8_t {
         audio,
         video,
         application,
+        // Media the library does not model (text, message, image...), CMediaInfo keeps its name
+        other,
     };
-    std::string audio_str{"audio"};
-    std::string video_str{"video"};
-    std::string application_str{"application"};
 
+ private:
     Type    type{Type::audio};
+
  public:
-    const std::string& type_str() const {
+    constexpr MediaType() = default;
+
+    /**
+     * constructor for MediaType
+     * @param [in] type_ media type
+     */
+    constexpr explicit MediaType(const Type type_)
+        : type(type_)
+    {}
+
+    /**
+     * Get media type by name
+     * @param [in] name media type name (case insensitive)
+     * @returns media type or nullopt if it is not one of the modeled types
+     */
+    static constexpr std::optional<MediaType> ByValue(std::string_view name) {
+        if (iequals(name, "audio"))
+            return MediaType(Type::audio);
+        if (iequals(name, "video"))
+            return MediaType(Type::video);
+        if (iequals(name, "application"))
+            return MediaType(Type::application);
+        return std::nullopt;
+    }
+
+    /**
+     * Get media type value
+     * @returns type
+     */
+    constexpr Type GetType() const {
+        return type;
+    }
+
+    /**
+     * Get media type name
+     * @returns name, empty for other
+     */
+    constexpr std::string_view type_str() const {
         switch (type) {
-        case Type::audio:       return audio_str;
-        case Type::video:       return video_str;
-        case Type::application: return application_str;
+        case Type::audio:       return "audio";
+        case Type::video:       return "video";
+        case Type::application: return "application";
         default:                break;
         }
-        return audio_str;
+        return "";
     }
+
+    constexpr bool operator==(const MediaType&) const = default;
 };
 
-std::string bytes_to_hex(const std::vector<uint8_t>& bytes) {
-    std::string s;
-    s.reserve(bytes.size()*2+1);
-    for (const auto byte : bytes) {
-        const auto h = byte / 16;
-        const char hc = (h < 10) ? '0' + h : 'A' + h - 10;
-        s += hc;
-        const auto l = byte % 16;
-        const char lc = (l < 10) ? '0' + l : 'A' + l - 10;
-        s += lc;
-    }
-    return s;
-}
+static_assert((sizeof(TrackType) == 1) && std::is_trivially_copyable_v<TrackType>);
+static_assert((sizeof(MediaType) == 1) && std::is_trivially_copyable_v<MediaType>);
+static_assert(MediaType::ByValue("Video") == MediaType(MediaType::Type::video));
+static_assert(iequals("urn:ietf:params:rtp-hdrext:SDES:MID", "urn:ietf:params:rtp-hdrext:sdes:mid"));
+static_assert(ihash("H264") == ihash("h264"));
 
-std::vector<uint8_t> random_bytes(const std::size_t count) {
-    std::vector<uint8_t> bytes;
-    bytes.reserve(count);
+/**
+ * Write bytes as upper case hex
+ * @param [in] bytes
+ * @param [in] count number of bytes
+ * @param [out] out buffer of 2 * count characters
+ * @returns end of the written text
+ */
+inline char* bytes_to_hex(const uint8_t* bytes, const std::size_t count, char* out) {
+    return hex::Encode(bytes, count, out, hex::Case::Upper);
+}
 
-    std::random_device dev;
-    std::mt19937 rng(dev());
-    std::uniform_int_distribution<std::mt19937::result_type> dist(0, 256);
+/**
+ * Compare byte strings in time that depends on the length only, for secrets such as fingerprints
+ * @param [in] b1
+ * @param [in] b2
+ * @param [in] count number of bytes
+ * @returns boolean
+ */
+inline bool constant_time_equals(const uint8_t* b1, const uint8_t* b2, const std::size_t count) {
+    volatile uint8_t diff = 0;
     for (std::size_t i = 0; i < count; ++i)
-        bytes.push_back(dist(rng));
-
-    return bytes;
+        diff = diff | (b1[i] ^ b2[i]);
+    return diff == 0;
 }
 
-std::string to_lower_case_copy(const std::string &s) {
-    std::string str{s};
-    std::transform(str.begin(), str.end(), str.begin(), ::tolower);
+inline std::string bytes_to_hex(const std::vector<uint8_t>& bytes) {
+    std::string s(bytes.size() * 2, '\0');
+    bytes_to_hex(bytes.data(), bytes.size(), s.data());
     return s;
 }
 
-void to_lower_case(std::string* str) {
+// empty if the system random source failed
+inline std::vector<uint8_t> random_bytes(const std::size_t count) {
+    std::vector<uint8_t> bytes(count);
+    if (!random::Fill(bytes.data(), count))
+        bytes.clear();
+    return bytes;
+}
+
+inline void to_lower_case(std::string* str) {
     if (str == nullptr)
         return;
-    std::transform(str->begin(), str->end(), str->begin(), ::tolower);
+    std::transform(str->begin(), str->end(), str->begin(), to_lower_ascii);
+}
+
+inline std::string to_lower_case_copy(const std::string &s) {
+    std::string str{s};
+    to_lower_case(&str);
+    return str;
 }
 
-bool eq_case_insensitive(const std::string &s1, const std::string &s2) {
-    const auto s1_ = to_lower_case_copy(s1);
-    const auto s2_ = to_lower_case_copy(s2);
-    return (s1_ == s2_);
+inline bool eq_case_insensitive(const std::string &s1, const std::string &s2) {
+    return iequals(s1, s2);
 }
 
-std::list<std::string> split(const std::string &s, char delim) {
+// split into a list of copies, like std::getline a trailing empty field is dropped
+inline std::list<std::string> split(const std::string &s, char delim) {
     std::list<std::string> elems;
-    std::stringstream ss(s);
-    std::string item;
-    while (std::getline(ss, item, delim)) {
-        elems.push_back(item);
-    }
+    for (const auto elem : split_view(s, delim))
+        elems.emplace_back(elem);
+    if (!elems.empty() && elems.back().empty())
+        elems.pop_back();
     return elems;
 }
 
@@ -120,19 +499,14 @@ std::list<std::string> split(const std::string &s, char delim) {
 inline void ltrim(std::string* s) {
     if (s == nullptr)
         return;
-    s->erase(s->begin(), std::find_if(s->begin(), s->end(),
-        [](unsigned char ch) {
-            return !std::isspace(ch);
-        }));
+    s->erase(0, s->size() - ltrim_view(*s).size());
 }
 
 // trim from end (in place)
 inline void rtrim(std::string* s) {
     if (s == nullptr)
         return;
-    s->erase(std::find_if(s->rbegin(), s->rend(), [](unsigned char ch) {
-        return !std::isspace(ch);
-    }).base(), s->end());
+    s->resize(rtrim_view(*s).size());
 }
 
 // trim from both ends (in place)
@@ -0,0 +1,142 @@
+// "Copyright 2024 <Oldnick85>"
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <exception>
+#include <mutex>
+#include <stop_token>
+#include <thread>
+#include <vector>
+
+#include "./allocation_stats.h"
+
+namespace semantic_sdp {
+
+/**
+ * Process wide pool of worker threads for loops over independent items.
+ * Workers are started on first use and kept for later loops. One loop runs on the pool at a time,
+ * a loop started while the pool is busy (or from inside a loop) runs on the calling thread.
+ * An exception thrown by an item stops the loop and is rethrown on the calling thread once all
+ * workers are done with it.
+ */
+class CWorkerPool {
+ public:
+    static constexpr unsigned kMaxWorkers = 64;
+
+ private:
+    using Body = void (*)(const void* context, std::size_t i);
+
+    std::mutex                      m_mutex;
+    std::condition_variable_any     m_wake;
+    std::condition_variable         m_done;
+    std::atomic<bool>               m_busy{false};
+    // Loop being run, set under m_mutex before workers are woken
+    Body                            m_body{nullptr};
+    const void*                     m_context{nullptr};
+    std::size_t                     m_count{0};
+    std::atomic<std::size_t>        m_next{0};
+    memory::Operation               m_operation{memory::Operation::Other};
+    std::exception_ptr              m_error;
+    // Workers still allowed to join the loop and workers running it
+    unsigned                        m_helpers{0};
+    unsigned                        m_active{0};
+    // Last member, so the workers are joined before anything they use is destroyed
+    std::vector<std::jthread>       m_workers;
+
+    void Work() {
+        memory::COperation operation(m_operation);
+        try {
+            for (auto i = m_next++; i < m_count; i = m_next++)
+                m_body(m_context, i);
+        } catch (...) {
+            m_next = m_count;
+            std::lock_guard<std::mutex> lock(m_mutex);
+            if (!m_error)
+                m_error = std::current_exception();
+        }
+    }
+
+    void Run(const std::stop_token stop) {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        while (m_wake.wait(lock, stop, [this]() { return m_helpers > 0; })) {
+            --m_helpers;
+            ++m_active;
+            lock.unlock();
+            Work();
+            lock.lock();
+            if (--m_active == 0)
+                m_done.notify_all();
+        }
+    }
+
+    unsigned Grow(const unsigned workers) {
+        try {
+            while (m_workers.size() < workers)
+                m_workers.emplace_back([this](const std::stop_token stop) { Run(stop); });
+        } catch (...) {
+            // Out of threads or memory, run the loop with the workers there are
+        }
+        return static_cast<unsigned>(std::min<std::size_t>(workers, m_workers.size()));
+    }
+
+ public:
+    CWorkerPool() = default;
+    CWorkerPool(const CWorkerPool&) = delete;
+    CWorkerPool& operator=(const CWorkerPool&) = delete;
+
+    /**
+     * Get the process wide pool
+     * @returns pool
+     */
+    static CWorkerPool& Instance() {
+        static CWorkerPool pool;
+        return pool;
+    }
+
+    /**
+     * Call body for every item, spread over the calling thread and pool workers.
+     * Items are taken in order but may finish in any order, body must be safe to call concurrently.
+     * @param [in] count number of items
+     * @param [in] threads maximum number of threads including the calling one
+     * @param [in] body callable taking the item index
+     */
+    template <typename Function>
+    void ParallelFor(const std::size_t count, const unsigned threads, const Function& body) {
+        const auto workers = static_cast<unsigned>(std::min<std::size_t>({threads, count, kMaxWorkers + 1}));
+        if ((workers <= 1) || m_busy.exchange(true, std::memory_order_acquire)) {
+            for (std::size_t i = 0; i < count; ++i)
+                body(i);
+            return;
+        }
+
+        std::exception_ptr error;
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_body = [](const void* context, const std::size_t i) { (*static_cast<const Function*>(context))(i); };
+            m_context = &body;
+            m_count = count;
+            m_next = 0;
+            m_operation = memory::detail::CurrentOperation();
+            m_helpers = Grow(workers - 1);
+            m_wake.notify_all();
+        }
+        Work();
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            // Workers that did not wake up in time are not needed any more
+            m_helpers = 0;
+            m_done.wait(lock, [this]() { return m_active == 0; });
+            error = std::move(m_error);
+            m_error = nullptr;
+        }
+        m_busy.store(false, std::memory_order_release);
+        if (error)
+            std::rethrow_exception(error);
+    }
+};
+
+}    // namespace semantic_sdp
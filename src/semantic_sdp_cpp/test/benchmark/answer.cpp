@@ -0,0 +1,98 @@
+// "Copyright [2024] <Oldnick85>"
+
+#include <string>
+#include <vector>
+
+#include "benchmark/benchmark.h"
+
+#include "./corpus.h"
+#include "./codec_info.h"
+#include "./media_info.h"
+#include "./sdp_info.h"
+#include "./supported_media.h"
+#include "./h264_profile.h"
+
+static void BM_MapFromNames(benchmark::State& state) {
+    const std::vector<std::string> names{"opus", "vp8", "vp9", "h264;packetization-mode=1;profile-level-id=42e01f"};
+    const auto supported = bench::MakeSupported();
+    for (auto _ : state) {
+        auto codecs = semantic_sdp::MapFromNames(names, true, supported->rtcpfbs);
+        benchmark::DoNotOptimize(codecs);
+    }
+}
+BENCHMARK(BM_MapFromNames);
+
+static void BM_H264ProfileAnswer(benchmark::State& state) {
+    const char* offered[] = {"42e01f", "42001f", "4d0028", "640c34", "640028", "f40032"};
+    std::vector<semantic_sdp::FormatParams> remote(std::size(offered));
+    for (std::size_t i = 0; i < remote.size(); ++i)
+        remote[i].Set("profile-level-id", offered[i]);
+    semantic_sdp::FormatParams local;
+    local.Set("profile-level-id", "640c34");
+    local.Set("level-asymmetry-allowed", "1");
+    for (auto _ : state) {
+        for (const auto& params : remote)
+            benchmark::DoNotOptimize(semantic_sdp::h264::Answer(local, params));
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * remote.size()));
+}
+BENCHMARK(BM_H264ProfileAnswer);
+
+static void BM_Answer(benchmark::State& state, const char* name) {
+    const auto sdp = bench::ParseCorpus(name);
+    if (sdp == nullptr) {
+        state.SkipWithError("corpus file is not a valid SDP");
+        return;
+    }
+    const auto supported = bench::MakeSupported();
+    for (auto _ : state) {
+        for (const auto& media : sdp->GetMedias()) {
+            auto answer = media->Answer(supported);
+            benchmark::DoNotOptimize(answer);
+        }
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * sdp->GetMedias().size()));
+}
+BENCHMARK_CAPTURE(BM_Answer, chrome, "chrome_offer.sdp");
+BENCHMARK_CAPTURE(BM_Answer, firefox, "firefox_offer.sdp");
+BENCHMARK_CAPTURE(BM_Answer, simulcast, "simulcast_offer.sdp");
+
+static void BM_AnswerProfile(benchmark::State& state, const char* name) {
+    const auto sdp = bench::ParseCorpus(name);
+    if (sdp == nullptr) {
+        state.SkipWithError("corpus file is not a valid SDP");
+        return;
+    }
+    const semantic_sdp::CSupportedMediaProfile profile(*bench::MakeSupported());
+    for (auto _ : state) {
+        for (const auto& media : sdp->GetMedias()) {
+            auto answer = media->Answer(profile);
+            benchmark::DoNotOptimize(answer);
+        }
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * sdp->GetMedias().size()));
+}
+BENCHMARK_CAPTURE(BM_AnswerProfile, chrome, "chrome_offer.sdp");
+BENCHMARK_CAPTURE(BM_AnswerProfile, firefox, "firefox_offer.sdp");
+BENCHMARK_CAPTURE(BM_AnswerProfile, simulcast, "simulcast_offer.sdp");
+
+static void BM_AnswerSession(benchmark::State& state) {
+    const auto offer = bench::ParseCorpus("chrome_offer.sdp");
+    // Conference offer with the requested number of m-lines
+    semantic_sdp::CSDPInfo sdp;
+    for (int64_t i = 0; i < state.range(0); ++i) {
+        auto media = offer->GetMedias()[i % 2]->Clone();
+        media->SetId(std::to_string(i));
+        sdp.AddMedia(std::move(media));
+    }
+    const semantic_sdp::CSupportedMediaProfile profile(*bench::MakeSupported());
+    semantic_sdp::sSupportedProfiles profiles;
+    profiles.audio = &profile;
+    profiles.video = &profile;
+    for (auto _ : state) {
+        auto answer = sdp.Answer(profiles, static_cast<unsigned>(state.range(1)));
+        benchmark::DoNotOptimize(answer);
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * state.range(0)));
+}
+BENCHMARK(BM_AnswerSession)->ArgsProduct({benchmark::CreateRange(1, 256, 4), {1, 0}})->UseRealTime();
@@ -0,0 +1,62 @@
+// "Copyright [2024] <Oldnick85>"
+
+#pragma once
+
+#include <fstream>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "./codec_info.h"
+#include "./data_channel_info.h"
+#include "./rtcp_feedback_info.h"
+#include "./sdp_info.h"
+#include "./sdp_parser.h"
+#include "./supported_media.h"
+
+namespace bench {
+
+/**
+ * Load SDP text from the benchmark corpus
+ * @param [in] name file name in the corpus directory
+ * @returns file content, empty if it can not be read
+ */
+inline std::string LoadCorpus(const std::string& name) {
+    std::ifstream file(std::string(SDP_CORPUS_DIR) + "/" + name, std::ios::binary);
+    std::stringstream ss;
+    ss << file.rdbuf();
+    return ss.str();
+}
+
+/**
+ * Parse SDP from the benchmark corpus
+ * @param [in] name file name in the corpus directory
+ * @returns SDP info, nullptr if the file is missing or invalid
+ */
+inline semantic_sdp::SDPInfo ParseCorpus(const std::string& name) {
+    return semantic_sdp::sdp::Parse(LoadCorpus(name));
+}
+
+/**
+ * Capabilities of a typical SFU
+ * @returns supported media
+ */
+inline semantic_sdp::SupportedMedia MakeSupported() {
+    auto supported = std::make_unique<semantic_sdp::sSupportedMedia>();
+    supported->codecs = semantic_sdp::MapFromNames(
+        std::vector<std::string>{"opus", "vp8", "h264;packetization-mode=1;profile-level-id=42e01f"}, true, {});
+    supported->extensions = {
+        "urn:ietf:params:rtp-hdrext:ssrc-audio-level",
+        "http://www.webrtc.org/experiments/rtp-hdrext/abs-send-time",
+        "urn:ietf:params:rtp-hdrext:sdes:mid",
+    };
+    supported->simulcast = true;
+    supported->rtcpfbs.emplace_back("nack");
+    supported->rtcpfbs.emplace_back("nack", std::vector{"pli"});
+    supported->rtx = true;
+    supported->datachannel = std::make_unique<semantic_sdp::CDataChannelInfo>(5000, 262144);
+    return supported;
+}
+
+}    // namespace bench
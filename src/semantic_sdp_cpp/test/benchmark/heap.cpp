@@ -0,0 +1,36 @@
+// "Copyright [2024] <Oldnick85>"
+
+#include <cstdlib>
+#include <new>
+
+#include "./heap.h"
+
+namespace {
+
+thread_local uint64_t heap_allocations = 0;
+
+}    // namespace
+
+namespace bench {
+
+uint64_t HeapAllocations() {
+    return heap_allocations;
+}
+
+}    // namespace bench
+
+// Counting replacement of the global allocation functions, the aligned and nothrow forms use these
+void* operator new(const std::size_t size) {
+    ++heap_allocations;
+    if (void* ptr = std::malloc((size != 0) ? size : 1))
+        return ptr;
+    throw std::bad_alloc();
+}
+
+void operator delete(void* ptr) noexcept {
+    std::free(ptr);
+}
+
+void operator delete(void* ptr, std::size_t) noexcept {
+    std::free(ptr);
+}
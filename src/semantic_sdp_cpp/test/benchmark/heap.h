@@ -0,0 +1,15 @@
+// "Copyright [2024] <Oldnick85>"
+
+#pragma once
+
+#include <cstdint>
+
+namespace bench {
+
+/**
+ * Number of global operator new calls made by this thread, defined in heap.cpp
+ * @returns allocation count
+ */
+uint64_t HeapAllocations();
+
+}    // namespace bench
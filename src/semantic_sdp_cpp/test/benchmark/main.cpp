@@ -0,0 +1,123 @@
+// "Copyright [2024] <Oldnick85>"
+
+#include <string>
+
+#include "benchmark/benchmark.h"
+
+#include "./corpus.h"
+#include "./sdp_info.h"
+#include "./sdp_parser.h"
+#include "./sdp_serializer.h"
+#include "./line_scanner.h"
+#include "./memory.h"
+
+static void BM_Parse(benchmark::State& state, const char* name) {
+    const auto sdp = bench::LoadCorpus(name);
+    if (semantic_sdp::sdp::Parse(sdp) == nullptr) {
+        state.SkipWithError("corpus file is not a valid SDP");
+        return;
+    }
+    for (auto _ : state) {
+        auto info = semantic_sdp::sdp::Parse(sdp);
+        benchmark::DoNotOptimize(info);
+    }
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * sdp.size()));
+}
+BENCHMARK_CAPTURE(BM_Parse, chrome, "chrome_offer.sdp");
+BENCHMARK_CAPTURE(BM_Parse, firefox, "firefox_offer.sdp");
+BENCHMARK_CAPTURE(BM_Parse, safari, "safari_offer.sdp");
+BENCHMARK_CAPTURE(BM_Parse, simulcast, "simulcast_offer.sdp");
+BENCHMARK_CAPTURE(BM_Parse, datachannel, "datachannel_offer.sdp");
+BENCHMARK_CAPTURE(BM_Parse, conference, "conference_offer.sdp");
+
+static void BM_ScanLines(benchmark::State& state, const char* name) {
+    const auto sdp = bench::LoadCorpus(name);
+    const auto level = static_cast<semantic_sdp::sdp::ScanLevel>(state.range(0));
+    if (level > semantic_sdp::sdp::DetectScanLevel()) {
+        state.SkipWithError("scan level is not supported by the CPU");
+        return;
+    }
+    semantic_sdp::sdp::LineIndex lines;
+    for (auto _ : state) {
+        semantic_sdp::sdp::ScanLines(sdp, &lines, level);
+        benchmark::DoNotOptimize(lines.data());
+    }
+    state.counters["lines"] = static_cast<double>(lines.size());
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * sdp.size()));
+}
+BENCHMARK_CAPTURE(BM_ScanLines, chrome, "chrome_offer.sdp")->DenseRange(0, 2);
+BENCHMARK_CAPTURE(BM_ScanLines, simulcast, "simulcast_offer.sdp")->DenseRange(0, 2);
+BENCHMARK_CAPTURE(BM_ScanLines, conference, "conference_offer.sdp")->DenseRange(0, 2);
+
+static void BM_ParseCandidate(benchmark::State& state) {
+    const std::string_view line{
+        "a=candidate:842163049 1 udp 1677729535 85.23.12.56 61356 typ srflx raddr 192.168.0.196 rport 61356"};
+    for (auto _ : state) {
+        auto candidate = semantic_sdp::sdp::ParseCandidate(line);
+        benchmark::DoNotOptimize(candidate);
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations()));
+}
+BENCHMARK(BM_ParseCandidate);
+
+static void BM_Trickle(benchmark::State& state) {
+    auto sdp = semantic_sdp::sdp::Parse(bench::LoadCorpus("chrome_offer.sdp"));
+    std::vector<std::string> lines;
+    for (int port = 50000; port < 50000 + 1024; ++port) {
+        lines.push_back("a=candidate:842163049 1 udp 1677729535 85.23.12.56 " + std::to_string(port)
+                        + " typ srflx raddr 192.168.0.196 rport 61356\r\n");
+    }
+    auto* media = sdp->GetMediaById("0")->get();
+    std::size_t index = 0;
+    for (auto _ : state) {
+        // Trickle a burst of candidates into the media, then start over as an ICE restart would
+        if (index == lines.size()) {
+            media->ClearCandidates();
+            index = 0;
+        }
+        benchmark::DoNotOptimize(semantic_sdp::sdp::AddTrickle(sdp.get(), "0", lines[index++]));
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations()));
+}
+BENCHMARK(BM_Trickle);
+
+static void BM_ParseArena(benchmark::State& state, const char* name) {
+    const auto sdp = bench::LoadCorpus(name);
+    semantic_sdp::memory::CArena arena;
+    for (auto _ : state) {
+        {
+            semantic_sdp::memory::CScope scope(arena.GetResource());
+            auto info = semantic_sdp::sdp::Parse(sdp);
+            benchmark::DoNotOptimize(info);
+            arena.Drop(std::move(info));
+        }
+        arena.Release();
+    }
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * sdp.size()));
+}
+BENCHMARK_CAPTURE(BM_ParseArena, chrome, "chrome_offer.sdp");
+BENCHMARK_CAPTURE(BM_ParseArena, conference, "conference_offer.sdp");
+
+static void BM_Serialize(benchmark::State& state, const char* name) {
+    const auto sdp = bench::ParseCorpus(name);
+    if (sdp == nullptr) {
+        state.SkipWithError("corpus file is not a valid SDP");
+        return;
+    }
+    std::string out;
+    semantic_sdp::sdp::Serialize(*sdp, &out);
+    for (auto _ : state) {
+        out.clear();
+        semantic_sdp::sdp::Serialize(*sdp, &out);
+        benchmark::DoNotOptimize(out.data());
+    }
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * out.size()));
+}
+BENCHMARK_CAPTURE(BM_Serialize, chrome, "chrome_offer.sdp");
+BENCHMARK_CAPTURE(BM_Serialize, firefox, "firefox_offer.sdp");
+BENCHMARK_CAPTURE(BM_Serialize, safari, "safari_offer.sdp");
+BENCHMARK_CAPTURE(BM_Serialize, simulcast, "simulcast_offer.sdp");
+BENCHMARK_CAPTURE(BM_Serialize, datachannel, "datachannel_offer.sdp");
+BENCHMARK_CAPTURE(BM_Serialize, conference, "conference_offer.sdp");
+
+BENCHMARK_MAIN();
@@ -0,0 +1,267 @@
+// "Copyright [2024] <Oldnick85>"
+
+#include <algorithm>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "benchmark/benchmark.h"
+
+#include "./corpus.h"
+#include "./candidate_info.h"
+#include "./codec_info.h"
+#include "./crypto_info.h"
+#include "./data_channel_info.h"
+#include "./dtls_info.h"
+#include "./ice_info.h"
+#include "./media_info.h"
+#include "./rid_info.h"
+#include "./rtcp_feedback_info.h"
+#include "./sdp_info.h"
+#include "./simulcast_info.h"
+#include "./simulcast_stream_info.h"
+#include "./source_group_info.h"
+#include "./source_info.h"
+#include "./stream_info.h"
+#include "./track_encoding_info.h"
+#include "./track_info.h"
+
+namespace {
+
+const semantic_sdp::CMediaInfo& ChromeVideo() {
+    static const auto sdp = bench::ParseCorpus("chrome_offer.sdp");
+    return **sdp->GetMediaById("1");
+}
+
+const semantic_sdp::CTrackInfo& ChromeVideoTrack() {
+    static const auto sdp = bench::ParseCorpus("chrome_offer.sdp");
+    return **(*sdp->GetStream("stream0"))->GetTrack("video0");
+}
+
+const semantic_sdp::CMediaInfo& SimulcastVideo() {
+    static const auto sdp = bench::ParseCorpus("simulcast_offer.sdp");
+    return *sdp->GetMedias().front();
+}
+
+}    // namespace
+
+template <typename Make>
+static void BM_Clone(benchmark::State& state, Make make) {
+    const auto object = make();
+    if (object == nullptr) {
+        state.SkipWithError("corpus does not contain the object");
+        return;
+    }
+    for (auto _ : state) {
+        auto cloned = object->Clone();
+        benchmark::DoNotOptimize(cloned);
+    }
+}
+BENCHMARK_CAPTURE(BM_Clone, CandidateInfo, [] {
+    return bench::ParseCorpus("chrome_offer.sdp")->GetMedias().front()->GetCandidates().front()->Clone();
+});
+BENCHMARK_CAPTURE(BM_Clone, CodecInfo, [] { return (*ChromeVideo().GetCodec("vp8"))->Clone(); });
+BENCHMARK_CAPTURE(BM_Clone, CryptoInfo, [] {
+    return std::make_unique<semantic_sdp::CCryptoInfo>(1, "AES_CM_128_HMAC_SHA1_80",
+                                                       "inline:WVNfX19zZW1jdGwgKCkgewkyMjA7fQp9CnVubGVz", "");
+});
+BENCHMARK_CAPTURE(BM_Clone, DataChannelInfo, [] {
+    return bench::ParseCorpus("datachannel_offer.sdp")->GetMedias().front()->GetDataChannel()->Clone();
+});
+BENCHMARK_CAPTURE(BM_Clone, DTLSInfo, [] { return bench::ParseCorpus("chrome_offer.sdp")->GetDTLS()->Clone(); });
+BENCHMARK_CAPTURE(BM_Clone, ICEInfo, [] { return bench::ParseCorpus("chrome_offer.sdp")->GetICE()->Clone(); });
+BENCHMARK_CAPTURE(BM_Clone, MediaInfo, [] { return ChromeVideo().Clone(); });
+BENCHMARK_CAPTURE(BM_Clone, RIDInfo, [] { return (*SimulcastVideo().GetRID("q"))->Clone(); });
+BENCHMARK_CAPTURE(BM_Clone, RTCPFeedbackInfo, [] {
+    return (*ChromeVideo().GetCodec("vp8"))->GetRTCPFeedbacks().begin()->Clone();
+});
+BENCHMARK_CAPTURE(BM_Clone, SDPInfo, [] { return bench::ParseCorpus("chrome_offer.sdp"); });
+BENCHMARK_CAPTURE(BM_Clone, SimulcastInfo, [] { return SimulcastVideo().GetSimulcast()->Clone(); });
+BENCHMARK_CAPTURE(BM_Clone, SimulcastStreamInfo, [] {
+    return SimulcastVideo().GetSimulcast()->GetSimulcastStreams(semantic_sdp::DirectionWay::Send)
+        ->front().front()->Clone();
+});
+BENCHMARK_CAPTURE(BM_Clone, SourceGroupInfo, [] { return ChromeVideoTrack().GetSourceGroups().front()->Clone(); });
+BENCHMARK_CAPTURE(BM_Clone, SourceInfo, [] {
+    auto source = std::make_unique<semantic_sdp::CSourceInfo>(2231627014);
+    source->SetCName("stream0");
+    source->SetStreamId("stream0");
+    source->SetTrackId("video0");
+    return source;
+});
+BENCHMARK_CAPTURE(BM_Clone, StreamInfo, [] {
+    return (*bench::ParseCorpus("chrome_offer.sdp")->GetStream("stream0"))->Clone();
+});
+BENCHMARK_CAPTURE(BM_Clone, TrackEncodingInfo, [] {
+    auto encoding = std::make_unique<semantic_sdp::CTrackEncodingInfo>("q");
+    encoding->AddCodec((*ChromeVideo().GetCodec("vp8"))->Clone());
+    encoding->AddParam("max-width", "320");
+    return encoding;
+});
+BENCHMARK_CAPTURE(BM_Clone, TrackInfo, [] { return ChromeVideoTrack().Clone(); });
+
+static void BM_FirstTrackByType(benchmark::State& state) {
+    semantic_sdp::CStreamInfo stream("stream0");
+    stream.AddTrack(std::make_unique<semantic_sdp::CTrackInfo>(
+        semantic_sdp::MediaType(semantic_sdp::MediaType::Type::audio), "audio0"));
+    stream.AddTrack(std::make_unique<semantic_sdp::CTrackInfo>(
+        semantic_sdp::MediaType(semantic_sdp::MediaType::Type::video), "video0"));
+    const semantic_sdp::TrackType video(semantic_sdp::TrackType::Type::video);
+    for (auto _ : state) {
+        const auto* track = stream.GetFirstTrack(video);
+        benchmark::DoNotOptimize(track);
+    }
+    // Model footprint, MediaType used to hold three std::string names
+    state.counters["sizeof_MediaType"] = sizeof(semantic_sdp::MediaType);
+    state.counters["sizeof_CTrackInfo"] = sizeof(semantic_sdp::CTrackInfo);
+    state.counters["sizeof_CMediaInfo"] = sizeof(semantic_sdp::CMediaInfo);
+}
+BENCHMARK(BM_FirstTrackByType);
+
+static void BM_SourceGroupLookup(benchmark::State& state) {
+    const auto& track = ChromeVideoTrack();
+    for (auto _ : state) {
+        if (state.range(0) != 0)
+            benchmark::DoNotOptimize(track.getSourceGroup(semantic_sdp::SourceGroupSemantics::FID));
+        else
+            benchmark::DoNotOptimize(track.getSourceGroup("FID"));
+    }
+}
+BENCHMARK(BM_SourceGroupLookup)->Arg(0)->Arg(1);
+
+static void BM_CandidateDedupe(benchmark::State& state) {
+    const auto count = static_cast<int>(state.range(1));
+    std::vector<semantic_sdp::CandidateInfo> gathered;
+    for (int i = 0; i < count; ++i) {
+        gathered.push_back(std::make_unique<semantic_sdp::CCandidateInfo>(
+            std::to_string(842163049 + i % 4), 1, "udp", 1677729535, "85.23.12.56", 50000 + i, "srflx",
+            "192.168.0.196", 50000 + i));
+    }
+    for (auto _ : state) {
+        if (state.range(0) != 0) {
+            semantic_sdp::CCandidatesSet candidates;
+            for (const auto& candidate : gathered)
+                candidates.Insert(candidate->Clone());
+            benchmark::DoNotOptimize(candidates.size());
+        } else {
+            // Linear scan with Equals over everything seen so far
+            semantic_sdp::CandidatesList candidates;
+            for (const auto& candidate : gathered) {
+                const bool seen = std::any_of(candidates.begin(), candidates.end(),
+                                              [&candidate](const auto& c) { return c->Equals(*candidate); });
+                if (!seen)
+                    candidates.push_back(candidate->Clone());
+            }
+            benchmark::DoNotOptimize(candidates.size());
+        }
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * count));
+    // Candidate footprint, address, transport and type used to be held as std::string
+    state.counters["sizeof_CCandidateInfo"] = sizeof(semantic_sdp::CCandidateInfo);
+}
+BENCHMARK(BM_CandidateDedupe)->ArgsProduct({{0, 1}, {8, 40, 200}});
+
+static void BM_CandidateBest(benchmark::State& state) {
+    const auto count = static_cast<int>(state.range(1));
+    semantic_sdp::CCandidatesSet candidates;
+    for (int i = 0; i < count; ++i) {
+        const auto type = static_cast<semantic_sdp::CandidateType>(1 + i % 4);
+        candidates.Insert(std::make_unique<semantic_sdp::CCandidateInfo>(
+            "1", 1 + i % 2, semantic_sdp::CandidateTransport::UDP,
+            semantic_sdp::candidate_priority::Compute(type, static_cast<uint16_t>(i * 7919)),
+            semantic_sdp::IPAddress::Parse("10.0.0.1"), static_cast<uint16_t>(50000 + i), type,
+            semantic_sdp::IPAddress(), std::nullopt));
+    }
+    for (auto _ : state) {
+        if (state.range(0) != 0) {
+            benchmark::DoNotOptimize(candidates.GetBest(1));
+        } else {
+            // Sort a copy on every query
+            std::vector<const semantic_sdp::CCandidateInfo*> sorted;
+            for (const auto& candidate : candidates)
+                sorted.push_back(candidate.get());
+            std::stable_sort(sorted.begin(), sorted.end(),
+                             [](const auto* c1, const auto* c2) { return c1->GetPriority() > c2->GetPriority(); });
+            const auto it = std::find_if(sorted.begin(), sorted.end(),
+                                         [](const auto* c) { return c->GetComponentId() == 1; });
+            benchmark::DoNotOptimize(*it);
+        }
+    }
+}
+BENCHMARK(BM_CandidateBest)->ArgsProduct({{0, 1}, {8, 40, 200}});
+
+static void BM_CodecLookup(benchmark::State& state) {
+    const auto& media = ChromeVideo();
+    const auto& codecs = media.GetCodecs();
+    std::vector<int> types;
+    std::unordered_map<int, const semantic_sdp::CCodecInfo*> hashed;
+    for (const auto& codec_it : codecs) {
+        types.push_back(codec_it.first);
+        hashed.emplace(codec_it.first, codec_it.second.get());
+    }
+    for (auto _ : state) {
+        for (const auto type : types) {
+            if (state.range(0) != 0) {
+                benchmark::DoNotOptimize(media.GetCodecForType(type));
+            } else {
+                // Previous payload type hash map
+                benchmark::DoNotOptimize(hashed.find(type)->second);
+            }
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(types.size()));
+}
+BENCHMARK(BM_CodecLookup)->Arg(0)->Arg(1);
+
+static void BM_CodecIterate(benchmark::State& state) {
+    const auto& codecs = ChromeVideo().GetCodecs();
+    std::unordered_map<int, const semantic_sdp::CCodecInfo*> hashed;
+    for (const auto& codec_it : codecs)
+        hashed.emplace(codec_it.first, codec_it.second.get());
+    for (auto _ : state) {
+        int sum = 0;
+        if (state.range(0) != 0) {
+            for (const auto& codec_it : codecs)
+                sum += codec_it.second->GetType();
+        } else {
+            for (const auto& codec_it : hashed)
+                sum += codec_it.second->GetType();
+        }
+        benchmark::DoNotOptimize(sum);
+    }
+}
+BENCHMARK(BM_CodecIterate)->Arg(0)->Arg(1);
+
+static void BM_SSRCLookup(benchmark::State& state) {
+    const auto sdp = bench::ParseCorpus("conference_offer.sdp");
+    std::vector<uint32_t> ssrcs;
+    for (const auto& stream_it : sdp->GetStreams()) {
+        for (const auto& track_it : stream_it.second->GetTracks()) {
+            for (const auto ssrc : track_it.second->GetSSRCs())
+                ssrcs.push_back(static_cast<uint32_t>(ssrc));
+        }
+    }
+    for (auto _ : state) {
+        for (const auto ssrc : ssrcs) {
+            if (state.range(0) != 0) {
+                benchmark::DoNotOptimize(sdp->FindSSRC(ssrc));
+            } else {
+                // Scan of all tracks of all streams
+                const semantic_sdp::CTrackInfo* found = nullptr;
+                for (const auto& stream_it : sdp->GetStreams()) {
+                    for (const auto& track_it : stream_it.second->GetTracks()) {
+                        const auto& track_ssrcs = track_it.second->GetSSRCs();
+                        const auto ssrc_it = std::find(track_ssrcs.begin(), track_ssrcs.end(), static_cast<int>(ssrc));
+                        if (ssrc_it != track_ssrcs.end())
+                            found = track_it.second.get();
+                    }
+                }
+                benchmark::DoNotOptimize(found);
+            }
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(ssrcs.size()));
+    state.counters["ssrcs"] = static_cast<double>(ssrcs.size());
+}
+BENCHMARK(BM_SSRCLookup)->Arg(0)->Arg(1);
@@ -0,0 +1,188 @@
+// "Copyright [2024] <Oldnick85>"
+
+#include <string>
+
+#include "benchmark/benchmark.h"
+
+#include "./heap.h"
+#include "./util.h"
+#include "./direction.h"
+#include "./direction_way.h"
+#include "./setup.h"
+#include "./ice_info.h"
+
+static void BM_DirectionByValue(benchmark::State& state) {
+    const char* names[] = {"sendrecv", "sendonly", "RecvOnly", "inactive", "unknown"};
+    const auto allocations = bench::HeapAllocations();
+    for (auto _ : state) {
+        for (const auto* name : names)
+            benchmark::DoNotOptimize(semantic_sdp::direction::ByValue(name));
+    }
+    state.counters["allocations"] = static_cast<double>(bench::HeapAllocations() - allocations);
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * std::size(names)));
+}
+BENCHMARK(BM_DirectionByValue);
+
+static void BM_DirectionToString(benchmark::State& state) {
+    const semantic_sdp::Direction directions[] = {semantic_sdp::Direction::SendRecv, semantic_sdp::Direction::SendOnly,
+                                                  semantic_sdp::Direction::RecvOnly, semantic_sdp::Direction::Inactive};
+    const auto allocations = bench::HeapAllocations();
+    for (auto _ : state) {
+        for (const auto direction : directions)
+            benchmark::DoNotOptimize(semantic_sdp::direction::ToString(direction));
+    }
+    state.counters["allocations"] = static_cast<double>(bench::HeapAllocations() - allocations);
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * std::size(directions)));
+}
+BENCHMARK(BM_DirectionToString);
+
+static void BM_DirectionWayByValue(benchmark::State& state) {
+    const char* names[] = {"send", "recv", "unknown"};
+    const auto allocations = bench::HeapAllocations();
+    for (auto _ : state) {
+        for (const auto* name : names)
+            benchmark::DoNotOptimize(semantic_sdp::direction_way::ByValue(name));
+    }
+    state.counters["allocations"] = static_cast<double>(bench::HeapAllocations() - allocations);
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * std::size(names)));
+}
+BENCHMARK(BM_DirectionWayByValue);
+
+static void BM_SetupByValue(benchmark::State& state) {
+    const char* names[] = {"active", "passive", "ActPass", "inactive", "unknown"};
+    const auto allocations = bench::HeapAllocations();
+    for (auto _ : state) {
+        for (const auto* name : names)
+            benchmark::DoNotOptimize(semantic_sdp::setup::ByValue(name));
+    }
+    state.counters["allocations"] = static_cast<double>(bench::HeapAllocations() - allocations);
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * std::size(names)));
+}
+BENCHMARK(BM_SetupByValue);
+
+static void BM_ICEGenerate(benchmark::State& state) {
+    for (auto _ : state) {
+        auto ice = semantic_sdp::generate(false);
+        benchmark::DoNotOptimize(ice);
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_ICEGenerate);
+
+static void BM_HexEncode(benchmark::State& state) {
+    std::vector<uint8_t> bytes(static_cast<std::size_t>(state.range(1)));
+    for (std::size_t i = 0; i < bytes.size(); ++i)
+        bytes[i] = static_cast<uint8_t>(i * 37);
+    std::string text(bytes.size() * 3, '\0');
+    for (auto _ : state) {
+        if (state.range(0) == 0)
+            semantic_sdp::hex::detail::EncodeScalar(bytes.data(), bytes.size(), text.data(),
+                                                    semantic_sdp::hex::Case::Upper);
+        else if (state.range(0) == 1)
+            semantic_sdp::hex::Encode(bytes.data(), bytes.size(), text.data());
+        else
+            semantic_sdp::hex::Encode(bytes.data(), bytes.size(), text.data(), semantic_sdp::hex::Case::Upper, ':');
+        benchmark::DoNotOptimize(text.data());
+    }
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * bytes.size()));
+}
+// scalar, vector, vector with separators
+BENCHMARK(BM_HexEncode)->ArgsProduct({{0, 1, 2}, {32, 1024}});
+
+static void BM_HexDecode(benchmark::State& state) {
+    std::vector<uint8_t> bytes(static_cast<std::size_t>(state.range(1)));
+    for (std::size_t i = 0; i < bytes.size(); ++i)
+        bytes[i] = static_cast<uint8_t>(i * 37);
+    const char separator = (state.range(0) == 2) ? ':' : '\0';
+    std::string text(semantic_sdp::hex::EncodedSize(bytes.size(), separator), '\0');
+    semantic_sdp::hex::Encode(bytes.data(), bytes.size(), text.data(), semantic_sdp::hex::Case::Upper, separator);
+    for (auto _ : state) {
+        std::size_t size = 0;
+        if (state.range(0) == 0)
+            semantic_sdp::hex::detail::DecodeScalar(text.data(), bytes.size(), bytes.data());
+        else
+            semantic_sdp::hex::Decode(text, bytes.data(), bytes.size(), &size, separator);
+        benchmark::DoNotOptimize(bytes.data());
+    }
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * bytes.size()));
+}
+// scalar, vector, vector with separators
+BENCHMARK(BM_HexDecode)->ArgsProduct({{0, 1, 2}, {32, 1024}});
+
+static void BM_RandomSSRC(benchmark::State& state) {
+    for (auto _ : state)
+        benchmark::DoNotOptimize(semantic_sdp::random::SSRC());
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_RandomSSRC);
+
+static void BM_RandomFill(benchmark::State& state) {
+    std::vector<uint8_t> bytes(static_cast<std::size_t>(state.range(0)));
+    for (auto _ : state) {
+        semantic_sdp::random::Fill(bytes.data(), bytes.size());
+        benchmark::DoNotOptimize(bytes.data());
+    }
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * bytes.size()));
+}
+BENCHMARK(BM_RandomFill)->Arg(16)->Arg(32)->Arg(4096);
+
+static void BM_Split(benchmark::State& state) {
+    const std::string value{"level-asymmetry-allowed=1;packetization-mode=1;profile-level-id=42e01f"};
+    for (auto _ : state) {
+        auto elems = semantic_sdp::split(value, ';');
+        benchmark::DoNotOptimize(elems);
+    }
+}
+BENCHMARK(BM_Split);
+
+static void BM_SplitView(benchmark::State& state) {
+    const std::string value{"level-asymmetry-allowed=1;packetization-mode=1;profile-level-id=42e01f"};
+    const auto allocations = bench::HeapAllocations();
+    for (auto _ : state) {
+        for (const auto elem : semantic_sdp::split_view(value, ';'))
+            benchmark::DoNotOptimize(elem);
+    }
+    state.counters["allocations"] = static_cast<double>(bench::HeapAllocations() - allocations);
+}
+BENCHMARK(BM_SplitView);
+
+static void BM_Trim(benchmark::State& state) {
+    const std::string value{"  \t packetization-mode=1 \t "};
+    for (auto _ : state) {
+        auto trimmed = semantic_sdp::trim_copy(value);
+        benchmark::DoNotOptimize(trimmed);
+    }
+}
+BENCHMARK(BM_Trim);
+
+static void BM_TrimView(benchmark::State& state) {
+    const std::string value{"  \t packetization-mode=1 \t "};
+    const auto allocations = bench::HeapAllocations();
+    for (auto _ : state) {
+        auto trimmed = semantic_sdp::trim_view(value);
+        benchmark::DoNotOptimize(trimmed);
+    }
+    state.counters["allocations"] = static_cast<double>(bench::HeapAllocations() - allocations);
+}
+BENCHMARK(BM_TrimView);
+
+static void BM_CaseInsensitive(benchmark::State& state) {
+    const std::string uri1{"http://www.webrtc.org/experiments/rtp-hdrext/ABS-send-time"};
+    const std::string uri2{"http://www.webrtc.org/experiments/rtp-hdrext/abs-send-TIME"};
+    for (auto _ : state) {
+        if (state.range(0) != 0) {
+            benchmark::DoNotOptimize(semantic_sdp::iequals(uri1, uri2));
+        } else {
+            // Former eq_case_insensitive(): two lowercase copies and a compare
+            benchmark::DoNotOptimize(semantic_sdp::to_lower_case_copy(uri1) == semantic_sdp::to_lower_case_copy(uri2));
+        }
+    }
+}
+BENCHMARK(BM_CaseInsensitive)->Arg(0)->Arg(1);
+
+static void BM_CaseInsensitiveHash(benchmark::State& state) {
+    const std::string uri{"http://www.webrtc.org/experiments/rtp-hdrext/abs-send-time"};
+    for (auto _ : state)
+        benchmark::DoNotOptimize(semantic_sdp::ihash(uri));
+}
+BENCHMARK(BM_CaseInsensitiveHash);
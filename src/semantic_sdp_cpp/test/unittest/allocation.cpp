@@ -0,0 +1,153 @@
+// "Copyright [2024] <Oldnick85>"
+
+#include <cinttypes>
+#include <cstdio>
+#include <fstream>
+#include <memory_resource>
+#include <sstream>
+#include <string>
+
+#include "gtest/gtest.h"
+
+#include "./allocation_stats.h"
+#include "./memory.h"
+#include "./sdp_info.h"
+#include "./sdp_parser.h"
+#include "./sdp_serializer.h"
+#include "./supported_media.h"
+
+#ifndef SEMANTIC_SDP_ALLOCATION_STATS
+#error "allocation tests need the library built with SEMANTIC_SDP_ALLOCATION_STATS"
+#endif
+
+namespace {
+
+using semantic_sdp::memory::Operation;
+
+std::string LoadCorpus(const std::string& name) {
+    std::ifstream file(std::string(SDP_CORPUS_DIR) + "/" + name, std::ios::binary);
+    std::stringstream ss;
+    ss << file.rdbuf();
+    return ss.str();
+}
+
+uint64_t Allocations(const Operation operation) {
+    return semantic_sdp::memory::GetAllocationStats(operation).allocations;
+}
+
+/**
+ * Heap allocation budget of the public operations for one corpus file, about 10% above the current counts
+ */
+struct SBudget {
+    const char* name;
+    uint64_t    parse;
+    uint64_t    clone;
+    uint64_t    answer;
+};
+
+/**
+ * Memory resource counting the allocations it forwards to another one
+ */
+class CCountingResource : public std::pmr::memory_resource {
+ private:
+    std::pmr::memory_resource*  m_upstream;
+    uint64_t                    m_allocations{0};
+
+    void* do_allocate(const std::size_t bytes, const std::size_t alignment) override {
+        ++m_allocations;
+        return m_upstream->allocate(bytes, alignment);
+    }
+
+    void do_deallocate(void* ptr, const std::size_t bytes, const std::size_t alignment) override {
+        m_upstream->deallocate(ptr, bytes, alignment);
+    }
+
+    bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override {
+        return this == &other;
+    }
+
+ public:
+    explicit CCountingResource(std::pmr::memory_resource* upstream)
+    : m_upstream(upstream)
+    {}
+
+    uint64_t GetAllocations() const {
+        return m_allocations;
+    }
+};
+
+void Print(const char* name, const char* operation, const Operation op) {
+    const auto stats = semantic_sdp::memory::GetAllocationStats(op);
+    std::printf("%s %s: %" PRIu64 " allocations, %" PRIu64 " bytes\n", name, operation, stats.allocations, stats.bytes);
+}
+
+}    // namespace
+
+class AllocationBudget : public ::testing::TestWithParam<SBudget> {};
+
+TEST_P(AllocationBudget, corpus) {
+    const auto& budget = GetParam();
+    const auto text = LoadCorpus(budget.name);
+    ASSERT_FALSE(text.empty());
+    auto supported = std::make_unique<semantic_sdp::sSupportedMedia>();
+    supported->codecs = semantic_sdp::MapFromNames(std::vector<std::string>{"opus", "vp8", "h264"}, true, {});
+    supported->simulcast = true;
+    supported->rtx = true;
+    const semantic_sdp::CSupportedMediaProfile profile(*supported);
+    semantic_sdp::sSupportedProfiles profiles{&profile, &profile, nullptr};
+
+    semantic_sdp::memory::ResetAllocationStats();
+    const auto sdp = semantic_sdp::sdp::Parse(text);
+    ASSERT_NE(sdp, nullptr);
+    const auto cloned = sdp->Clone();
+    const auto answer = sdp->Answer(profiles);
+    // Allocated through the library allocator, so its growth is counted
+    semantic_sdp::memory::String out;
+    semantic_sdp::sdp::Serialize(*sdp, &out);
+    Print(budget.name, "parse", Operation::Parse);
+    Print(budget.name, "clone", Operation::Clone);
+    Print(budget.name, "answer", Operation::Answer);
+    Print(budget.name, "serialize", Operation::Serialize);
+
+    const auto parse_allocations = Allocations(Operation::Parse);
+    EXPECT_LE(parse_allocations, budget.parse);
+    EXPECT_LE(Allocations(Operation::Clone), budget.clone);
+    EXPECT_LE(Allocations(Operation::Answer), budget.answer);
+    // The output buffer, and the track view of the thread if the session has more tracks than any before
+    const auto serialize_allocations = Allocations(Operation::Serialize);
+    EXPECT_GE(serialize_allocations, 1);
+    EXPECT_LE(serialize_allocations, 2);
+    EXPECT_EQ(Allocations(Operation::Other), 0);
+
+    // Serializing into a buffer that is large enough does not allocate
+    out.clear();
+    semantic_sdp::sdp::Serialize(*sdp, &out);
+    EXPECT_EQ(Allocations(Operation::Serialize), serialize_allocations);
+
+    // Nothing reaches the heap while an arena is active, every heap allocation of the parse goes to the arena
+    semantic_sdp::memory::ResetAllocationStats();
+    semantic_sdp::memory::CArena arena;
+    CCountingResource counting(arena.GetResource());
+    {
+        semantic_sdp::memory::CScope scope(&counting);
+        auto arena_sdp = semantic_sdp::sdp::Parse(text);
+        ASSERT_NE(arena_sdp, nullptr);
+        EXPECT_EQ(arena_sdp->GetMedias().size(), sdp->GetMedias().size());
+        arena.Drop(std::move(arena_sdp));
+    }
+    EXPECT_EQ(Allocations(Operation::Parse), 0);
+    EXPECT_GE(counting.GetAllocations(), parse_allocations);
+}
+
+INSTANTIATE_TEST_SUITE_P(Corpus, AllocationBudget, ::testing::Values(
+    SBudget{"chrome_offer.sdp",         112,    41,     29},
+    SBudget{"firefox_offer.sdp",        97,     48,     18},
+    SBudget{"safari_offer.sdp",         139,    53,     37},
+    SBudget{"simulcast_offer.sdp",      113,    70,     48},
+    SBudget{"datachannel_offer.sdp",    20,     19,     5},
+    SBudget{"conference_offer.sdp",     3421,   1223,   1419}));
+
+int main(int argc, char *argv[]) {
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -1,7 +1,14 @@
 // "Copyright [2024] <Oldnick85>"
 
+#include <atomic>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
 #include "gtest/gtest.h"
 
+#include "./atom.h"
 #include "./direction.h"
 #include "./direction_way.h"
 #include "./candidate_info.h"
@@ -20,7 +27,130 @@
 #include "./track_encoding_info.h"
 #include "./track_info.h"
 #include "./media_info.h"
+#include "./supported_media.h"
 #include "./stream_info.h"
+#include "./sdp_info.h"
+#include "./worker_pool.h"
+#include "./sdp_parser.h"
+#include "./line_scanner.h"
+#include "./sdp_serializer.h"
+#include "./memory.h"
+
+namespace {
+
+const char kChromeOffer[] =
+    "v=0\r\n"
+    "o=- 4327261771880257373 2 IN IP4 127.0.0.1\r\n"
+    "s=-\r\n"
+    "t=0 0\r\n"
+    "a=group:BUNDLE 0 1 2\r\n"
+    "a=extmap-allow-mixed\r\n"
+    "a=msid-semantic: WMS stream0\r\n"
+    "m=audio 9 UDP/TLS/RTP/SAVPF 111 63 9 0 8 13 110 126\r\n"
+    "c=IN IP4 0.0.0.0\r\n"
+    "a=rtcp:9 IN IP4 0.0.0.0\r\n"
+    "a=candidate:1467250027 1 udp 2122260223 192.168.0.196 46243 typ host generation 0 network-id 1\r\n"
+    "a=candidate:435653019 1 tcp 1845501695 85.23.12.56 46243 typ srflx raddr 192.168.0.196 rport 46243\r\n"
+    "a=ice-ufrag:EsAw\r\n"
+    "a=ice-pwd:P2uYro0UCOQ4zxjKXaWCBui1\r\n"
+    "a=ice-options:trickle\r\n"
+    "a=fingerprint:sha-256 "
+    "D2:FA:0E:C3:22:59:5E:14:95:69:92:3D:13:B4:84:24:2C:C2:A2:C0:3E:FD:34:8E:5E:EA:6F:AF:52:CE:E6:0F\r\n"
+    "a=setup:actpass\r\n"
+    "a=mid:0\r\n"
+    "a=extmap:1 urn:ietf:params:rtp-hdrext:ssrc-audio-level\r\n"
+    "a=extmap:2 http://www.webrtc.org/experiments/rtp-hdrext/abs-send-time\r\n"
+    "a=extmap:3 http://www.ietf.org/id/draft-holmer-rmcat-transport-wide-cc-extensions-01\r\n"
+    "a=extmap:4 urn:ietf:params:rtp-hdrext:sdes:mid\r\n"
+    "a=sendrecv\r\n"
+    "a=msid:stream0 audio0\r\n"
+    "a=rtcp-mux\r\n"
+    "a=rtpmap:111 opus/48000/2\r\n"
+    "a=rtcp-fb:111 transport-cc\r\n"
+    "a=fmtp:111 minptime=10;useinbandfec=1\r\n"
+    "a=rtpmap:63 red/48000/2\r\n"
+    "a=fmtp:63 111/111\r\n"
+    "a=rtpmap:9 G722/8000\r\n"
+    "a=rtpmap:0 PCMU/8000\r\n"
+    "a=rtpmap:8 PCMA/8000\r\n"
+    "a=rtpmap:13 CN/8000\r\n"
+    "a=rtpmap:110 telephone-event/48000\r\n"
+    "a=rtpmap:126 telephone-event/8000\r\n"
+    "a=ssrc:3570614608 cname:4TOk42mSjXCkVIa6\r\n"
+    "a=ssrc:3570614608 msid:stream0 audio0\r\n"
+    "m=video 9 UDP/TLS/RTP/SAVPF 96 97 102 103 127 125\r\n"
+    "c=IN IP4 0.0.0.0\r\n"
+    "a=rtcp:9 IN IP4 0.0.0.0\r\n"
+    "a=ice-ufrag:EsAw\r\n"
+    "a=ice-pwd:P2uYro0UCOQ4zxjKXaWCBui1\r\n"
+    "a=ice-options:trickle\r\n"
+    "a=fingerprint:sha-256 "
+    "D2:FA:0E:C3:22:59:5E:14:95:69:92:3D:13:B4:84:24:2C:C2:A2:C0:3E:FD:34:8E:5E:EA:6F:AF:52:CE:E6:0F\r\n"
+    "a=setup:actpass\r\n"
+    "a=mid:1\r\n"
+    "a=extmap:14 urn:ietf:params:rtp-hdrext:toffset\r\n"
+    "a=extmap:2 http://www.webrtc.org/experiments/rtp-hdrext/abs-send-time\r\n"
+    "a=extmap:13 urn:3gpp:video-orientation\r\n"
+    "a=extmap:3 http://www.ietf.org/id/draft-holmer-rmcat-transport-wide-cc-extensions-01\r\n"
+    "a=extmap:4 urn:ietf:params:rtp-hdrext:sdes:mid\r\n"
+    "a=extmap:10 urn:ietf:params:rtp-hdrext:sdes:rtp-stream-id\r\n"
+    "a=extmap:11 urn:ietf:params:rtp-hdrext:sdes:repaired-rtp-stream-id\r\n"
+    "a=sendrecv\r\n"
+    "a=msid:stream0 video0\r\n"
+    "a=rtcp-mux\r\n"
+    "a=rtcp-rsize\r\n"
+    "a=rtpmap:96 VP8/90000\r\n"
+    "a=rtcp-fb:96 goog-remb\r\n"
+    "a=rtcp-fb:96 transport-cc\r\n"
+    "a=rtcp-fb:96 ccm fir\r\n"
+    "a=rtcp-fb:96 nack\r\n"
+    "a=rtcp-fb:96 nack pli\r\n"
+    "a=rtpmap:97 rtx/90000\r\n"
+    "a=fmtp:97 apt=96\r\n"
+    "a=rtpmap:102 H264/90000\r\n"
+    "a=rtcp-fb:102 goog-remb\r\n"
+    "a=rtcp-fb:102 transport-cc\r\n"
+    "a=rtcp-fb:102 ccm fir\r\n"
+    "a=rtcp-fb:102 nack\r\n"
+    "a=rtcp-fb:102 nack pli\r\n"
+    "a=fmtp:102 level-asymmetry-allowed=1;packetization-mode=1;profile-level-id=42e01f\r\n"
+    "a=rtpmap:103 rtx/90000\r\n"
+    "a=fmtp:103 apt=102\r\n"
+    "a=rtpmap:127 red/90000\r\n"
+    "a=rtpmap:125 ulpfec/90000\r\n"
+    "a=ssrc-group:FID 2231627014 632943048\r\n"
+    "a=ssrc:2231627014 cname:4TOk42mSjXCkVIa6\r\n"
+    "a=ssrc:2231627014 msid:stream0 video0\r\n"
+    "a=ssrc:632943048 cname:4TOk42mSjXCkVIa6\r\n"
+    "a=ssrc:632943048 msid:stream0 video0\r\n"
+    "m=application 9 UDP/DTLS/SCTP webrtc-datachannel\r\n"
+    "c=IN IP4 0.0.0.0\r\n"
+    "a=ice-ufrag:EsAw\r\n"
+    "a=ice-pwd:P2uYro0UCOQ4zxjKXaWCBui1\r\n"
+    "a=ice-options:trickle\r\n"
+    "a=fingerprint:sha-256 "
+    "D2:FA:0E:C3:22:59:5E:14:95:69:92:3D:13:B4:84:24:2C:C2:A2:C0:3E:FD:34:8E:5E:EA:6F:AF:52:CE:E6:0F\r\n"
+    "a=setup:actpass\r\n"
+    "a=mid:2\r\n"
+    "a=sctp-port:5000\r\n"
+    "a=max-message-size:262144\r\n";
+
+const char kSimulcastOffer[] =
+    "v=0\r\n"
+    "o=- 1 1 IN IP4 127.0.0.1\r\n"
+    "s=-\r\n"
+    "t=0 0\r\n"
+    "m=video 9 UDP/TLS/RTP/SAVPF 96\r\n"
+    "a=mid:0\r\n"
+    "a=sendonly\r\n"
+    "a=msid:stream1 track1\r\n"
+    "a=rtpmap:96 VP8/90000\r\n"
+    "a=rid:q send pt=96;max-width=320\r\n"
+    "a=rid:h send\r\n"
+    "a=rid:f send\r\n"
+    "a=simulcast:send q;h;~f\r\n";
+
+}    // namespace
 
 TEST(Base, compiling) {
     semantic_sdp::Direction dir = semantic_sdp::direction::ByValue("sendrecv");
@@ -48,6 +178,1065 @@ TEST(Base, compiling) {
     ASSERT_TRUE(true);
 }
 
+TEST(Base, keywords) {
+    using semantic_sdp::Direction;
+    using semantic_sdp::DirectionWay;
+    using semantic_sdp::Setup;
+    static_assert(semantic_sdp::direction::ByValue("SendOnly") == Direction::SendOnly);
+    static_assert(semantic_sdp::direction::ToString(Direction::RecvOnly) == "recvonly");
+    static_assert(semantic_sdp::direction_way::ByValue("RECV") == DirectionWay::Recv);
+    static_assert(semantic_sdp::setup::ByValue("actpass") == Setup::ActPass);
+    ASSERT_EQ(semantic_sdp::direction::ByValue("sendrecv "), Direction::Unknown);
+    ASSERT_EQ(semantic_sdp::direction::ByValue(""), Direction::Unknown);
+    ASSERT_EQ(semantic_sdp::direction_way::ByValue("sendrecv"), DirectionWay::Unknown);
+    ASSERT_EQ(semantic_sdp::setup::ByValue("holdconn"), Setup::Unknown);
+    ASSERT_EQ(semantic_sdp::setup::ToString(Setup::Unknown), "");
+}
+
+TEST(Base, strings) {
+    std::vector<std::string_view> fields;
+    for (const auto field : semantic_sdp::split_view("a;;b c;", ';'))
+        fields.push_back(field);
+    ASSERT_EQ(fields, (std::vector<std::string_view>{"a", "", "b c", ""}));
+    ASSERT_EQ(std::distance(semantic_sdp::split_view("", ';').begin(), semantic_sdp::split_view("", ';').end()), 0);
+    ASSERT_EQ(semantic_sdp::split("x=1;y=2;", ';').size(), 2);
+    ASSERT_EQ(semantic_sdp::trim_view(" \t packetization-mode=1\r\n"), "packetization-mode=1");
+    ASSERT_EQ(semantic_sdp::trim_copy("  \t "), "");
+    ASSERT_EQ(semantic_sdp::to_lower_case_copy("VP8"), "vp8");
+    const std::string uri1{"http://www.webrtc.org/experiments/rtp-hdrext/ABS-send-time"};
+    const std::string uri2{"http://www.webrtc.org/experiments/rtp-hdrext/abs-send-TIME"};
+    ASSERT_TRUE(semantic_sdp::iequals(uri1, uri2));
+    ASSERT_EQ(semantic_sdp::ihash(uri1), semantic_sdp::ihash(uri2));
+    ASSERT_FALSE(semantic_sdp::iequals(uri1, std::string(uri2).replace(20, 1, "x")));
+    ASSERT_FALSE(semantic_sdp::iequals("[", "{"));
+    ASSERT_FALSE(semantic_sdp::iequals("\xC4", "\xE4"));
+    ASSERT_TRUE(semantic_sdp::eq_case_insensitive("Opus", "OPUS"));
+}
+
+TEST(Base, media_type) {
+    using semantic_sdp::MediaType;
+    using semantic_sdp::TrackType;
+    static_assert(MediaType(MediaType::Type::application).type_str() == "application");
+    ASSERT_EQ(MediaType::ByValue("VIDEO"), MediaType(MediaType::Type::video));
+    ASSERT_FALSE(MediaType::ByValue("text").has_value());
+    ASSERT_EQ(TrackType::ByValue("audio")->type_str(), "audio");
+    ASSERT_FALSE(TrackType::ByValue("application").has_value());
+}
+
+TEST(Parser, chrome_offer) {
+    auto sdp = semantic_sdp::sdp::Parse(kChromeOffer);
+    ASSERT_NE(sdp, nullptr);
+    ASSERT_EQ(sdp->GetVersion(), 2);
+    const auto& medias = sdp->GetMedias();
+    ASSERT_EQ(medias.size(), 3);
+
+    const auto& audio = medias[0];
+    ASSERT_EQ(audio->GetId(), "0");
+    ASSERT_EQ(audio->GetType().type_str(), "audio");
+    ASSERT_EQ(audio->GetDirection(), semantic_sdp::Direction::SendRecv);
+    ASSERT_EQ(audio->GetCodecs().size(), 8);
+    const auto* opus = audio->GetCodecForType(111);
+    ASSERT_NE(opus, nullptr);
+    ASSERT_EQ((*opus)->GetCodec(), "opus");
+    ASSERT_EQ((*opus)->GetRate(), 48000);
+    ASSERT_EQ((*opus)->GetChannels(), 2);
+    ASSERT_EQ((*opus)->GetParams().at("useinbandfec"), "1");
+    ASSERT_EQ((*opus)->GetRTCPFeedbacks().size(), 1);
+    ASSERT_EQ(audio->GetExtensions().size(), 4);
+    ASSERT_EQ(audio->GetExtensions().at(4), "urn:ietf:params:rtp-hdrext:sdes:mid");
+    ASSERT_EQ(audio->GetCandidates().size(), 2);
+    const auto& srflx = audio->GetCandidates()[1];
+    ASSERT_EQ(srflx->GetTransport(), "tcp");
+    ASSERT_EQ(srflx->GetPort(), 46243);
+    ASSERT_EQ(srflx->GetType(), "srflx");
+    ASSERT_EQ(srflx->GetRelAddr(), "192.168.0.196");
+    ASSERT_EQ(srflx->GetRelPort(), 46243);
+
+    const auto& video = medias[1];
+    ASSERT_EQ(video->GetType().type_str(), "video");
+    ASSERT_EQ(video->GetCodecs().size(), 4);
+    ASSERT_TRUE(video->HasRTX());
+    const auto* h264 = video->GetCodecForType(102);
+    ASSERT_NE(h264, nullptr);
+    ASSERT_EQ((*h264)->GetRTX(), 103);
+    ASSERT_EQ((*h264)->GetParams().at("profile-level-id"), "42e01f");
+    const auto& h264_params = (*h264)->GetFormatParams();
+    ASSERT_EQ(h264_params.profile_level_id->profile_idc, 0x42);
+    ASSERT_EQ(h264_params.profile_level_id->level_idc, 0x1F);
+    ASSERT_EQ(h264_params.packetization_mode, 1);
+    ASSERT_EQ(h264_params.level_asymmetry_allowed, true);
+    ASSERT_EQ((*h264)->GetRTCPFeedbacks().size(), 5);
+    ASSERT_EQ(video->GetCodecForType(97), nullptr);
+
+    const auto& application = medias[2];
+    ASSERT_TRUE(application->HasDataChannel());
+    ASSERT_EQ(application->GetDataChannel()->GetPort(), 5000);
+    ASSERT_EQ(application->GetDataChannel()->GetMaxMessageSize(), 262144);
+
+    ASSERT_NE(sdp->GetICE(), nullptr);
+    ASSERT_EQ(sdp->GetICE()->GetUfrag(), "EsAw");
+    ASSERT_EQ(sdp->GetICE()->GetPwd(), "P2uYro0UCOQ4zxjKXaWCBui1");
+    ASSERT_NE(sdp->GetDTLS(), nullptr);
+    ASSERT_EQ(sdp->GetDTLS()->GetHash(), "sha-256");
+    ASSERT_EQ(sdp->GetDTLS()->GetSetup(), semantic_sdp::Setup::ActPass);
+
+    const auto* stream = sdp->GetStream("stream0");
+    ASSERT_NE(stream, nullptr);
+    ASSERT_EQ((*stream)->GetTracks().size(), 2);
+    const auto* track = (*stream)->GetTrack("video0");
+    ASSERT_NE(track, nullptr);
+    ASSERT_EQ((*track)->GetMediaId(), "1");
+    ASSERT_EQ((*track)->GetSSRCs().size(), 2);
+    ASSERT_TRUE((*track)->HasSourceGroup("FID"));
+    ASSERT_EQ((*track)->GetCName(), "4TOk42mSjXCkVIa6");
+    ASSERT_EQ((*track)->Clone()->GetCName(), "4TOk42mSjXCkVIa6");
+}
+
+TEST(Parser, many_sources) {
+    // Plan B track with attributes of many sources interleaved
+    std::string offer(kChromeOffer);
+    std::string sources;
+    for (int i = 0; i < 200; ++i)
+        sources += "a=ssrc:" + std::to_string(1000 + i) + " cname:c" + std::to_string(i % 2) + "\r\n";
+    for (int i = 0; i < 200; ++i)
+        sources += "a=ssrc:" + std::to_string(1000 + i) + " msid:stream1 track" + std::to_string(i % 100) + "\r\n";
+    const std::string anchor = "a=ssrc:632943048 msid:stream0 video0\r\n";
+    offer.insert(offer.find(anchor) + anchor.size(), sources);
+    const std::string msid = "a=msid:stream0 video0\r\n";
+    offer.erase(offer.find(msid), msid.size());
+    auto sdp = semantic_sdp::sdp::Parse(offer);
+    ASSERT_NE(sdp, nullptr);
+    const auto* stream = sdp->GetStream("stream1");
+    ASSERT_NE(stream, nullptr);
+    ASSERT_EQ((*stream)->GetTracks().size(), 100);
+    const auto* track = (*stream)->GetTrack("track7");
+    ASSERT_NE(track, nullptr);
+    ASSERT_EQ((*track)->GetSSRCs().size(), 2);
+    ASSERT_EQ((*track)->GetSSRCs()[1], 1107);
+    ASSERT_EQ((*track)->GetCName(), "c1");
+    ASSERT_EQ(sdp->FindSSRC(1199)->track, (*stream)->GetTrack("track99")->get());
+    const auto& video0 = *(*sdp->GetStream("stream0"))->GetTrack("video0");
+    ASSERT_EQ(video0->GetSSRCs().size(), 2);
+    ASSERT_TRUE(video0->HasSourceGroup(semantic_sdp::SourceGroupSemantics::FID));
+    ASSERT_TRUE((*track)->GetSourceGroups().empty());
+}
+
+TEST(Parser, line_scanner) {
+    using semantic_sdp::sdp::ScanLevel;
+    semantic_sdp::sdp::LineIndex scalar;
+    semantic_sdp::sdp::LineIndex vector;
+    // Shift the text so line ends and colons fall on every position of the SIMD blocks
+    std::string sdp{kChromeOffer};
+    for (std::size_t shift = 0; shift < 70; ++shift) {
+        sdp.insert(0, "a=x" + std::string(shift % 7, ':') + "\n\r\n");
+        ASSERT_TRUE(semantic_sdp::sdp::ScanLines(sdp, &scalar, ScanLevel::Scalar));
+        for (const auto level : {ScanLevel::SSE2, ScanLevel::AVX2}) {
+            ASSERT_TRUE(semantic_sdp::sdp::ScanLines(sdp, &vector, level));
+            ASSERT_EQ(vector.size(), scalar.size());
+            for (std::size_t i = 0; i < scalar.size(); ++i) {
+                ASSERT_EQ(vector[i].offset, scalar[i].offset);
+                ASSERT_EQ(vector[i].length, scalar[i].length);
+                ASSERT_EQ(vector[i].name_length, scalar[i].name_length);
+                ASSERT_EQ(vector[i].name_hash, scalar[i].name_hash);
+            }
+        }
+    }
+    const std::string_view text{"v=0\r\n\r\na=rtpmap:111 opus/48000/2\na=sendrecv"};
+    ASSERT_TRUE(semantic_sdp::sdp::ScanLines(text, &scalar));
+    ASSERT_EQ(scalar.size(), 3);
+    ASSERT_EQ(scalar[1].Name(text), "rtpmap");
+    ASSERT_EQ(scalar[1].AttributeValue(text), "111 opus/48000/2");
+    ASSERT_EQ(scalar[1].name_hash, semantic_sdp::sdp::AttributeHash("rtpmap"));
+    ASSERT_EQ(scalar[2].Name(text), "sendrecv");
+    ASSERT_EQ(scalar[2].AttributeValue(text), "");
+    ASSERT_FALSE(semantic_sdp::sdp::ScanLines("v=0\r\nx\r\n", &scalar));
+}
+
+TEST(Parser, trickle) {
+    auto sdp = semantic_sdp::sdp::Parse(kChromeOffer);
+    ASSERT_NE(sdp, nullptr);
+    const auto& audio = sdp->GetMedias()[0];
+    const auto& video = sdp->GetMedias()[1];
+    const auto audio_candidates = audio->GetCandidates().size();
+    const auto video_candidates = video->GetCandidates().size();
+    ASSERT_TRUE(semantic_sdp::sdp::AddTrickle(sdp.get(), "0",
+        "a=candidate:842163049 1 udp 1677729535 85.23.12.56 61356 typ srflx raddr 192.168.0.196 rport 61356\r\n"));
+    ASSERT_TRUE(semantic_sdp::sdp::AddTrickle(sdp.get(), std::size_t{1},
+        "candidate:1467250027 1 udp 2122260223 192.168.0.196 46244 typ host generation 0"));
+    ASSERT_EQ(audio->GetCandidates().size(), audio_candidates + 1);
+    ASSERT_EQ(video->GetCandidates().size(), video_candidates + 1);
+    const auto& candidate = audio->GetCandidates().back();
+    ASSERT_EQ(candidate->GetType(), "srflx");
+    ASSERT_EQ(candidate->GetRelPort(), 61356);
+    ASSERT_FALSE(semantic_sdp::sdp::AddTrickle(sdp.get(), "9", "a=candidate:1 1 udp 1 10.0.0.1 9 typ host"));
+    ASSERT_FALSE(semantic_sdp::sdp::AddTrickle(sdp.get(), std::size_t{9}, "a=candidate:1 1 udp 1 10.0.0.1 9 typ host"));
+    ASSERT_FALSE(semantic_sdp::sdp::AddTrickle(sdp.get(), "0", "a=candidate:1 1 udp 1 10.0.0.1 9 host"));
+    ASSERT_FALSE(semantic_sdp::sdp::AddTrickle(sdp.get(), "0", "a=mid:0"));
+    ASSERT_FALSE(sdp->GetICE()->IsEndOfCandidates());
+    ASSERT_TRUE(semantic_sdp::sdp::AddTrickle(sdp.get(), "0", "a=end-of-candidates\r\n"));
+    ASSERT_TRUE(sdp->GetICE()->IsEndOfCandidates());
+    ASSERT_EQ(semantic_sdp::sdp::ParseCandidate("candidate:1 1 udp x 10.0.0.1 9 typ host"), nullptr);
+}
+
+TEST(Parser, ssrc_index) {
+    auto sdp = semantic_sdp::sdp::Parse(kChromeOffer);
+    ASSERT_NE(sdp, nullptr);
+    const auto* media = sdp->FindSSRC(2231627014U);
+    ASSERT_NE(media, nullptr);
+    ASSERT_EQ(media->role, semantic_sdp::SSRCRole::Media);
+    ASSERT_EQ(media->stream->GetId(), "stream0");
+    ASSERT_EQ(media->track->GetId(), "video0");
+    const auto* rtx = sdp->FindSSRC(632943048U);
+    ASSERT_NE(rtx, nullptr);
+    ASSERT_EQ(rtx->role, semantic_sdp::SSRCRole::RTX);
+    ASSERT_EQ(rtx->primary, 2231627014U);
+    ASSERT_EQ(rtx->group->GetSemantics(), "FID");
+    ASSERT_EQ(sdp->FindSSRC(1), nullptr);
+
+    // Tracks added to an indexed stream are indexed, removed ones are dropped
+    const auto& stream = *sdp->GetStream("stream0");
+    const auto indexed = sdp->GetSSRCIndex().size();
+    auto track = std::make_unique<semantic_sdp::CTrackInfo>(
+        semantic_sdp::MediaType(semantic_sdp::MediaType::Type::video), "video1");
+    for (const int ssrc : {10, 11, 12, 20})
+        track->AddSSRC(ssrc);
+    track->AddSourceGroup(std::make_unique<semantic_sdp::CSourceGroupInfo>("SIM", std::vector{10, 11, 12}));
+    track->AddSourceGroup(std::make_unique<semantic_sdp::CSourceGroupInfo>("FID", std::vector{11, 20}));
+    stream->AddTrack(std::move(track));
+    ASSERT_EQ(sdp->GetSSRCIndex().size(), indexed + 4);
+    ASSERT_EQ(sdp->FindSSRC(12)->layer, 2);
+    ASSERT_EQ(sdp->FindSSRC(20)->role, semantic_sdp::SSRCRole::RTX);
+    ASSERT_EQ(sdp->FindSSRC(20)->layer, 1);
+    ASSERT_EQ(sdp->FindSSRC(2231627014U)->layer, semantic_sdp::CSSRCIndex::kNoLayer);
+    stream->RemoveTrackById("video1");
+    ASSERT_EQ(sdp->FindSSRC(10), nullptr);
+    ASSERT_EQ(sdp->GetSSRCIndex().size(), indexed);
+
+    // Moved sessions keep indexing the tracks of their streams
+    semantic_sdp::CSDPInfo moved(std::move(*sdp->Clone()));
+    auto moved_track = std::make_unique<semantic_sdp::CTrackInfo>(
+        semantic_sdp::MediaType(semantic_sdp::MediaType::Type::video), "video2");
+    moved_track->AddSSRC(30);
+    (*moved.GetStream("stream0"))->AddTrack(std::move(moved_track));
+    ASSERT_NE(moved.FindSSRC(30), nullptr);
+    semantic_sdp::CSDPInfo assigned;
+    assigned = std::move(moved);
+    (*assigned.GetStream("stream0"))->RemoveTrackById("video2");
+    ASSERT_EQ(assigned.FindSSRC(30), nullptr);
+    ASSERT_EQ(assigned.FindSSRC(632943048U)->stream, assigned.GetStream("stream0")->get());
+    ASSERT_EQ(moved.FindSSRC(632943048U), nullptr);
+
+    // Clones have their own index
+    auto cloned = sdp->Clone();
+    sdp->RemoveStream("stream0");
+    ASSERT_EQ(sdp->FindSSRC(2231627014U), nullptr);
+    ASSERT_EQ(cloned->FindSSRC(632943048U)->stream, cloned->GetStream("stream0")->get());
+}
+
+TEST(Base, random) {
+    std::array<uint8_t, 16> nonce1{};
+    std::array<uint8_t, 16> nonce2{};
+    ASSERT_TRUE(semantic_sdp::random::Fill(&nonce1));
+    ASSERT_TRUE(semantic_sdp::random::Fill(&nonce2));
+    ASSERT_NE(nonce1, nonce2);
+    ASSERT_NE(semantic_sdp::random::SSRC(), 0);
+    // Every byte value is produced, 255 included
+    std::array<bool, 256> seen{};
+    for (const auto byte : semantic_sdp::random_bytes(8192))
+        seen[byte] = true;
+    ASSERT_EQ(std::count(seen.begin(), seen.end(), true), 256);
+    ASSERT_EQ(semantic_sdp::random_bytes(1000).size(), 1000);
+
+    const auto ice1 = semantic_sdp::generate(true);
+    const auto ice2 = semantic_sdp::generate(false);
+    ASSERT_NE(ice1, nullptr);
+    ASSERT_EQ(ice1->GetUfrag().size(), 16);
+    ASSERT_EQ(ice1->GetPwd().size(), 48);
+    ASSERT_TRUE(ice1->IsLite());
+    ASSERT_NE(ice1->GetPwd(), ice2->GetPwd());
+    ASSERT_EQ(std::string_view(ice1->GetPwd()).find_first_not_of("0123456789ABCDEF"), std::string_view::npos);
+}
+
+TEST(Base, format_params) {
+    semantic_sdp::CCodecInfo opus("opus", 111);
+    opus.AddParam("minptime", "10");
+    opus.AddParam("UseInbandFEC", "1");
+    opus.AddParam("stereo", "yes");
+    opus.AddParam("sprop-maxcapturerate", "48000");
+    const auto& params = opus.GetFormatParams();
+    ASSERT_EQ(params.minptime, 10);
+    ASSERT_EQ(params.useinbandfec, true);
+    ASSERT_FALSE(params.stereo.has_value());
+    ASSERT_EQ(opus.GetParam("stereo"), "yes");
+    ASSERT_EQ(opus.GetParams().size(), 4);
+    // Replaced values are parsed again
+    opus.AddParam("stereo", "0");
+    ASSERT_EQ(params.stereo, false);
+    ASSERT_EQ(opus.Clone()->GetFormatParams(), params);
+
+    semantic_sdp::CCodecInfo av1("AV1", 45, {{"profile", "1"}, {"level-idx", "5"}, {"tier", "0"}});
+    ASSERT_EQ(av1.GetFormatParams().profile, 1);
+    ASSERT_EQ(av1.GetFormatParams().level_idx, 5);
+    ASSERT_EQ(av1.GetFormatParams().tier, 0);
+    semantic_sdp::CCodecInfo vp9("VP9", 98, {{"profile-id", "2"}});
+    ASSERT_EQ(vp9.GetFormatParams().profile_id, 2);
+    ASSERT_FALSE(semantic_sdp::FormatParams::ParseProfileLevelId("42e01").has_value());
+    ASSERT_FALSE(semantic_sdp::FormatParams::ParseProfileLevelId("42e0g1").has_value());
+}
+
+TEST(Base, hex) {
+    namespace hex = semantic_sdp::hex;
+    std::vector<uint8_t> bytes(70);
+    for (std::size_t i = 0; i < bytes.size(); ++i)
+        bytes[i] = static_cast<uint8_t>(i * 37 + 11);
+    for (std::size_t count = 0; count <= bytes.size(); ++count) {
+        for (const auto letter_case : {hex::Case::Upper, hex::Case::Lower}) {
+            std::string expected(count * 2, '\0');
+            hex::detail::EncodeScalar(bytes.data(), count, expected.data(), letter_case);
+            std::string text(count * 2, '\0');
+            ASSERT_EQ(hex::Encode(bytes.data(), count, text.data(), letter_case), text.data() + text.size());
+            ASSERT_EQ(text, expected);
+            std::vector<uint8_t> decoded(count);
+            std::size_t size = 0;
+            ASSERT_TRUE(hex::Decode(text, decoded.data(), decoded.size(), &size));
+            ASSERT_EQ(size, count);
+            ASSERT_TRUE(std::equal(decoded.begin(), decoded.end(), bytes.begin()));
+
+            std::string separated(hex::EncodedSize(count, ':'), '\0');
+            hex::Encode(bytes.data(), count, separated.data(), letter_case, ':');
+            ASSERT_TRUE(hex::Decode(separated, decoded.data(), decoded.size(), &size, ':'));
+            ASSERT_EQ(size, count);
+            ASSERT_TRUE(std::equal(decoded.begin(), decoded.end(), bytes.begin()));
+        }
+    }
+    std::array<uint8_t, 32> out;
+    std::size_t size = 0;
+    std::string text(64, 'a');
+    ASSERT_TRUE(hex::Decode(text, out.data(), out.size(), &size));
+    ASSERT_EQ(out[31], 0xAA);
+    // Invalid digits are found in vector blocks and in the tail
+    for (const std::size_t pos : {0, 20, 31, 63}) {
+        for (const char c : {'g', 'G', '/', ':', '@', '`', static_cast<char>(0xB0)}) {
+            auto bad = text;
+            bad[pos] = c;
+            ASSERT_FALSE(hex::Decode(bad, out.data(), out.size(), &size));
+        }
+    }
+    ASSERT_FALSE(hex::Decode("abc", out.data(), out.size(), &size));
+    ASSERT_FALSE(hex::Decode(text + "00", out.data(), out.size(), &size));
+    ASSERT_FALSE(hex::Decode("AB-CD", out.data(), out.size(), &size, ':'));
+    ASSERT_FALSE(hex::Decode("AB:CD:", out.data(), out.size(), &size, ':'));
+    ASSERT_EQ(semantic_sdp::bytes_to_hex({0x00, 0x9F, 0xFF}), "009FFF");
+
+    auto sdp = semantic_sdp::sdp::Parse(kChromeOffer);
+    ASSERT_NE(sdp, nullptr);
+    const auto fingerprint = sdp->GetDTLS()->ParseFingerprint();
+    ASSERT_TRUE(fingerprint.has_value());
+    ASSERT_EQ(fingerprint->size(), 32);
+    ASSERT_EQ(fingerprint->data()[0], 0xD2);
+    ASSERT_EQ(fingerprint->ToString(), std::string_view(sdp->GetDTLS()->GetFingerprint()));
+    const auto lower = semantic_sdp::Fingerprint::Parse(fingerprint->ToString(hex::Case::Lower));
+    ASSERT_TRUE(lower && lower->Equals(*fingerprint));
+    ASSERT_TRUE(sdp->GetDTLS()->MatchesFingerprint(fingerprint->data(), fingerprint->size()));
+    ASSERT_FALSE(sdp->GetDTLS()->MatchesFingerprint(fingerprint->data(), 20));
+    std::array<uint8_t, 32> digest;
+    std::copy(fingerprint->data(), fingerprint->data() + digest.size(), digest.begin());
+    digest[31] ^= 1;
+    ASSERT_FALSE(sdp->GetDTLS()->MatchesFingerprint(digest.data(), digest.size()));
+    ASSERT_FALSE(semantic_sdp::Fingerprint::Parse("D2:FA:0").has_value());
+    ASSERT_FALSE(semantic_sdp::Fingerprint::Parse("").has_value());
+}
+
+TEST(Base, ip_address) {
+    using semantic_sdp::IPAddress;
+    const auto ipv4 = IPAddress::Parse("192.168.0.196");
+    ASSERT_EQ(ipv4.GetFamily(), IPAddress::Family::IPv4);
+    ASSERT_EQ(ipv4.GetBytes()[0], 192);
+    ASSERT_EQ(ipv4.GetBytes()[3], 196);
+    ASSERT_EQ(ipv4.ToString(), "192.168.0.196");
+    ASSERT_EQ(IPAddress::Parse("2001:0db8:0000:0000:0000:0000:0000:0001").ToString(), "2001:db8::1");
+    ASSERT_EQ(IPAddress::Parse("2001:db8:0:1:0:0:0:1").ToString(), "2001:db8:0:1::1");
+    ASSERT_EQ(IPAddress::Parse("::").ToString(), "::");
+    ASSERT_EQ(IPAddress::Parse("fe80::1:2").ToString(), "fe80::1:2");
+    const auto mapped = IPAddress::Parse("::ffff:1.2.3.4");
+    ASSERT_EQ(mapped.GetFamily(), IPAddress::Family::IPv6);
+    ASSERT_EQ(mapped.ToString(), "::ffff:1.2.3.4");
+    ASSERT_EQ(mapped, IPAddress::Parse("0:0:0:0:0:ffff:0102:0304"));
+    const auto mdns = IPAddress::Parse("1f4712db-ea17-4bcf-a596-105139dfd8bf.local");
+    ASSERT_EQ(mdns.GetFamily(), IPAddress::Family::Hostname);
+    ASSERT_TRUE(mdns.IsMDNS());
+    ASSERT_EQ(mdns.ToString(), "1f4712db-ea17-4bcf-a596-105139dfd8bf.local");
+    ASSERT_EQ(IPAddress::Parse("192.168.0.256").GetFamily(), IPAddress::Family::Hostname);
+    ASSERT_EQ(IPAddress::Parse("1::2::3").GetFamily(), IPAddress::Family::Hostname);
+    ASSERT_EQ(IPAddress::Parse("").GetFamily(), IPAddress::Family::None);
+    ASSERT_EQ(mdns, IPAddress::Parse(mdns.ToString()));
+    ASSERT_FALSE(mdns == IPAddress::Parse("other.local"));
+    // The host name is out of line, an address is its bytes, family and a pointer
+    static_assert(sizeof(IPAddress) <= 32);
+
+    auto candidate = semantic_sdp::sdp::ParseCandidate(
+        "candidate:1 1 UDP 2122260223 1f4712db-ea17-4bcf-a596-105139dfd8bf.local 54321 typ host");
+    ASSERT_NE(candidate, nullptr);
+    ASSERT_EQ(candidate->GetTransportType(), semantic_sdp::CandidateTransport::UDP);
+    ASSERT_EQ(candidate->GetTransport(), "udp");
+    ASSERT_EQ(candidate->GetCandidateType(), semantic_sdp::CandidateType::Host);
+    ASSERT_TRUE(candidate->GetIPAddress().IsMDNS());
+    ASSERT_EQ(semantic_sdp::sdp::ParseCandidate("candidate:1 1 sctp 1 10.0.0.1 9 typ host"), nullptr);
+    ASSERT_EQ(semantic_sdp::sdp::ParseCandidate("candidate:1 1 udp 1 10.0.0.1 9 typ nat"), nullptr);
+    ASSERT_EQ(semantic_sdp::sdp::ParseCandidate("candidate:1 1 udp 1 10.0.0.1 65536 typ host"), nullptr);
+}
+
+TEST(Base, candidate_priority) {
+    using semantic_sdp::CandidateType;
+    namespace priority = semantic_sdp::candidate_priority;
+    static_assert(priority::Compute(CandidateType::Host) == 2130706431);
+    ASSERT_EQ(priority::Compute(CandidateType::Host, 32542, 1), 2122260223);
+    ASSERT_EQ(priority::Compute(CandidateType::Srflx, 65535, 2), 1694498814);
+    ASSERT_EQ(priority::Compute(CandidateType::Relay, 0, 1), 255);
+    ASSERT_GT(priority::Compute(CandidateType::Prflx), priority::Compute(CandidateType::Srflx));
+
+    semantic_sdp::CCandidatesSet candidates;
+    const auto make = [](const int port, const CandidateType type, const uint16_t component) {
+        return std::make_unique<semantic_sdp::CCandidateInfo>(
+            "1", component, semantic_sdp::CandidateTransport::UDP, priority::Compute(type, 65535, component),
+            semantic_sdp::IPAddress::Parse("10.0.0.1"), port, type, semantic_sdp::IPAddress(), std::nullopt);
+    };
+    ASSERT_TRUE(candidates.Insert(make(1, CandidateType::Relay, 1)));
+    ASSERT_TRUE(candidates.Insert(make(2, CandidateType::Srflx, 2)));
+    ASSERT_TRUE(candidates.Insert(make(3, CandidateType::Host, 2)));
+    ASSERT_TRUE(candidates.Insert(make(4, CandidateType::Srflx, 1)));
+    ASSERT_TRUE(candidates.Insert(make(5, CandidateType::Relay, 1)));
+    const auto& ranked = candidates.GetByPriority();
+    ASSERT_EQ(ranked.size(), 5);
+    std::vector<int> ports;
+    for (const auto& entry : ranked)
+        ports.push_back(entry.candidate->GetPort());
+    ASSERT_EQ(ports, (std::vector<int>{3, 4, 2, 1, 5}));
+    ASSERT_EQ(candidates.GetBest()->GetPort(), 4);
+    ASSERT_EQ(candidates.GetBest(2)->GetPort(), 3);
+    ASSERT_EQ(candidates.GetBest(3), nullptr);
+    // Insertion order is unchanged
+    ASSERT_EQ(candidates.front()->GetPort(), 1);
+    candidates.Clear();
+    ASSERT_TRUE(candidates.GetByPriority().empty());
+}
+
+TEST(Base, candidates_set) {
+    semantic_sdp::CCandidatesSet candidates;
+    const auto make = [](const int priority, const int port) {
+        return std::make_unique<semantic_sdp::CCandidateInfo>("842163049", 1, "udp", priority, "85.23.12.56", port,
+                                                              "srflx", "192.168.0.196", port);
+    };
+    ASSERT_TRUE(candidates.Insert(make(1677729535, 61356)));
+    ASSERT_TRUE(candidates.Insert(make(1677729535, 61357)));
+    // Same key with another priority is the same candidate
+    auto again = make(1677729000, 61356);
+    ASSERT_EQ(std::hash<semantic_sdp::CCandidateInfo>{}(*again), candidates.front()->GetHash());
+    ASSERT_TRUE(candidates.Contains(*again));
+    ASSERT_FALSE(candidates.Insert(std::move(again)));
+    ASSERT_EQ(candidates.size(), 2);
+    ASSERT_EQ(candidates.back()->GetPort(), 61357);
+    // Past the linear scan threshold duplicates are found through the index
+    for (int port = 50000; port < 50032; ++port)
+        ASSERT_TRUE(candidates.Insert(make(1677729535, port)));
+    for (int port = 50000; port < 50032; ++port)
+        ASSERT_FALSE(candidates.Insert(make(1, port)));
+    ASSERT_TRUE(candidates.Contains(*make(1677729535, 61356)));
+    ASSERT_EQ(candidates.size(), 34);
+    candidates.Clear();
+    ASSERT_TRUE(candidates.empty());
+    ASSERT_TRUE(candidates.Insert(make(1677729535, 61356)));
+}
+
+TEST(Base, atom) {
+    const semantic_sdp::Atom vp8("VP8");
+    const semantic_sdp::Atom copy(std::string("VP8"));
+    ASSERT_TRUE(vp8.IsInterned());
+    ASSERT_EQ(vp8, copy);
+    ASSERT_EQ(vp8.view().data(), copy.view().data());
+    ASSERT_EQ(vp8, "VP8");
+    ASSERT_FALSE(vp8 == semantic_sdp::Atom("vp8"));
+    ASSERT_TRUE(vp8.IEquals(semantic_sdp::Atom("vP8")));
+    ASSERT_EQ(vp8.Folded(), "vp8");
+    ASSERT_EQ(vp8.Folded().view().data(), semantic_sdp::Atom("vp8").view().data());
+    ASSERT_EQ(std::hash<semantic_sdp::Atom>{}(vp8), std::hash<std::string_view>{}("VP8"));
+    ASSERT_TRUE(semantic_sdp::Atom().empty());
+    ASSERT_EQ(semantic_sdp::Atom(""), semantic_sdp::Atom());
+    // Lookup does not intern
+    ASSERT_TRUE(semantic_sdp::Atom::Find("urn:example:never-interned").empty());
+    ASSERT_EQ(semantic_sdp::Atom::Find("VP8"), vp8);
+    // Text outside of the vocabulary is owned by the atom and its copies and compared by content
+    const semantic_sdp::Atom remote("urn:example:remote");
+    const semantic_sdp::Atom remote_copy = remote;
+    ASSERT_FALSE(remote.IsInterned());
+    ASSERT_TRUE(semantic_sdp::Atom::Find("urn:example:remote").empty());
+    ASSERT_EQ(remote_copy.view().data(), remote.view().data());
+    ASSERT_EQ(remote.Folded().view().data(), remote.view().data());
+    ASSERT_EQ(semantic_sdp::Atom("Example-Codec").Folded(), "example-codec");
+    ASSERT_TRUE(remote.IEquals(semantic_sdp::Atom("URN:example:REMOTE")));
+    const auto interned = semantic_sdp::Atom::Intern("urn:example:remote");
+    ASSERT_TRUE(interned.IsInterned());
+    ASSERT_EQ(remote, interned);
+    ASSERT_EQ(std::hash<semantic_sdp::Atom>{}(remote), std::hash<semantic_sdp::Atom>{}(interned));
+    // Texts too long for the table stay owned
+    const std::string long_text(semantic_sdp::atom::detail::CTable::kMaxLength + 1, 'x');
+    const auto owned = semantic_sdp::Atom::Intern(long_text);
+    semantic_sdp::Atom owned_copy = owned;
+    ASSERT_FALSE(owned.IsInterned());
+    ASSERT_EQ(owned, owned_copy);
+    ASSERT_TRUE(owned.IEquals(semantic_sdp::Atom(std::string(long_text.size(), 'X'))));
+    ASSERT_FALSE(owned == vp8);
+    {
+        // Copies placed in another memory resource do not share the entry
+        semantic_sdp::memory::CArena arena;
+        semantic_sdp::memory::CScope scope(arena.GetResource());
+        const semantic_sdp::Atom arena_copy = owned;
+        ASSERT_NE(arena_copy.view().data(), owned.view().data());
+        ASSERT_EQ(arena_copy, owned);
+    }
+    // Threads interning the same texts get the same entries
+    std::vector<std::vector<std::string_view>> seen(4);
+    std::vector<std::thread> threads;
+    for (auto& views : seen) {
+        threads.emplace_back([&views] {
+            for (int i = 0; i < 64; ++i)
+                views.push_back(semantic_sdp::Atom::Intern("urn:example:thread:" + std::to_string(i)).view());
+        });
+    }
+    for (auto& thread : threads)
+        thread.join();
+    for (const auto& views : seen) {
+        for (std::size_t i = 0; i < views.size(); ++i)
+            ASSERT_EQ(views[i].data(), seen.front()[i].data());
+    }
+}
+
+TEST(Base, rtcp_feedback) {
+    using semantic_sdp::CRTCPFeedbackInfo;
+    using semantic_sdp::RTCPFeedbackType;
+    const auto pli = CRTCPFeedbackInfo::Parse("nack  pli ");
+    ASSERT_EQ(pli.GetType(), RTCPFeedbackType::NackPli);
+    ASSERT_EQ(pli, CRTCPFeedbackInfo("nack", {"pli"}));
+    ASSERT_EQ(std::hash<CRTCPFeedbackInfo>{}(pli),
+              std::hash<CRTCPFeedbackInfo>{}(CRTCPFeedbackInfo::Parse("nack pli")));
+    const auto tmmbr = CRTCPFeedbackInfo::Parse("ccm tmmbr smaxpr=120");
+    ASSERT_EQ(tmmbr.GetType(), RTCPFeedbackType::Other);
+    ASSERT_EQ(std::vector<std::string_view>(tmmbr.GetParams().begin(), tmmbr.GetParams().end()),
+              (std::vector<std::string_view>{"tmmbr", "smaxpr=120"}));
+
+    semantic_sdp::CRTCPFeedbackSet rtcpfbs;
+    ASSERT_TRUE(rtcpfbs.Insert(CRTCPFeedbackInfo::Parse("transport-cc")));
+    ASSERT_TRUE(rtcpfbs.Insert(tmmbr));
+    ASSERT_TRUE(rtcpfbs.Insert(pli));
+    // Duplicates are dropped
+    ASSERT_FALSE(rtcpfbs.Insert(CRTCPFeedbackInfo::Parse("nack pli")));
+    ASSERT_FALSE(rtcpfbs.Insert(CRTCPFeedbackInfo::Parse("ccm tmmbr smaxpr=120")));
+    ASSERT_EQ(rtcpfbs.size(), 3);
+    ASSERT_TRUE(rtcpfbs.Contains(RTCPFeedbackType::TransportCC));
+    ASSERT_FALSE(rtcpfbs.Contains(CRTCPFeedbackInfo("goog-remb")));
+    // Well known feedbacks first, in type order
+    std::vector<RTCPFeedbackType> order;
+    for (const auto& rtcpfb : rtcpfbs)
+        order.push_back(rtcpfb.GetType());
+    ASSERT_EQ(order, (std::vector<RTCPFeedbackType>{RTCPFeedbackType::NackPli, RTCPFeedbackType::TransportCC,
+                                                    RTCPFeedbackType::Other}));
+    semantic_sdp::CRTCPFeedbackSet merged;
+    merged.Insert(CRTCPFeedbackInfo("goog-remb"));
+    merged.Merge(rtcpfbs);
+    merged.Merge(rtcpfbs);
+    ASSERT_EQ(merged.size(), 4);
+    ASSERT_NE(merged, rtcpfbs);
+}
+
+TEST(Base, track_lookup) {
+    using semantic_sdp::SourceGroupSemantics;
+    semantic_sdp::CStreamInfo stream("stream0");
+    const semantic_sdp::MediaType video(semantic_sdp::MediaType::Type::video);
+    auto track = std::make_unique<semantic_sdp::CTrackInfo>(video, "video0");
+    track->AddSourceGroup(std::make_unique<semantic_sdp::CSourceGroupInfo>("X-CUSTOM", std::vector{4, 5}));
+    track->AddSourceGroup(std::make_unique<semantic_sdp::CSourceGroupInfo>("fid", std::vector{1, 2}));
+    track->AddSourceGroup(std::make_unique<semantic_sdp::CSourceGroupInfo>("FID", std::vector{3, 6}));
+    ASSERT_EQ(track->GetSourceGroups()[1]->GetSemanticsType(), SourceGroupSemantics::FID);
+    ASSERT_EQ(track->GetSourceGroups()[1]->GetSemantics(), "fid");
+    ASSERT_EQ(track->getSourceGroup(SourceGroupSemantics::FID), &track->GetSourceGroups()[1]);
+    ASSERT_EQ(track->getSourceGroup("Fid"), &track->GetSourceGroups()[1]);
+    ASSERT_EQ(track->getSourceGroup("x-custom"), &track->GetSourceGroups()[0]);
+    ASSERT_TRUE(track->HasSourceGroup("FEC-FR") == track->HasSourceGroup(SourceGroupSemantics::FECFR));
+    ASSERT_FALSE(track->HasSourceGroup(SourceGroupSemantics::SIM));
+    ASSERT_TRUE(track->Clone()->HasSourceGroup(SourceGroupSemantics::FID));
+
+    const semantic_sdp::TrackType video_track(semantic_sdp::TrackType::Type::video);
+    ASSERT_EQ(stream.GetFirstTrack(video_track), nullptr);
+    stream.AddTrack(std::move(track));
+    for (const auto* id : {"video1", "video9", "video5", "video3"})
+        stream.AddTrack(std::make_unique<semantic_sdp::CTrackInfo>(video, id));
+    ASSERT_EQ((*stream.GetFirstTrack(video_track))->GetId(), "video0");
+    ASSERT_EQ(stream.GetFirstTrack(semantic_sdp::MediaType(semantic_sdp::MediaType::Type::audio)), nullptr);
+    // The next track in insertion order takes over, also in clones
+    stream.RemoveTrackById("video0");
+    ASSERT_EQ((*stream.GetFirstTrack(video))->GetId(), "video1");
+    stream.RemoveTrackById("video1");
+    ASSERT_EQ((*stream.GetFirstTrack(video))->GetId(), "video9");
+    auto cloned = stream.Clone();
+    cloned->RemoveTrackById("video9");
+    ASSERT_EQ((*cloned->GetFirstTrack(video))->GetId(), "video5");
+    stream.RemoveAllTracks();
+    ASSERT_EQ(stream.GetFirstTrack(video), nullptr);
+}
+
+TEST(Base, map_from_names) {
+    // 15 codecs with rtx and red fill 97..127, the next codec does not fit and static codecs lose their rtx
+    std::vector<std::string> names(15, "vp8");
+    names.emplace_back("red");
+    names.emplace_back("vp8");
+    names.emplace_back("pcmu");
+    const auto codecs = semantic_sdp::MapFromNames(names, true, {});
+    ASSERT_EQ(codecs.size(), 17);
+    for (const auto& codec_it : codecs) {
+        ASSERT_LE(codec_it.first, 127);
+        ASSERT_LE(codec_it.second->GetRTX().value_or(0), 127);
+    }
+    ASSERT_EQ(codecs.find(127)->second->GetCodec(), "red");
+    ASSERT_FALSE(codecs.find(0)->second->HasRTX());
+    ASSERT_EQ(semantic_sdp::MapFromNames(names, false, {}).size(), 18);
+}
+
+TEST(Base, codecs_map) {
+    semantic_sdp::CCodecsMap codecs;
+    ASSERT_TRUE(codecs.emplace(111, std::make_unique<semantic_sdp::CCodecInfo>("opus", 111)));
+    ASSERT_TRUE(codecs.emplace(0, std::make_unique<semantic_sdp::CCodecInfo>("pcmu", 0)));
+    ASSERT_TRUE(codecs.emplace(8, std::make_unique<semantic_sdp::CCodecInfo>("pcma", 8)));
+    ASSERT_FALSE(codecs.emplace(8, std::make_unique<semantic_sdp::CCodecInfo>("g722", 8)));
+    ASSERT_FALSE(codecs.emplace(128, std::make_unique<semantic_sdp::CCodecInfo>("opus", 128)));
+    ASSERT_FALSE(codecs.emplace(-1, std::make_unique<semantic_sdp::CCodecInfo>("opus", -1)));
+    // Replacing keeps the position
+    ASSERT_TRUE(codecs.insert_or_assign(0, std::make_unique<semantic_sdp::CCodecInfo>("PCMU", 0)));
+    ASSERT_EQ(codecs.size(), 3);
+    std::vector<int> order;
+    for (const auto& codec_it : codecs)
+        order.push_back(codec_it.first);
+    ASSERT_EQ(order, (std::vector<int>{111, 0, 8}));
+    ASSERT_EQ(std::string_view(codecs.find(0)->second->GetCodec()), "PCMU");
+    ASSERT_EQ(codecs.find(96), codecs.end());
+    ASSERT_EQ(codecs.find(1000), codecs.end());
+    ASSERT_TRUE(codecs.contains(111));
+    codecs.clear();
+    ASSERT_TRUE(codecs.empty());
+    ASSERT_FALSE(codecs.contains(111));
+}
+
+TEST(Parser, simulcast) {
+    auto sdp = semantic_sdp::sdp::Parse(kSimulcastOffer);
+    ASSERT_NE(sdp, nullptr);
+    const auto& video = sdp->GetMedias().front();
+    ASSERT_EQ(video->GetDirection(), semantic_sdp::Direction::SendOnly);
+    ASSERT_EQ(video->GetRIDs().size(), 3);
+    const auto* rid = video->GetRID("q");
+    ASSERT_NE(rid, nullptr);
+    ASSERT_EQ((*rid)->GetFormats().size(), 1);
+    ASSERT_EQ((*rid)->GetFormats().front(), 96);
+    ASSERT_EQ((*rid)->GetParams().at("max-width"), "320");
+    const auto* send = video->GetSimulcast()->GetSimulcastStreams(semantic_sdp::DirectionWay::Send);
+    ASSERT_EQ(send->size(), 3);
+    ASSERT_TRUE((*send)[2][0]->IsPaused());
+    const auto* track = (*sdp->GetStream("stream1"))->GetTrack("track1");
+    ASSERT_NE(track, nullptr);
+    ASSERT_EQ((*track)->GetEncodings().size(), 3);
+    ASSERT_EQ((*track)->GetEncodings()[0][0]->GetCodecs().size(), 1);
+}
+
+TEST(Parser, malformed) {
+    ASSERT_EQ(semantic_sdp::sdp::Parse(""), nullptr);
+    ASSERT_EQ(semantic_sdp::sdp::Parse("o=- 1 1 IN IP4 127.0.0.1\r\n"), nullptr);
+    ASSERT_EQ(semantic_sdp::sdp::Parse("v=0\r\nm=video nine UDP/TLS/RTP/SAVPF 96\r\n"), nullptr);
+}
+
+TEST(Parser, numbers) {
+    using semantic_sdp::sdp::detail::to_number;
+    uint32_t value = 0;
+    ASSERT_TRUE(to_number("4294967295", &value));
+    ASSERT_EQ(value, 4294967295U);
+    ASSERT_FALSE(to_number("4294967296", &value));
+    ASSERT_TRUE(to_number("0000000000000000042", &value));
+    ASSERT_EQ(value, 42U);
+    ASSERT_FALSE(to_number("", &value));
+    ASSERT_FALSE(to_number("-1", &value));
+    ASSERT_FALSE(to_number("+1", &value));
+    ASSERT_FALSE(to_number("12a", &value));
+    int number = 0;
+    ASSERT_TRUE(to_number("-2147483648", &number));
+    ASSERT_EQ(number, -2147483647 - 1);
+    ASSERT_FALSE(to_number("2147483648", &number));
+    ASSERT_FALSE(to_number("-", &number));
+    uint64_t session_id = 0;
+    ASSERT_TRUE(to_number("18446744073709551615", &session_id));
+    ASSERT_EQ(session_id, 18446744073709551615ULL);
+}
+
+TEST(Parser, unsupported_media) {
+    const auto sdp = semantic_sdp::sdp::Parse(
+        "v=0\r\n"
+        "m=audio 0 UDP/TLS/RTP/SAVPF 0\r\n"
+        "a=mid:0\r\n"
+        "m=text 9 RTP/AVP 98 100\r\n"
+        "a=mid:1\r\n"
+        "a=rtpmap:98 t140/1000\r\n"
+        "m=video 9/2 RTP/AVPF 96\r\n"
+        "a=mid:2\r\n"
+        "a=rtpmap:96 VP8/90000\r\n");
+    ASSERT_NE(sdp, nullptr);
+    const auto& medias = sdp->GetMedias();
+    ASSERT_EQ(medias.size(), 3);
+    ASSERT_TRUE(medias[0]->IsRejected());
+    ASSERT_EQ(medias[1]->GetType().GetType(), semantic_sdp::MediaType::Type::other);
+    ASSERT_EQ(medias[1]->GetTypeName(), "text");
+    ASSERT_EQ(medias[1]->GetPort(), 9);
+    ASSERT_EQ(medias[1]->GetProtocol(), "RTP/AVP");
+    ASSERT_EQ(medias[1]->GetFormats(), "98 100");
+    ASSERT_EQ(medias[2]->GetPort(), 9);
+    ASSERT_EQ(medias[2]->GetProtocol(), "RTP/AVPF");
+    ASSERT_EQ(medias[2]->GetTypeName(), "video");
+
+    // The answer rejects the m-lines it can not take and keeps the others
+    auto supported = std::make_unique<semantic_sdp::sSupportedMedia>();
+    supported->codecs = semantic_sdp::MapFromNames(std::vector<std::string>{"vp8", "pcmu"}, false, {});
+    supported->simulcast = false;
+    supported->rtx = false;
+    const semantic_sdp::CSupportedMediaProfile profile(*supported);
+    semantic_sdp::sSupportedProfiles profiles;
+    profiles.audio = &profile;
+    profiles.video = &profile;
+    const auto answer = sdp->Answer(profiles);
+    const auto& answered = answer->GetMedias();
+    ASSERT_EQ(answered.size(), 3);
+    ASSERT_TRUE(answered[0]->IsRejected());
+    ASSERT_TRUE(answered[1]->IsRejected());
+    ASSERT_EQ(answered[1]->GetTypeName(), "text");
+    ASSERT_EQ(answered[1]->GetFormats(), "98 100");
+    ASSERT_FALSE(answered[2]->IsRejected());
+    ASSERT_EQ(answered[2]->GetProtocol(), "RTP/AVPF");
+    ASSERT_EQ(answered[2]->GetCodecs().size(), 1);
+}
+
+TEST(Serializer, round_trip) {
+    auto sdp = semantic_sdp::sdp::Parse(kChromeOffer);
+    ASSERT_NE(sdp, nullptr);
+    const auto text = semantic_sdp::sdp::ToString(*sdp);
+    ASSERT_EQ(text.size(), semantic_sdp::sdp::EstimateSize(*sdp));
+    ASSERT_NE(text.find("a=rtpmap:111 opus/48000/2\r\n"), std::string::npos);
+    ASSERT_NE(text.find("a=fmtp:103 apt=102\r\n"), std::string::npos);
+    ASSERT_NE(text.find("a=ssrc-group:FID 2231627014 632943048\r\n"), std::string::npos);
+    ASSERT_NE(text.find("a=msid:stream0 video0\r\n"), std::string::npos);
+    ASSERT_NE(text.find("a=ssrc:632943048 cname:4TOk42mSjXCkVIa6\r\n"), std::string::npos);
+    ASSERT_NE(text.find("a=sctp-port:5000\r\n"), std::string::npos);
+    ASSERT_NE(text.find("a=group:BUNDLE 0 1 2\r\n"), std::string::npos);
+
+    auto reparsed = semantic_sdp::sdp::Parse(text);
+    ASSERT_NE(reparsed, nullptr);
+    ASSERT_EQ(reparsed->GetMedias().size(), sdp->GetMedias().size());
+    for (std::size_t i = 0; i < sdp->GetMedias().size(); ++i) {
+        const auto& media = sdp->GetMedias()[i];
+        const auto& other = reparsed->GetMedias()[i];
+        ASSERT_EQ(other->GetId(), media->GetId());
+        ASSERT_EQ(other->GetCodecs().size(), media->GetCodecs().size());
+        ASSERT_EQ(other->GetExtensions().size(), media->GetExtensions().size());
+        ASSERT_EQ(other->GetCandidates().size(), media->GetCandidates().size());
+    }
+    ASSERT_EQ(reparsed->GetDTLS()->GetFingerprint(), sdp->GetDTLS()->GetFingerprint());
+    ASSERT_EQ((*reparsed->GetStream("stream0"))->GetTracks().size(), 2);
+    ASSERT_EQ((*(*reparsed->GetStream("stream0"))->GetTrack("video0"))->GetCName(), "4TOk42mSjXCkVIa6");
+
+    // Rejected and mid-less m-lines are not bundled, tracks without cname get no cname line
+    const semantic_sdp::MediaType video(semantic_sdp::MediaType::Type::video);
+    semantic_sdp::CSDPInfo partial;
+    partial.AddMedia(sdp->GetMedias()[0]->Clone());
+    partial.AddMedia(std::make_unique<semantic_sdp::CMediaInfo>("1", video));
+    auto no_mid = sdp->GetMedias()[0]->Clone();
+    no_mid->SetId("");
+    partial.AddMedia(std::move(no_mid));
+    auto stream = std::make_unique<semantic_sdp::CStreamInfo>("stream1");
+    auto track = std::make_unique<semantic_sdp::CTrackInfo>(video, "video1");
+    track->SetMediaId("0");
+    track->AddSSRC(1234);
+    stream->AddTrack(std::move(track));
+    partial.AddStream(std::move(stream));
+    const auto partial_text = semantic_sdp::sdp::ToString(partial);
+    ASSERT_NE(partial_text.find("a=group:BUNDLE 0\r\n"), std::string::npos);
+    ASSERT_NE(partial_text.find("a=ssrc:1234 msid:stream1 video1\r\n"), std::string::npos);
+    ASSERT_EQ(partial_text.find("cname:"), std::string::npos);
+    semantic_sdp::CSDPInfo rejected;
+    rejected.AddMedia(std::make_unique<semantic_sdp::CMediaInfo>("0", video));
+    ASSERT_EQ(semantic_sdp::sdp::ToString(rejected).find("a=group:BUNDLE"), std::string::npos);
+
+    // Port and protocol are kept, a rejected m-line stays rejected and unbundled
+    const auto lines = semantic_sdp::sdp::Parse(
+        "v=0\r\n"
+        "m=audio 0 UDP/TLS/RTP/SAVPF 0\r\n"
+        "a=mid:0\r\n"
+        "m=text 9 RTP/AVP 98 100\r\n"
+        "a=mid:1\r\n"
+        "m=video 7 RTP/AVPF 96\r\n"
+        "a=mid:2\r\n"
+        "a=rtpmap:96 VP8/90000\r\n");
+    ASSERT_NE(lines, nullptr);
+    const auto lines_text = semantic_sdp::sdp::ToString(*lines);
+    ASSERT_EQ(lines_text.size(), semantic_sdp::sdp::EstimateSize(*lines));
+    ASSERT_NE(lines_text.find("m=audio 0 UDP/TLS/RTP/SAVPF 0\r\n"), std::string::npos);
+    ASSERT_NE(lines_text.find("m=text 9 RTP/AVP 98 100\r\n"), std::string::npos);
+    ASSERT_NE(lines_text.find("m=video 7 RTP/AVPF 96\r\n"), std::string::npos);
+    ASSERT_NE(lines_text.find("a=group:BUNDLE 1 2\r\n"), std::string::npos);
+    const auto lines_reparsed = semantic_sdp::sdp::Parse(lines_text);
+    ASSERT_NE(lines_reparsed, nullptr);
+    ASSERT_TRUE(lines_reparsed->GetMedias()[0]->IsRejected());
+    ASSERT_EQ(lines_reparsed->GetMedias()[1]->GetTypeName(), "text");
+
+    auto simulcast = semantic_sdp::sdp::Parse(kSimulcastOffer);
+    const auto simulcast_text = semantic_sdp::sdp::ToString(*simulcast);
+    ASSERT_NE(simulcast_text.find("a=simulcast:send q;h;~f\r\n"), std::string::npos);
+    ASSERT_NE(simulcast_text.find("a=rid:q send pt=96;max-width=320\r\n"), std::string::npos);
+}
+
+TEST(Serializer, reused_buffer) {
+    auto sdp = semantic_sdp::sdp::Parse(kChromeOffer);
+    ASSERT_NE(sdp, nullptr);
+    std::string out;
+    semantic_sdp::sdp::Serialize(*sdp, &out);
+    const auto first = out;
+    const auto* data = out.data();
+    const auto capacity = out.capacity();
+    out.clear();
+    semantic_sdp::sdp::Serialize(*sdp, &out);
+    ASSERT_EQ(out, first);
+    ASSERT_EQ(out.data(), data);
+    ASSERT_EQ(out.capacity(), capacity);
+}
+
+TEST(Answer, profile) {
+    auto sdp = semantic_sdp::sdp::Parse(kChromeOffer);
+    ASSERT_NE(sdp, nullptr);
+    const auto& video = *sdp->GetMediaById("1");
+
+    auto supported = std::make_unique<semantic_sdp::sSupportedMedia>();
+    supported->codecs =
+        semantic_sdp::MapFromNames(std::vector<std::string>{"vp8", "H264;packetization-mode=1"}, true, {});
+    supported->extensions = {"urn:ietf:params:rtp-hdrext:sdes:mid"};
+    supported->simulcast = false;
+    supported->rtx = true;
+    const semantic_sdp::CSupportedMediaProfile profile(*supported);
+
+    const auto answer = video->Answer(profile);
+    ASSERT_EQ(answer->GetDirection(), semantic_sdp::Direction::SendRecv);
+    ASSERT_EQ(answer->GetCodecs().size(), 2);
+    const auto* h264 = answer->GetCodec("h264");
+    ASSERT_NE(h264, nullptr);
+    ASSERT_EQ((*h264)->GetType(), 102);
+    ASSERT_EQ((*h264)->GetRTX(), 103);
+    ASSERT_EQ((*h264)->GetParam("profile-level-id"), "42e01f");
+    ASSERT_EQ(answer->GetExtensions().size(), 1);
+    ASSERT_EQ(answer->GetExtensions().at(4), "urn:ietf:params:rtp-hdrext:sdes:mid");
+    ASSERT_EQ(video->Answer(supported)->GetCodecs().size(), 2);
+
+    supported->codecs = semantic_sdp::MapFromNames(std::vector<std::string>{"h264;packetization-mode=0"}, false, {});
+    ASSERT_TRUE(video->Answer(supported)->GetCodecs().empty());
+    ASSERT_EQ(video->Answer(nullptr)->GetDirection(), semantic_sdp::Direction::Inactive);
+}
+
+TEST(Answer, profile_variants) {
+    auto supported = std::make_unique<semantic_sdp::sSupportedMedia>();
+    supported->codecs = semantic_sdp::MapFromNames(std::vector<std::string>{
+        "h264;packetization-mode=0;profile-level-id=42e01f", "h264;packetization-mode=1;profile-level-id=42e01f"},
+        false, {});
+    supported->simulcast = false;
+    supported->rtx = false;
+    const semantic_sdp::CSupportedMediaProfile profile(*supported);
+
+    // Each variant keeps its own parameters and answers the offers of its packetization mode
+    for (const auto* mode : {"0", "1"}) {
+        semantic_sdp::CCodecInfo offered("H264", 100);
+        offered.AddParam("packetization-mode", mode);
+        offered.AddParam("profile-level-id", "42e01f");
+        const auto* match = profile.Match(offered);
+        ASSERT_NE(match, nullptr);
+        ASSERT_EQ(match->GetParam("packetization-mode"), mode);
+    }
+}
+
+TEST(Answer, h264_profile) {
+    namespace h264 = semantic_sdp::h264;
+    ASSERT_EQ(h264::Parse("42001f"), (h264::ProfileLevelId{h264::Profile::Baseline, h264::Level::L3_1}));
+    ASSERT_EQ(h264::Parse("4d0028"), (h264::ProfileLevelId{h264::Profile::Main, h264::Level::L4}));
+    ASSERT_EQ(h264::Parse("640034"), (h264::ProfileLevelId{h264::Profile::High, h264::Level::L5_2}));
+    ASSERT_EQ(h264::Parse("640009"), (h264::ProfileLevelId{h264::Profile::High, h264::Level::L1b}));
+    ASSERT_EQ(h264::Parse("f4001f")->profile, h264::Profile::PredictiveHigh444);
+    ASSERT_FALSE(h264::Parse("42e0ff").has_value());
+    ASSERT_FALSE(h264::Parse("6e001f").has_value());
+    for (const auto profile : {h264::Profile::ConstrainedBaseline, h264::Profile::Baseline, h264::Profile::Main,
+                               h264::Profile::ConstrainedHigh, h264::Profile::High,
+                               h264::Profile::PredictiveHigh444}) {
+        for (const auto level : {h264::Level::L1b, h264::Level::L1, h264::Level::L3_1, h264::Level::L5_2}) {
+            std::array<char, 6> buffer;
+            ASSERT_EQ(h264::Parse(h264::ToString({profile, level}, &buffer)), (h264::ProfileLevelId{profile, level}));
+        }
+    }
+    ASSERT_TRUE(h264::IsCompatible(h264::Profile::High, h264::Profile::ConstrainedBaseline));
+    ASSERT_TRUE(h264::IsCompatible(h264::Profile::Baseline, h264::Profile::ConstrainedBaseline));
+    ASSERT_FALSE(h264::IsCompatible(h264::Profile::ConstrainedBaseline, h264::Profile::Baseline));
+    ASSERT_FALSE(h264::IsCompatible(h264::Profile::High, h264::Profile::Baseline));
+    ASSERT_EQ(h264::MinLevel(h264::Level::L1_1, h264::Level::L1b), h264::Level::L1b);
+
+    // A single supported entry answers every compatible offer at the negotiated level
+    auto sdp = semantic_sdp::sdp::Parse(kChromeOffer);
+    ASSERT_NE(sdp, nullptr);
+    const auto& video = *sdp->GetMediaById("1");
+    const auto answer_plid = [&video](const std::string& supported_codec) -> std::string {
+        auto supported = std::make_unique<semantic_sdp::sSupportedMedia>();
+        supported->codecs = semantic_sdp::MapFromNames(std::vector<std::string>{supported_codec}, false, {});
+        const auto answer = video->Answer(supported);
+        const auto* codec = answer->GetCodec("h264");
+        return (codec != nullptr) ? std::string((*codec)->GetParam("profile-level-id")) : "none";
+    };
+    ASSERT_EQ(answer_plid("h264;packetization-mode=1;profile-level-id=640c34;level-asymmetry-allowed=1"), "42e034");
+    ASSERT_EQ(answer_plid("h264;packetization-mode=1;profile-level-id=640c34"), "42e01f");
+    ASSERT_EQ(answer_plid("h264;packetization-mode=1;profile-level-id=42e00a"), "42e00a");
+    ASSERT_EQ(answer_plid("h264;packetization-mode=1;profile-level-id=42001f"), "42e01f");
+    ASSERT_EQ(answer_plid("h264;packetization-mode=1"), "42e01f");
+
+    std::string high_offer(kChromeOffer);
+    high_offer.replace(high_offer.find("profile-level-id=42e01f"), 23, "profile-level-id=640028");
+    auto high = semantic_sdp::sdp::Parse(high_offer);
+    auto supported = std::make_unique<semantic_sdp::sSupportedMedia>();
+    supported->codecs = semantic_sdp::MapFromNames(
+        std::vector<std::string>{"h264;packetization-mode=1;profile-level-id=42001f"}, false, {});
+    ASSERT_TRUE((*high->GetMediaById("1"))->Answer(supported)->GetCodecs().empty());
+    supported->codecs = semantic_sdp::MapFromNames(
+        std::vector<std::string>{"h264;packetization-mode=1;profile-level-id=f40032"}, false, {});
+    const auto high_answer = (*high->GetMediaById("1"))->Answer(supported);
+    ASSERT_EQ((*high_answer->GetCodec("h264"))->GetParam("profile-level-id"), "640028");
+}
+
+TEST(Answer, session) {
+    auto sdp = semantic_sdp::sdp::Parse(kChromeOffer);
+    ASSERT_NE(sdp, nullptr);
+    auto supported = std::make_unique<semantic_sdp::sSupportedMedia>();
+    supported->codecs = semantic_sdp::MapFromNames(std::vector<std::string>{"opus"}, false, {});
+    supported->simulcast = false;
+    supported->rtx = false;
+    const semantic_sdp::CSupportedMediaProfile audio(*supported);
+    semantic_sdp::sSupportedProfiles profiles;
+    profiles.audio = &audio;
+
+    const auto answer = sdp->Answer(profiles);
+    const auto& medias = answer->GetMedias();
+    ASSERT_EQ(medias.size(), 3);
+    ASSERT_EQ(medias[0]->GetId(), "0");
+    ASSERT_EQ(medias[0]->GetCodecs().size(), 1);
+    ASSERT_EQ(medias[1]->GetId(), "1");
+    ASSERT_EQ(medias[1]->GetDirection(), semantic_sdp::Direction::Inactive);
+    ASSERT_EQ(medias[2]->GetType().GetType(), semantic_sdp::MediaType::Type::application);
+
+    // Large sessions are split over threads, the result keeps the offer order
+    semantic_sdp::CSDPInfo conference;
+    for (int i = 0; i < 64; ++i) {
+        auto media = sdp->GetMedias()[i % 2]->Clone();
+        media->SetId(std::to_string(i));
+        conference.AddMedia(std::move(media));
+    }
+    const auto conference_answer = conference.Answer(profiles, 4);
+    ASSERT_EQ(conference_answer->GetMedias().size(), 64);
+    for (int i = 0; i < 64; ++i) {
+        const auto& media = conference_answer->GetMedias()[i];
+        ASSERT_EQ(std::string(media->GetId()), std::to_string(i));
+        ASSERT_EQ(media->GetCodecs().size(), (i % 2 == 0) ? 1 : 0);
+    }
+}
+
+TEST(Base, worker_pool) {
+    auto& pool = semantic_sdp::CWorkerPool::Instance();
+    std::vector<int> items(100, 0);
+    pool.ParallelFor(items.size(), 4, [&items](const std::size_t i) { items[i] = static_cast<int>(i); });
+    for (std::size_t i = 0; i < items.size(); ++i)
+        ASSERT_EQ(items[i], static_cast<int>(i));
+
+    // An item throwing stops the loop, the exception reaches the caller and the pool stays usable
+    const auto fail = [](const std::size_t i) {
+        if (i == 50)
+            throw std::runtime_error("item failed");
+    };
+    ASSERT_THROW(pool.ParallelFor(items.size(), 4, fail), std::runtime_error);
+    std::atomic<std::size_t> done{0};
+    pool.ParallelFor(items.size(), 4, [&done](const std::size_t) { ++done; });
+    ASSERT_EQ(done, items.size());
+}
+
+TEST(Memory, arena) {
+    semantic_sdp::memory::CArena arena;
+    semantic_sdp::SDPInfo sdp;
+    {
+        semantic_sdp::memory::CScope scope(arena.GetResource());
+        sdp = semantic_sdp::sdp::Parse(kChromeOffer);
+    }
+    ASSERT_NE(sdp, nullptr);
+    const auto& media = sdp->GetMedias().front();
+    ASSERT_EQ(media->GetId().get_allocator().GetResource(), arena.GetResource());
+    const auto* opus = media->GetCodec("opus");
+    ASSERT_NE(opus, nullptr);
+    // Codec names are interned outside of the arena and outlive it
+    ASSERT_TRUE((*opus)->GetCodec().IsInterned());
+
+    // Copies made outside of the scope go to the global heap and outlive the arena
+    auto cloned = sdp->Clone();
+    ASSERT_EQ(cloned->GetMedias().front()->GetId().get_allocator().GetResource(),
+              std::pmr::new_delete_resource());
+    const auto size = semantic_sdp::sdp::EstimateSize(*sdp);
+    sdp.reset();
+    {
+        semantic_sdp::memory::CScope scope(arena.GetResource());
+        arena.Drop(semantic_sdp::sdp::Parse(kChromeOffer));
+    }
+    // Move assignment keeps the resource of the target, the elements are moved out of the arena
+    semantic_sdp::memory::Vector<semantic_sdp::memory::String> ids;
+    {
+        semantic_sdp::memory::CScope scope(arena.GetResource());
+        semantic_sdp::memory::Vector<semantic_sdp::memory::String> arena_ids;
+        arena_ids.emplace_back("a media id long enough to be kept out of the small string buffer");
+        ids = std::move(arena_ids);
+    }
+    ASSERT_EQ(ids.get_allocator().GetResource(), std::pmr::new_delete_resource());
+    ASSERT_EQ(ids.front().get_allocator().GetResource(), std::pmr::new_delete_resource());
+    arena.Release();
+    ASSERT_EQ(ids.front(), "a media id long enough to be kept out of the small string buffer");
+    const auto text = semantic_sdp::sdp::ToString(*cloned);
+    ASSERT_EQ(text.size(), size);
+    ASSERT_NE(semantic_sdp::sdp::Parse(text), nullptr);
+}
+
+TEST(Memory, shared) {
+    const auto sdp = semantic_sdp::sdp::Parse(kChromeOffer);
+    ASSERT_NE(sdp, nullptr);
+    const auto& video = *sdp->GetMediaById("1");
+    auto cloned = video->Clone();
+    // Clones share the codecs until one of them changes
+    ASSERT_EQ(&cloned->GetCodecs(), &video->GetCodecs());
+    ASSERT_EQ(&cloned->GetExtensions(), &video->GetExtensions());
+    cloned->AddCodec(std::make_unique<semantic_sdp::CCodecInfo>("av1", 45));
+    cloned->AddExtension(100, "urn:example:extension");
+    ASSERT_NE(&cloned->GetCodecs(), &video->GetCodecs());
+    ASSERT_EQ(cloned->GetCodecs().size(), video->GetCodecs().size() + 1);
+    ASSERT_EQ(video->GetCodecForType(45), nullptr);
+    ASSERT_EQ(cloned->GetExtensions().size(), video->GetExtensions().size() + 1);
+
+    // Clones in another memory resource are deep
+    semantic_sdp::memory::CArena arena;
+    semantic_sdp::MediaInfo in_arena;
+    {
+        semantic_sdp::memory::CScope scope(arena.GetResource());
+        in_arena = video->Clone();
+    }
+    ASSERT_NE(&in_arena->GetCodecs(), &video->GetCodecs());
+    ASSERT_EQ(in_arena->GetCodecs().size(), video->GetCodecs().size());
+    arena.Drop(std::move(in_arena));
+}
+
 int main(int argc, char *argv[]) {
     ::testing::InitGoogleTest(&argc, argv);
     return RUN_ALL_TESTS();